@@ -1,12 +1,146 @@
 #include "SRMDevice.h"
 #include <CZ/Louvre/Private/LOutputPrivate.h>
+#include <CZ/Louvre/Private/LLockGuard.h>
 #include <CZ/Louvre/Private/LFactory.h>
+#include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
 #include <CZ/Louvre/Backends/DRM/LDRMOutputMode.h>
 #include <CZ/Louvre/Backends/DRM/LDRMOutput.h>
 #include <CZ/SRM/SRMConnector.h>
+#include <CZ/SRM/SRMEncoder.h>
+#include <CZ/SRM/SRMPlane.h>
+#include <CZ/SRM/SRMCrtc.h>
+#include <CZ/Ream/RDevice.h>
+#include <CZ/Ream/RImage.h>
+#include <CZ/Louvre/LLog.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#include <drm_fourcc.h>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <poll.h>
+#include <unistd.h>
 
 using namespace CZ;
 
+// Returns the property id or 0 if not found
+static UInt32 FindProp(int fd, UInt32 objId, UInt32 objType, const char *name, UInt64 *value = nullptr) noexcept
+{
+    auto *props { drmModeObjectGetProperties(fd, objId, objType) };
+
+    if (!props)
+        return 0;
+
+    UInt32 id { 0 };
+
+    for (UInt32 i = 0; i < props->count_props && !id; i++)
+    {
+        auto *prop { drmModeGetProperty(fd, props->props[i]) };
+
+        if (!prop)
+            continue;
+
+        if (strcmp(prop->name, name) == 0)
+        {
+            id = prop->prop_id;
+
+            if (value)
+                *value = props->prop_values[i];
+        }
+
+        drmModeFreeProperty(prop);
+    }
+
+    drmModeFreeObjectProperties(props);
+    return id;
+}
+
+static SRMCrtc *CurrentCrtc(SRMConnector *conn) noexcept
+{
+    for (auto *encoder : conn->encoders())
+        for (auto *crtc : encoder->crtcs())
+            if (crtc->currentConnector() == conn)
+                return crtc;
+
+    return nullptr;
+}
+
+// Returns the property id or 0 if not found or immutable, min and max are only set for range properties
+static UInt32 FindMutableProp(int fd, UInt32 objId, UInt32 objType, const char *name, UInt64 &min, UInt64 &max) noexcept
+{
+    const UInt32 id { FindProp(fd, objId, objType, name) };
+
+    if (!id)
+        return 0;
+
+    auto *prop { drmModeGetProperty(fd, id) };
+
+    if (!prop)
+        return 0;
+
+    const bool immutable { (prop->flags & DRM_MODE_PROP_IMMUTABLE) != 0 };
+
+    if ((prop->flags & DRM_MODE_PROP_RANGE) && prop->count_values >= 2)
+    {
+        min = prop->values[0];
+        max = prop->values[1];
+    }
+
+    drmModeFreeProperty(prop);
+    return immutable ? 0 : id;
+}
+
+// Overlay planes may be compatible with several CRTCs, each one is claimed by a single output
+static std::mutex ClaimedPlanesMutex;
+static std::unordered_set<SRMPlane*> ClaimedPlanes;
+
+// Closes each unique handle once
+static void CloseGemHandles(int fd, const UInt32 *handles, int count) noexcept
+{
+    for (int i = 0; i < count; i++)
+    {
+        bool repeated { handles[i] == 0 };
+
+        for (int j = 0; j < i && !repeated; j++)
+            repeated = handles[j] == handles[i];
+
+        if (repeated)
+            continue;
+
+        drm_gem_close args {};
+        args.handle = handles[i];
+        drmIoctl(fd, DRM_IOCTL_GEM_CLOSE, &args);
+    }
+}
+
+// Display Range Limits descriptor of the EDID base block
+static bool ParseEDIDRange(const UInt8 *edid, size_t size, LBackendOutput::VRRRange &range) noexcept
+{
+    if (size < 128)
+        return false;
+
+    for (size_t offset = 54; offset <= 108; offset += 18)
+    {
+        const UInt8 *desc { edid + offset };
+
+        if (desc[0] != 0 || desc[1] != 0 || desc[3] != 0xFD)
+            continue;
+
+        // EDID 1.4 rate offsets
+        const UInt32 minHz { desc[5] + ((desc[4] & 0x01) ? 255u : 0u) };
+        const UInt32 maxHz { desc[6] + ((desc[4] & 0x02) ? 255u : 0u) };
+
+        if (minHz == 0 || maxHz <= minHz)
+            return false;
+
+        range = { minHz * 1000, maxHz * 1000 };
+        return true;
+    }
+
+    return false;
+}
+
 static const SRMConnectorInterface ConnIface
 {
     .initialized = [](SRMConnector *, void *data)
@@ -43,12 +177,19 @@ static const SRMConnectorInterface ConnIface
 
 void LDRMOutput::handleInitializeGL() noexcept
 {
+    m_cursor.current = -1;
+    updateVRRCaps();
+    claimOverlayPlanes();
     m_output->imp()->backendInitializeGL();
 }
 
 void LDRMOutput::handlePaintGL() noexcept
 {
+    applyVRR();
     m_output->imp()->backendPaintGL();
+
+    // SRM flips right after, which would fail while the overlay commit is pending
+    waitOverlayPlanes();
 }
 
 void LDRMOutput::handleResizeGL() noexcept
@@ -69,6 +210,409 @@ void LDRMOutput::handleDiscarded(UInt64 paintEventId) noexcept
 void LDRMOutput::handleUninitializeGL() noexcept
 {
     m_output->imp()->backendUninitializeGL();
+
+    {
+        std::lock_guard<std::mutex> lock { m_vrr.mutex };
+
+        if (m_vrr.enabled)
+            commitVRR(m_vrr.fd, m_vrr.crtcId, m_vrr.propId, false);
+
+        m_vrr.fd = -1;
+        m_vrr.crtcId = m_vrr.propId = 0;
+        m_vrr.range = {};
+        m_vrr.enabled = false;
+    }
+
+    m_cursor.current = -1;
+    releaseOverlayPlanes();
+}
+
+void LDRMOutput::updateVRRCaps() noexcept
+{
+    std::lock_guard<std::mutex> lock { m_vrr.mutex };
+    m_vrr.fd = -1;
+    m_vrr.crtcId = m_vrr.propId = 0;
+    m_vrr.range = {};
+    m_vrr.enabled = false; // Disabled on uninitializeGL, m_vrr.requested is applied on the first frame
+
+    auto *dev { m_conn->device()->reamDevice() };
+
+    if (!dev)
+        return;
+
+    const int fd { dev->drmFd() };
+    UInt64 capable { 0 };
+
+    if (!FindProp(fd, m_conn->id(), DRM_MODE_OBJECT_CONNECTOR, "vrr_capable", &capable) || !capable)
+        return;
+
+    SRMCrtc *crtc { CurrentCrtc(m_conn) };
+
+    if (!crtc)
+        return;
+
+    const UInt32 propId { FindProp(fd, crtc->id(), DRM_MODE_OBJECT_CRTC, "VRR_ENABLED") };
+
+    if (!propId)
+        return;
+
+    UInt64 edidBlobId { 0 };
+
+    if (FindProp(fd, m_conn->id(), DRM_MODE_OBJECT_CONNECTOR, "EDID", &edidBlobId) && edidBlobId)
+    {
+        if (auto *blob = drmModeGetPropertyBlob(fd, edidBlobId))
+        {
+            ParseEDIDRange(static_cast<const UInt8*>(blob->data), blob->length, m_vrr.range);
+            drmModeFreePropertyBlob(blob);
+        }
+    }
+
+    // Unknown range, assume it goes up to the current mode
+    if (m_vrr.range.max == 0 && m_conn->currentMode())
+        m_vrr.range = { 0, m_conn->currentMode()->refreshRate() * 1000 };
+
+    m_vrr.fd = fd;
+    m_vrr.crtcId = crtc->id();
+    m_vrr.propId = propId;
+}
+
+void LDRMOutput::applyVRR() noexcept
+{
+    int fd;
+    UInt32 crtcId, propId;
+    bool requested;
+
+    {
+        std::lock_guard<std::mutex> lock { m_vrr.mutex };
+
+        if (m_vrr.propId == 0 || m_vrr.enabled == m_vrr.requested)
+            return;
+
+        fd = m_vrr.fd;
+        crtcId = m_vrr.crtcId;
+        propId = m_vrr.propId;
+        requested = m_vrr.requested;
+    }
+
+    // May block until the previous page flip completes, the lock isn't held meanwhile
+    const bool ok { commitVRR(fd, crtcId, propId, requested) };
+
+    std::lock_guard<std::mutex> lock { m_vrr.mutex };
+
+    if (ok)
+        m_vrr.enabled = requested;
+    else if (m_vrr.requested == requested)
+        m_vrr.requested = m_vrr.enabled;
+}
+
+bool LDRMOutput::commitVRR(int fd, UInt32 crtcId, UInt32 propId, bool enabled) noexcept
+{
+    /* A blocking atomic commit runs after SRM's pending page flip instead of racing it. Only the
+     * included properties change, so the value persists across SRM's own commits */
+    auto *req { drmModeAtomicAlloc() };
+    int ret { -1 };
+
+    if (req && drmModeAtomicAddProperty(req, crtcId, propId, enabled) > 0)
+        ret = drmModeAtomicCommit(fd, req, 0, nullptr);
+
+    drmModeAtomicFree(req);
+
+    // Legacy SRM mode, atomic requests are rejected
+    if (ret != 0)
+        ret = drmModeObjectSetProperty(fd, crtcId, DRM_MODE_OBJECT_CRTC, propId, enabled);
+
+    if (ret != 0)
+    {
+        LLog(CZError, CZLN, "[DRM Backend] Failed to {} VRR on {}: {}", enabled ? "enable" : "disable", name(), strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+void LDRMOutput::claimOverlayPlanes() noexcept
+{
+    releaseOverlayPlanes();
+
+    auto *dev { m_conn->device()->reamDevice() };
+    SRMCrtc *crtc { CurrentCrtc(m_conn) };
+
+    if (!dev || !crtc)
+        return;
+
+    const int fd { dev->drmFd() };
+
+    // Test commits require the atomic API, an empty request is only accepted if SRM enabled it
+    auto *req { drmModeAtomicAlloc() };
+    const bool atomic { req && drmModeAtomicCommit(fd, req, DRM_MODE_ATOMIC_TEST_ONLY, nullptr) == 0 };
+    drmModeAtomicFree(req);
+
+    if (!atomic)
+        return;
+
+    const UInt32 outFencePtr { FindProp(fd, crtc->id(), DRM_MODE_OBJECT_CRTC, "OUT_FENCE_PTR") };
+
+    if (!outFencePtr)
+        return;
+
+    // Overlays are stacked above the primary plane if their zpos can be changed
+    UInt64 primaryZpos { 0 };
+
+    for (auto *plane : m_conn->device()->planes())
+        if (plane->type() == SRMPlane::Primary && plane->currentConnector() == m_conn)
+            FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "zpos", &primaryZpos);
+
+    std::lock_guard<std::mutex> lock { ClaimedPlanesMutex };
+
+    for (auto *plane : m_conn->device()->planes())
+    {
+        if (plane->type() != SRMPlane::Overlay || plane->leased() || plane->currentConnector() || ClaimedPlanes.contains(plane))
+            continue;
+
+        bool compatible { false };
+
+        for (auto *planeCrtc : plane->crtcs())
+            compatible |= planeCrtc->id() == crtc->id();
+
+        if (!compatible)
+            continue;
+
+        OverlayPlane state {};
+        state.plane = plane;
+        state.fbId = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "FB_ID");
+        state.crtcId = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "CRTC_ID");
+        state.srcX = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "SRC_X");
+        state.srcY = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "SRC_Y");
+        state.srcW = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "SRC_W");
+        state.srcH = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "SRC_H");
+        state.crtcX = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "CRTC_X");
+        state.crtcY = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "CRTC_Y");
+        state.crtcW = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "CRTC_W");
+        state.crtcH = FindProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "CRTC_H");
+
+        if (!state.fbId || !state.crtcId || !state.srcX || !state.srcY || !state.srcW || !state.srcH ||
+            !state.crtcX || !state.crtcY || !state.crtcW || !state.crtcH)
+            continue;
+
+        UInt64 zposMin { 0 }, zposMax { 0 };
+        state.zpos = FindMutableProp(fd, plane->id(), DRM_MODE_OBJECT_PLANE, "zpos", zposMin, zposMax);
+        state.zposValue = std::clamp<UInt64>(primaryZpos + 1 + m_overlays.state.size(), zposMin, zposMax);
+
+        // Can't be placed above the primary plane, keep the driver default
+        if (state.zposValue <= primaryZpos)
+            state.zpos = 0;
+
+        ClaimedPlanes.emplace(plane);
+        m_overlays.planes.emplace_back(LPlane { plane->id(), plane->formats() });
+        m_overlays.state.emplace_back(std::move(state));
+    }
+
+    if (m_overlays.state.empty())
+        return;
+
+    m_overlays.fd = fd;
+    m_overlays.crtcId = crtc->id();
+    m_overlays.outFencePtr = outFencePtr;
+    LLog(CZDebug, CZLN, "[DRM Backend] {} overlay planes claimed by {}", m_overlays.state.size(), name());
+}
+
+void LDRMOutput::releaseOverlayPlanes() noexcept
+{
+    if (m_overlays.fd < 0)
+        return;
+
+    waitOverlayPlanes();
+
+    // Must be disabled before SRM disables the CRTC
+    auto *req { drmModeAtomicAlloc() };
+
+    for (const auto &state : m_overlays.state)
+    {
+        if (!state.active)
+            continue;
+
+        drmModeAtomicAddProperty(req, state.plane->id(), state.fbId, 0);
+        drmModeAtomicAddProperty(req, state.plane->id(), state.crtcId, 0);
+    }
+
+    if (drmModeAtomicGetCursor(req) > 0 && drmModeAtomicCommit(m_overlays.fd, req, 0, nullptr) != 0)
+        LLog(CZError, CZLN, "[DRM Backend] Failed to disable the overlay planes of {}: {}", name(), strerror(errno));
+
+    drmModeAtomicFree(req);
+
+    for (const auto &fb : m_overlays.fbs)
+        if (fb.id)
+            drmModeRmFB(m_overlays.fd, fb.id);
+
+    {
+        const auto lock { LLockGuard() };
+
+        for (auto &state : m_overlays.state)
+        {
+            if (state.current)
+                state.current->unhold();
+
+            if (state.retired)
+                state.retired->unhold();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock { ClaimedPlanesMutex };
+
+        for (const auto &state : m_overlays.state)
+            ClaimedPlanes.erase(state.plane);
+    }
+
+    m_overlays = {};
+}
+
+UInt32 LDRMOutput::overlayFb(LDMABuffer *buffer) noexcept
+{
+    for (const auto &fb : m_overlays.fbs)
+        if (fb.buffer.get() == buffer)
+            return fb.id;
+
+    // Failed imports are kept too so that they are not retried every frame
+    auto &fb { m_overlays.fbs.emplace_back() };
+    fb.buffer.reset(buffer);
+
+    const auto &info { buffer->dmaInfo() };
+    UInt32 handles[4] {}, pitches[4] {}, offsets[4] {};
+    UInt64 modifiers[4] {};
+
+    for (int i = 0; i < info.planeCount; i++)
+    {
+        if (drmPrimeFDToHandle(m_overlays.fd, info.fd[i], &handles[i]) != 0)
+        {
+            CloseGemHandles(m_overlays.fd, handles, i);
+            return 0;
+        }
+
+        pitches[i] = info.stride[i];
+        offsets[i] = info.offset[i];
+        modifiers[i] = info.modifier;
+    }
+
+    const bool hasModifier { info.modifier != DRM_FORMAT_MOD_INVALID };
+
+    if (drmModeAddFB2WithModifiers(m_overlays.fd, info.width, info.height, info.format, handles, pitches, offsets,
+                                   hasModifier ? modifiers : nullptr, &fb.id, hasModifier ? DRM_MODE_FB_MODIFIERS : 0) != 0)
+    {
+        LLog(CZDebug, CZLN, "[DRM Backend] Failed to create an overlay framebuffer for a client buffer: {}", strerror(errno));
+        fb.id = 0;
+    }
+
+    // The framebuffer holds its own reference to the buffer objects
+    CloseGemHandles(m_overlays.fd, handles, info.planeCount);
+    return fb.id;
+}
+
+bool LDRMOutput::commitOverlayPlanes(const std::vector<LPlaneAssignment> &assignments, bool testOnly) noexcept
+{
+    auto *req { drmModeAtomicAlloc() };
+
+    if (!req)
+        return false;
+
+    bool ok { true };
+
+    for (size_t i = 0; i < m_overlays.state.size() && ok; i++)
+    {
+        const auto &state { m_overlays.state[i] };
+        const UInt32 id { state.plane->id() };
+        const LPlaneAssignment *assignment { nullptr };
+
+        for (const auto &a : assignments)
+            if (a.plane == &m_overlays.planes[i])
+                assignment = &a;
+
+        if (!assignment)
+        {
+            // Unassigned planes keep displaying their buffer for one more frame, see setPlanes()
+            if (state.active && state.pendingDisable)
+            {
+                drmModeAtomicAddProperty(req, id, state.fbId, 0);
+                drmModeAtomicAddProperty(req, id, state.crtcId, 0);
+            }
+
+            continue;
+        }
+
+        const UInt32 fbId { overlayFb(assignment->buffer.get()) };
+
+        if (!fbId)
+        {
+            ok = false;
+            break;
+        }
+
+        const auto &info { assignment->buffer->dmaInfo() };
+        drmModeAtomicAddProperty(req, id, state.fbId, fbId);
+        drmModeAtomicAddProperty(req, id, state.crtcId, m_overlays.crtcId);
+        drmModeAtomicAddProperty(req, id, state.srcX, 0);
+        drmModeAtomicAddProperty(req, id, state.srcY, 0);
+        drmModeAtomicAddProperty(req, id, state.srcW, UInt64(info.width) << 16);
+        drmModeAtomicAddProperty(req, id, state.srcH, UInt64(info.height) << 16);
+        drmModeAtomicAddProperty(req, id, state.crtcX, assignment->dst.x());
+        drmModeAtomicAddProperty(req, id, state.crtcY, assignment->dst.y());
+        drmModeAtomicAddProperty(req, id, state.crtcW, assignment->dst.width());
+        drmModeAtomicAddProperty(req, id, state.crtcH, assignment->dst.height());
+
+        if (state.zpos)
+            drmModeAtomicAddProperty(req, id, state.zpos, state.zposValue);
+    }
+
+    // Nothing to change
+    if (!ok || drmModeAtomicGetCursor(req) == 0)
+    {
+        drmModeAtomicFree(req);
+        return ok;
+    }
+
+    if (testOnly)
+        ok = drmModeAtomicCommit(m_overlays.fd, req, DRM_MODE_ATOMIC_TEST_ONLY, nullptr) == 0;
+    else
+    {
+        /* Fails with EBUSY if SRM's page flip is still pending (e.g. VSync disabled), in which case
+         * the caller falls back to composition */
+        drmModeAtomicAddProperty(req, m_overlays.crtcId, m_overlays.outFencePtr, static_cast<UInt64>(reinterpret_cast<uintptr_t>(&m_overlays.outFence)));
+        ok = drmModeAtomicCommit(m_overlays.fd, req, DRM_MODE_ATOMIC_NONBLOCK, nullptr) == 0;
+
+        if (!ok)
+            m_overlays.outFence = -1;
+    }
+
+    drmModeAtomicFree(req);
+    return ok;
+}
+
+void LDRMOutput::waitOverlayPlanes() noexcept
+{
+    if (m_overlays.outFence < 0)
+        return;
+
+    pollfd pfd { m_overlays.outFence, POLLIN, 0 };
+
+    // Signaled once the commit is displayed, the timeout only guards against a hung driver
+    while (poll(&pfd, 1, 1000) < 0 && (errno == EINTR || errno == EAGAIN)) {}
+
+    close(m_overlays.outFence);
+    m_overlays.outFence = -1;
+
+    // Replaced by the last commit, no longer scanned out
+    const auto lock { LLockGuard() };
+
+    for (auto &state : m_overlays.state)
+    {
+        if (state.retired)
+        {
+            state.retired->unhold();
+            state.retired.reset();
+        }
+
+        state.retiredFb = 0;
+    }
 }
 
 LOutput *LDRMOutput::Make(SRMConnector *conn) noexcept
@@ -220,6 +764,138 @@ UInt64 LDRMOutput::paintEventId() const noexcept
     return m_conn->paintEventId();
 }
 
+bool LDRMOutput::hasVRR() const noexcept
+{
+    std::lock_guard<std::mutex> lock { m_vrr.mutex };
+    return m_vrr.propId != 0;
+}
+
+bool LDRMOutput::isVRREnabled() const noexcept
+{
+    std::lock_guard<std::mutex> lock { m_vrr.mutex };
+    return m_vrr.propId != 0 && m_vrr.requested;
+}
+
+bool LDRMOutput::setVRREnabled(bool enabled) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock { m_vrr.mutex };
+
+        if (m_vrr.propId == 0)
+            return false;
+
+        if (m_vrr.requested == enabled)
+            return true;
+
+        m_vrr.requested = enabled;
+    }
+
+    // Applied from the render thread before the next frame
+    repaint();
+    return true;
+}
+
+LBackendOutput::VRRRange LDRMOutput::vrrRange() const noexcept
+{
+    std::lock_guard<std::mutex> lock { m_vrr.mutex };
+    return m_vrr.range;
+}
+
+const std::vector<LPlane> &LDRMOutput::planes() const noexcept
+{
+    return m_overlays.planes;
+}
+
+bool LDRMOutput::testPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept
+{
+    if (m_overlays.fd < 0)
+        return assignments.empty();
+
+    return commitOverlayPlanes(assignments, true);
+}
+
+bool LDRMOutput::setPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept
+{
+    if (m_overlays.fd < 0)
+        return assignments.empty();
+
+    // Only if called again within the same frame, e.g. to fall back to composition
+    waitOverlayPlanes();
+
+    /* Committed right before SRM renders and flips the primary plane, which is displayed a frame later.
+     * Planes are therefore disabled a frame after being unassigned, once the composited image contains
+     * their surfaces, to avoid displaying holes. Replaced buffers are released by waitOverlayPlanes() */
+    if (!commitOverlayPlanes(assignments, false))
+        return false;
+
+    for (size_t i = 0; i < m_overlays.state.size(); i++)
+    {
+        auto &state { m_overlays.state[i] };
+        const LPlaneAssignment *assignment { nullptr };
+
+        for (const auto &a : assignments)
+            if (a.plane == &m_overlays.planes[i])
+                assignment = &a;
+
+        if (assignment)
+        {
+            if (state.current.get() != assignment->buffer.get())
+            {
+                assignment->buffer->hold();
+                state.retired = state.current;
+                state.retiredFb = state.currentFb;
+                state.current = assignment->buffer;
+                state.currentFb = overlayFb(assignment->buffer.get());
+            }
+
+            state.active = true;
+            state.pendingDisable = false;
+        }
+        else if (state.active)
+        {
+            if (state.pendingDisable)
+            {
+                state.active = false;
+                state.pendingDisable = false;
+                state.retired = state.current;
+                state.retiredFb = state.currentFb;
+                state.current.reset();
+                state.currentFb = 0;
+            }
+            else
+                state.pendingDisable = true;
+        }
+    }
+
+    // Framebuffers of destroyed buffers that are no longer scanned out
+    for (auto it = m_overlays.fbs.begin(); it != m_overlays.fbs.end();)
+    {
+        if (it->buffer)
+        {
+            it++;
+            continue;
+        }
+
+        bool inUse { false };
+
+        for (const auto &state : m_overlays.state)
+            inUse |= it->id && (it->id == state.currentFb || it->id == state.retiredFb);
+
+        if (inUse)
+        {
+            it++;
+            continue;
+        }
+
+        if (it->id)
+            drmModeRmFB(m_overlays.fd, it->id);
+
+        it = m_overlays.fbs.erase(it);
+    }
+
+    return true;
+}
+
 const std::vector<std::shared_ptr<LOutputMode>> &LDRMOutput::modes() const noexcept
 {
     return m_modes;
@@ -243,14 +919,97 @@ int LDRMOutput::setMode(std::shared_ptr<LOutputMode> mode) noexcept
     return 0;
 }
 
+bool LDRMOutput::testMode(std::shared_ptr<LOutputMode> mode) const noexcept
+{
+    auto *srmMode { dynamic_cast<LDRMOutputMode*>(mode.get()) };
+
+    if (!srmMode || mode->output() != output())
+        return false;
+
+    // Leased connectors are controlled by the lessee
+    return !output() || !output()->lease();
+}
+
 bool LDRMOutput::hasCursor() const noexcept
 {
     return m_conn->hasCursor();
 }
 
-bool LDRMOutput::setCursor(UInt8 *pixels) noexcept
+const std::vector<std::shared_ptr<RImage>> &LDRMOutput::cursorImages() const noexcept
+{
+    return m_cursor.images;
+}
+
+Int32 LDRMOutput::acquireCursorImage() noexcept
+{
+    if (!hasCursor())
+        return -1;
+
+    // Enough to hold the frames of most animated cursors
+    if (m_cursor.images.empty())
+    {
+        m_cursor.images = MakeCursorImages(8);
+        m_cursor.pixels.resize(m_cursor.images.size());
+    }
+
+    if (m_cursor.images.size() < 2)
+        return -1;
+
+    const Int32 count { Int32(m_cursor.images.size()) };
+    m_cursor.last = (m_cursor.last + 1) % count;
+
+    if (m_cursor.last == m_cursor.current)
+        m_cursor.last = (m_cursor.last + 1) % count;
+
+    // Rendered again by LCursor
+    m_cursor.pixels[m_cursor.last].clear();
+    return m_cursor.last;
+}
+
+bool LDRMOutput::commitCursorImage(Int32 index) noexcept
 {
-    return m_conn->setCursor(pixels);
+    if (index < 0)
+    {
+        m_cursor.current = -1;
+        return m_conn->setCursor(nullptr);
+    }
+
+    if (index >= Int32(m_cursor.images.size()))
+        return false;
+
+    if (index == m_cursor.current)
+        return true;
+
+    auto &pixels { m_cursor.pixels[index] };
+
+    if (pixels.empty())
+    {
+        pixels.resize(64 * 64 * 4);
+
+        RPixelBufferRegion trans {};
+        trans.pixels = pixels.data();
+        trans.region.setRect(SkIRect::MakeWH(64, 64));
+        trans.stride = 64 * 4;
+        trans.format = DRM_FORMAT_ARGB8888;
+
+        if (!m_cursor.images[index]->readPixels(trans))
+        {
+            trans.format = DRM_FORMAT_ABGR8888;
+
+            if (!m_cursor.images[index]->readPixels(trans))
+            {
+                pixels.clear();
+                return false;
+            }
+
+            // Convert to ARGB8888
+            for (size_t i = 0; i < pixels.size(); i += 4)
+                std::swap(pixels[i], pixels[i + 2]);
+        }
+    }
+
+    m_cursor.current = index;
+    return m_conn->setCursor(pixels.data());
 }
 
 bool LDRMOutput::setCursorPos(SkIPoint pos) noexcept
@@ -3,6 +3,9 @@
 
 #include "SRM.h"
 #include <CZ/Louvre/Backends/LBackendOutput.h>
+#include <CZ/Louvre/Seat/LPlaneAssignment.h>
+#include <list>
+#include <mutex>
 
 namespace CZ
 {
@@ -50,17 +53,33 @@ public:
     bool enableVSync(bool enabled) noexcept override;
     UInt64 paintEventId() const noexcept override;
 
+    /* VRR */
+
+    bool hasVRR() const noexcept override;
+    bool isVRREnabled() const noexcept override;
+    bool setVRREnabled(bool enabled) noexcept override;
+    VRRRange vrrRange() const noexcept override;
+
+    /* Overlay planes */
+
+    const std::vector<LPlane> &planes() const noexcept override;
+    bool testPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept override;
+    bool setPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept override;
+
     /* Modes */
 
     const std::vector<std::shared_ptr<LOutputMode>> &modes() const noexcept override;
     const std::shared_ptr<LOutputMode> preferredMode() const noexcept override;
     const std::shared_ptr<LOutputMode> currentMode() const noexcept override;
     int setMode(std::shared_ptr<LOutputMode> mode) noexcept override;
+    bool testMode(std::shared_ptr<LOutputMode> mode) const noexcept override;
 
     /* Cursor */
 
     bool hasCursor() const noexcept override;
-    bool setCursor(UInt8 *pixels) noexcept override;
+    const std::vector<std::shared_ptr<RImage>> &cursorImages() const noexcept override;
+    Int32 acquireCursorImage() noexcept override;
+    bool commitCursorImage(Int32 index) noexcept override;
     bool setCursorPos(SkIPoint pos) noexcept override;
 
     SRMConnector *conn() const noexcept { return m_conn; }
@@ -74,7 +93,69 @@ public:
 
 private:
     LDRMOutput(SRMConnector *conn) noexcept;
+    void updateVRRCaps() noexcept;
+    void applyVRR() noexcept; // Render thread
+    bool commitVRR(int fd, UInt32 crtcId, UInt32 propId, bool enabled) noexcept;
+    void claimOverlayPlanes() noexcept;
+    void releaseOverlayPlanes() noexcept;
+    UInt32 overlayFb(LDMABuffer *buffer) noexcept; // 0 on failure
+    bool commitOverlayPlanes(const std::vector<LPlaneAssignment> &assignments, bool testOnly) noexcept;
+    void waitOverlayPlanes() noexcept; // Waits for the last commit and releases the retired buffers
     SRMConnector *m_conn;
+
+    /* SRM doesn't handle adaptive sync, the CRTC VRR_ENABLED property is set directly.
+     * The caps are written on the render thread and requests made from the main thread,
+     * which are applied on the render thread before the next frame (see applyVRR()) */
+    struct
+    {
+        mutable std::mutex mutex;
+        int fd { -1 };
+        UInt32 crtcId { 0 };
+        UInt32 propId { 0 }; // VRR_ENABLED, 0 if unsupported
+        VRRRange range {};
+        bool enabled { false }; // Current CRTC value
+        bool requested { false };
+    } m_vrr;
+
+    /* SRM only drives the primary and cursor planes, overlays are committed directly with atomic requests.
+     * SRM can't include them in its own page flip, so each commit is waited for (out fence) before SRM flips */
+    struct OverlayPlane
+    {
+        SRMPlane *plane;
+        UInt32 fbId, crtcId, srcX, srcY, srcW, srcH, crtcX, crtcY, crtcW, crtcH; // Property ids
+        UInt32 zpos { 0 }; // Property id, 0 if immutable or unsupported
+        UInt64 zposValue { 0 };
+        CZWeak<LDMABuffer> current, retired; // Held while scanned out
+        UInt32 currentFb { 0 }, retiredFb { 0 };
+        bool active { false };
+        bool pendingDisable { false };
+    };
+
+    struct OverlayFb
+    {
+        CZWeak<LDMABuffer> buffer;
+        UInt32 id { 0 }; // 0 if the import failed
+    };
+
+    struct
+    {
+        int fd { -1 };
+        UInt32 crtcId { 0 };
+        UInt32 outFencePtr { 0 }; // CRTC property id
+        Int32 outFence { -1 }; // Signaled once the last commit is displayed
+        std::vector<LPlane> planes;
+        std::vector<OverlayPlane> state; // Same order as planes
+        std::list<OverlayFb> fbs;
+    } m_overlays;
+
+    // SRM only accepts CPU pixels, each image is read back once after being rendered
+    struct
+    {
+        std::vector<std::shared_ptr<RImage>> images;
+        std::vector<std::vector<UInt8>> pixels; // Empty until read back
+        Int32 current { -1 };
+        Int32 last { -1 };
+    } m_cursor;
     std::vector<std::shared_ptr<LOutputMode>> m_modes;
     std::string m_desc;
 };
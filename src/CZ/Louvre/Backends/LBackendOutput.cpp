@@ -0,0 +1,40 @@
+#include <CZ/Louvre/Backends/LBackendOutput.h>
+#include <CZ/Louvre/LLog.h>
+#include <CZ/Ream/RCore.h>
+#include <CZ/Ream/RDevice.h>
+#include <CZ/Ream/RImage.h>
+#include <drm_fourcc.h>
+
+using namespace CZ;
+
+std::vector<std::shared_ptr<RImage>> LBackendOutput::MakeCursorImages(size_t count) noexcept
+{
+    auto ream { RCore::Get() };
+    auto format { ream->mainDevice()->textureFormats().formats().find(DRM_FORMAT_ARGB8888) };
+
+    if (format == ream->mainDevice()->textureFormats().formats().end())
+        return {};
+
+    RImageConstraints cons {};
+    cons.allocator = ream->mainDevice();
+    cons.caps[cons.allocator] = RImageCap::RImageCap_Dst;
+    cons.readFormats = {DRM_FORMAT_ARGB8888, DRM_FORMAT_ABGR8888};
+
+    std::vector<std::shared_ptr<RImage>> images;
+    images.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto image { RImage::Make({64, 64}, *format, &cons) };
+
+        if (!image)
+        {
+            LLog(CZError, CZLN, "Failed to create cursor image");
+            return {};
+        }
+
+        images.emplace_back(std::move(image));
+    }
+
+    return images;
+}
@@ -51,6 +51,26 @@ public:
     virtual bool enableVSync(bool enabled) noexcept = 0;
     virtual UInt64 paintEventId() const noexcept = 0;
 
+    /* VRR */
+
+    struct VRRRange
+    {
+        UInt32 min, max; // mHz
+    };
+
+    virtual bool hasVRR() const noexcept = 0;
+    virtual bool isVRREnabled() const noexcept = 0;
+    virtual bool setVRREnabled(bool enabled) noexcept = 0;
+    virtual VRRRange vrrRange() const noexcept = 0;
+
+    /* Overlay planes */
+
+    virtual const std::vector<LPlane> &planes() const noexcept = 0;
+    // Checks if the assignments would be accepted without applying them (e.g. DRM TEST_ONLY commit)
+    virtual bool testPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept = 0;
+    // Applied along with the current frame, unassigned planes are disabled. Called from paintGL
+    virtual bool setPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept = 0;
+
     /* Modes */
 
     virtual const std::vector<std::shared_ptr<LOutputMode>> &modes() const noexcept = 0;
@@ -58,14 +78,24 @@ public:
     virtual const std::shared_ptr<LOutputMode> currentMode() const noexcept = 0;
     // 1 success, 0 rollback, -1 dead
     virtual int setMode(std::shared_ptr<LOutputMode> mode) noexcept = 0;
+    // Checks if setMode() would succeed without applying the mode
+    virtual bool testMode(std::shared_ptr<LOutputMode> mode) const noexcept = 0;
 
     /* Cursor */
 
     virtual bool hasCursor() const noexcept = 0;
-    virtual bool setCursor(UInt8 *pixels) noexcept = 0;
+    // Backend owned 64x64 images LCursor renders into, empty if hasCursor() is false
+    virtual const std::vector<std::shared_ptr<RImage>> &cursorImages() const noexcept = 0;
+    // Index of an image not being displayed that can be rendered, -1 if none
+    virtual Int32 acquireCursorImage() noexcept = 0;
+    // Displays one of the cursorImages(), -1 hides the cursor
+    virtual bool commitCursorImage(Int32 index) noexcept = 0;
     virtual bool setCursorPos(SkIPoint pos) noexcept = 0;
 protected:
     friend class LOutput;
+
+    // ARGB8888 images renderable and readable by the main device
+    static std::vector<std::shared_ptr<RImage>> MakeCursorImages(size_t count) noexcept;
     CZWeak<LOutput> m_output;
 };
 
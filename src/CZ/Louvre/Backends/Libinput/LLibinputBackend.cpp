@@ -6,6 +6,7 @@
 #include <CZ/Louvre/LLog.h>
 
 #include <CZ/Louvre/Private/LSeatPrivate.h>
+#include <CZ/Louvre/Private/LTracer.h>
 
 #include <CZ/Core/Events/CZPointerMoveEvent.h>
 #include <CZ/Core/Events/CZPointerScrollEvent.h>
@@ -133,6 +134,7 @@ void LDRMBackend::inputResume() noexcept
 
 void LDRMBackend::inputDispatch() noexcept
 {
+    LTRACE_SCOPE("inputDispatch");
     const int ret { libinput_dispatch(m_libinput) };
 
     if (ret != 0)
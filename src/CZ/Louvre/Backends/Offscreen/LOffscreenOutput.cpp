@@ -2,9 +2,12 @@
 #include <CZ/Louvre/Backends/Offscreen/LOffscreenOutput.h>
 #include <CZ/Louvre/Backends/Offscreen/LOffscreenBackend.h>
 #include <CZ/Louvre/Private/LOutputPrivate.h>
+#include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
 #include <CZ/Louvre/LLog.h>
+#include <CZ/Ream/RSurface.h>
 #include <CZ/Ream/RImage.h>
 #include <CZ/Ream/RCore.h>
+#include <CZ/Ream/RPass.h>
 
 using namespace CZ;
 
@@ -20,6 +23,10 @@ LOffscreenOutput::LOffscreenOutput(LOffscreenBackend *backend, SkISize modeSize)
     info.images[0] = RImage::Make(modeSize, { DRM_FORMAT_ARGB8888, { DRM_FORMAT_MOD_LINEAR } });
     assert(info.images[0]);
     info.modes.emplace_back(std::shared_ptr<LOffscreenOutputMode>(new LOffscreenOutputMode(this, modeSize)));
+
+    // Fake hardware: two overlay planes without scaling nor zpos (assignments can't overlap)
+    for (UInt32 id = 1; id <= 2; id++)
+        info.planes.emplace_back(LPlane { id, device()->dmaTextureFormats() });
 }
 
 LOffscreenOutput::~LOffscreenOutput() noexcept
@@ -47,15 +54,44 @@ bool LOffscreenOutput::init() noexcept
                 break;
 
             output()->imp()->backendPaintGL();
+            blendPlanes();
+
+            if (vrrEnabled)
+            {
+                // Present right away, but not sooner than the max refresh rate allows
+                const UInt64 minPeriod { 1000000000000ULL / vrrRange().max };
+                const UInt64 lastNs { UInt64(info.time.time.tv_sec) * 1000000000ULL + UInt64(info.time.time.tv_nsec) };
+                const UInt64 nextNs { lastNs + minPeriod };
+                const timespec next { .tv_sec = time_t(nextNs / 1000000000ULL), .tv_nsec = long(nextNs % 1000000000ULL) };
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+
+                // The refresh rate is not constant
+                info.time.period = 0;
+            }
+            else if (vsyncEnabled)
+            {
+                // Fake 60 Hz
+                usleep(1000000/60);
+                info.time.period = 1000000000 / 60;
+            }
+            else
+            {
+                // Same as the DRM backend, limited to double the refresh rate
+                usleep(1000000/120);
+                info.time.period = 0;
+            }
 
-            // Fake 60 Hz
-            usleep(1000000/60);
             clock_gettime(CLOCK_MONOTONIC, &info.time.time);
             output()->imp()->backendPresented(info.time);
 
             info.time.seq++;
             info.time.paintEventId++;
-            info.age = 1;
+
+            // Blended planes and cursor must be removed from the next frame
+            {
+                std::lock_guard<std::mutex> lock { cursor.mutex };
+                info.age = scanned.empty() && cursor.current < 0 ? 1 : 0;
+            }
         }
 
         output()->imp()->backendUninitializeGL();
@@ -78,6 +114,168 @@ void LOffscreenOutput::unit() noexcept
     semaphore.release();
 }
 
+bool LOffscreenOutput::testPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept
+{
+    const SkIRect bounds { SkIRect::MakeSize(info.images[0]->size()) };
+    std::vector<const LPlane*> planes;
+
+    for (size_t i = 0; i < assignments.size(); i++)
+    {
+        const auto &a { assignments[i] };
+
+        if (!a.buffer || !a.buffer->image() || !bounds.contains(a.dst) || a.dst.size() != a.buffer->image()->size())
+            return false;
+
+        const auto fmt { a.plane->formats.formats().find(a.buffer->dmaInfo().format) };
+
+        if (fmt == a.plane->formats.formats().end() || !fmt->modifiers().contains(a.buffer->dmaInfo().modifier))
+            return false;
+
+        for (size_t j = 0; j < i; j++)
+            if (assignments[j].plane == a.plane || SkIRect::Intersects(assignments[j].dst, a.dst))
+                return false;
+    }
+
+    return true;
+}
+
+bool LOffscreenOutput::setPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept
+{
+    if (!testPlanes(assignments))
+        return false;
+
+    // Scanned out until replaced
+    for (auto &s : scanned)
+        if (s.buffer)
+            s.buffer->unhold();
+
+    scanned.clear();
+
+    for (const auto &a : assignments)
+    {
+        a.buffer->hold();
+        scanned.emplace_back(a.buffer, a.buffer->image(), a.dst);
+    }
+
+    return true;
+}
+
+void LOffscreenOutput::blendPlanes() noexcept
+{
+    std::shared_ptr<RImage> cursorImage;
+    SkIPoint cursorPos;
+
+    {
+        std::lock_guard<std::mutex> lock { cursor.mutex };
+
+        if (cursor.current >= 0)
+        {
+            cursorImage = cursor.images[cursor.current];
+            cursorPos = cursor.pos;
+        }
+    }
+
+    if (scanned.empty() && !cursorImage)
+        return;
+
+    auto surface { RSurface::WrapImage(info.images[0]) };
+    surface->setGeometry({
+        .viewport = SkRect::Make(info.images[0]->size()),
+        .dst = SkRect::Make(info.images[0]->size()),
+        .transform = CZTransform::Normal});
+
+    auto pass { surface->beginPass(RPassCap_Painter) };
+
+    if (!pass)
+        return;
+
+    auto *p { pass->getPainter() };
+    p->save();
+    p->setBlendMode(RBlendMode::Src);
+
+    for (const auto &s : scanned)
+    {
+        RDrawImageInfo drawInfo {};
+        drawInfo.image = s.image;
+        drawInfo.src = SkRect::Make(s.image->size());
+        drawInfo.dst = s.dst;
+        drawInfo.srcScale = 1.f;
+        drawInfo.srcTransform = CZTransform::Normal;
+        p->drawImage(drawInfo);
+    }
+
+    // Default blending
+    p->restore();
+
+    if (!cursorImage)
+        return;
+
+    RDrawImageInfo drawInfo {};
+    drawInfo.image = cursorImage;
+    drawInfo.src = SkRect::Make(cursorImage->size());
+    drawInfo.dst = SkIRect::MakeXYWH(cursorPos.x(), cursorPos.y(), cursorImage->size().width(), cursorImage->size().height());
+    drawInfo.srcScale = 1.f;
+    drawInfo.srcTransform = CZTransform::Normal;
+    p->drawImage(drawInfo);
+}
+
+Int32 LOffscreenOutput::acquireCursorImage() noexcept
+{
+    if (cursor.images.empty())
+        cursor.images = MakeCursorImages(4);
+
+    if (cursor.images.size() < 2)
+        return -1;
+
+    std::lock_guard<std::mutex> lock { cursor.mutex };
+    const Int32 count { Int32(cursor.images.size()) };
+    cursor.last = (cursor.last + 1) % count;
+
+    if (cursor.last == cursor.current)
+        cursor.last = (cursor.last + 1) % count;
+
+    return cursor.last;
+}
+
+bool LOffscreenOutput::commitCursorImage(Int32 index) noexcept
+{
+    if (index >= Int32(cursor.images.size()))
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock { cursor.mutex };
+
+        if (index < 0)
+            index = -1;
+
+        if (cursor.current == index)
+            return true;
+
+        cursor.current = index;
+    }
+
+    repaint();
+    return true;
+}
+
+bool LOffscreenOutput::setCursorPos(SkIPoint pos) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock { cursor.mutex };
+
+        if (cursor.pos == pos)
+            return true;
+
+        cursor.pos = pos;
+
+        if (cursor.current < 0)
+            return true;
+    }
+
+    repaint();
+    return true;
+}
+
 RDevice *LOffscreenOutput::device() const noexcept
 {
     return backend->m_ream->mainDevice();
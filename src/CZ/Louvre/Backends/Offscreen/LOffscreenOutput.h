@@ -2,8 +2,11 @@
 #define LOFFSCREENOUTPUT_H
 
 #include <CZ/Louvre/Backends/LBackendOutput.h>
+#include <CZ/Louvre/Seat/LPlaneAssignment.h>
 #include <CZ/Core/CZPresentationTime.h>
+#include <atomic>
 #include <future>
+#include <mutex>
 #include <semaphore>
 
 namespace CZ
@@ -48,23 +51,42 @@ public:
 
     /* V-SYNC */
 
-    bool canDisableVSync() const noexcept override { return false; };
-    bool isVSyncEnabled() const noexcept override { return true; };
-    bool enableVSync(bool /*enabled*/) noexcept override { return false; };
+    bool canDisableVSync() const noexcept override { return true; };
+    bool isVSyncEnabled() const noexcept override { return vsyncEnabled; };
+    bool enableVSync(bool enabled) noexcept override { vsyncEnabled = enabled; return true; };
     UInt64 paintEventId() const noexcept override { return info.time.paintEventId; };
 
+    /* VRR (emulated, frames are presented as soon as painted within the range) */
+
+    bool hasVRR() const noexcept override { return true; };
+    bool isVRREnabled() const noexcept override { return vrrEnabled; };
+    bool setVRREnabled(bool enabled) noexcept override { vrrEnabled = enabled; return true; };
+    VRRRange vrrRange() const noexcept override { return { 30000, 60000 }; };
+
+    /* Overlay planes (emulated, blended into the image after paintGL) */
+
+    const std::vector<LPlane> &planes() const noexcept override { return info.planes; };
+    bool testPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept override;
+    bool setPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept override;
+    void blendPlanes() noexcept;
+
     /* Modes */
 
     const std::vector<std::shared_ptr<LOutputMode>> &modes() const noexcept override { return info.modes; };
     const std::shared_ptr<LOutputMode> preferredMode() const noexcept override { return info.modes[0]; };
     const std::shared_ptr<LOutputMode> currentMode() const noexcept override { return info.modes[0]; };
     int setMode(std::shared_ptr<LOutputMode> /*mode*/) noexcept override { return 1; };
+    bool testMode(std::shared_ptr<LOutputMode> mode) const noexcept override { return mode == currentMode(); };
 
     /* Cursor */
 
-    bool hasCursor() const noexcept override { return false; };
-    bool setCursor(UInt8 */*pixels*/) noexcept override { return false; };
-    bool setCursorPos(SkIPoint /*pos*/) noexcept override { return false; };
+    /* Cursor (emulated, blended into the image after paintGL) */
+
+    bool hasCursor() const noexcept override { return true; };
+    const std::vector<std::shared_ptr<RImage>> &cursorImages() const noexcept override { return cursor.images; };
+    Int32 acquireCursorImage() noexcept override;
+    bool commitCursorImage(Int32 index) noexcept override;
+    bool setCursorPos(SkIPoint pos) noexcept override;
 
     struct
     {
@@ -78,12 +100,35 @@ public:
         std::vector<std::shared_ptr<LOutputMode>> modes;
         UInt32 age { 0 };
         CZPresentationTime time {};
+        std::vector<LPlane> planes;
     } info {};
 
+    struct ScannedBuffer
+    {
+        CZWeak<LDMABuffer> buffer;
+        std::shared_ptr<RImage> image;
+        SkIRect dst;
+    };
+
+    std::vector<ScannedBuffer> scanned;
+
+    struct
+    {
+        std::vector<std::shared_ptr<RImage>> images;
+        Int32 last { -1 };
+
+        // Shared with the rendering thread
+        std::mutex mutex;
+        Int32 current { -1 };
+        SkIPoint pos {};
+    } cursor;
+
     CZWeak<LOffscreenBackend> backend;
     std::binary_semaphore semaphore { 0 };
     std::optional<std::promise<bool>> unitPromise;
     bool pendingRepaint { false };
+    std::atomic<bool> vsyncEnabled { true };
+    std::atomic<bool> vrrEnabled { false };
 };
 }
 #endif // LOFFSCREENOUTPUT_H
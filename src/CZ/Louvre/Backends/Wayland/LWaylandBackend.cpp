@@ -28,23 +28,34 @@
 #include <CZ/Louvre/Seat/LKeyboard.h>
 
 #include <sys/poll.h>
+#include <algorithm>
 #include <wayland-client-core.h>
 
 using namespace CZ;
 
 static const wl_pointer_listener pointerLis
 {
-    .enter = [](void *data, wl_pointer */*pointer*/, UInt32 serial, wl_surface */*surface*/, wl_fixed_t x, wl_fixed_t y)
+    .enter = [](void *data, wl_pointer */*pointer*/, UInt32 serial, wl_surface *surface, wl_fixed_t x, wl_fixed_t y)
     {
         auto &wl { static_cast<LWaylandBackend*>(data)->wl };
         wl.seat.pointerEnterSerial = serial;
-        auto diff { SkPoint(wl_fixed_to_double(x), wl_fixed_to_double(y)) - cursor()->pos() };
+
+        // Only the main surface of each output has user data
+        wl.seat.pointerFocus = surface ? static_cast<LWaylandOutput*>(wl_surface_get_user_data(surface)) : nullptr;
+
+        if (!wl.seat.pointerFocus)
+            return;
+
+        const SkIPoint outputPos { wl.seat.pointerFocus->output()->pos() };
+        auto diff { SkPoint(outputPos.x() + wl_fixed_to_double(x), outputPos.y() + wl_fixed_to_double(y)) - cursor()->pos() };
         CZPointerMoveEvent e {};
         e.delta = e.deltaUnaccelerated = diff;
         CZCore::Get()->sendEvent(e, *seat());
     },
-    .leave = [](void */*data*/, wl_pointer */*pointer*/, UInt32 /*serial*/, wl_surface */*surface*/)
+    .leave = [](void *data, wl_pointer */*pointer*/, UInt32 /*serial*/, wl_surface */*surface*/)
     {
+        static_cast<LWaylandBackend*>(data)->wl.seat.pointerFocus = nullptr;
+
         CZPointerButtonEvent e {};
         e.pressed = false;
         while (!seat()->pointer()->pressedButtons.empty())
@@ -54,9 +65,15 @@ static const wl_pointer_listener pointerLis
             CZCore::Get()->sendEvent(e, *seat());
         }
     },
-    .motion = [](void */*data*/, wl_pointer */*pointer*/, UInt32 /*time*/, wl_fixed_t x, wl_fixed_t y)
+    .motion = [](void *data, wl_pointer */*pointer*/, UInt32 /*time*/, wl_fixed_t x, wl_fixed_t y)
     {
-        auto diff { SkPoint(wl_fixed_to_double(x), wl_fixed_to_double(y)) - cursor()->pos() };
+        auto &wl { static_cast<LWaylandBackend*>(data)->wl };
+
+        if (!wl.seat.pointerFocus)
+            return;
+
+        const SkIPoint outputPos { wl.seat.pointerFocus->output()->pos() };
+        auto diff { SkPoint(outputPos.x() + wl_fixed_to_double(x), outputPos.y() + wl_fixed_to_double(y)) - cursor()->pos() };
         CZPointerMoveEvent e {};
         e.delta = e.deltaUnaccelerated = diff;
         CZCore::Get()->sendEvent(e, *seat());
@@ -136,13 +153,19 @@ static const wl_keyboard_listener keyboardLis
 
 static const wl_touch_listener touchLis
 {
-    .down = [](void *data, auto, auto, auto, auto, Int32 id, wl_fixed_t x, wl_fixed_t y)
+    .down = [](void *data, auto, auto, auto, wl_surface *surface, Int32 id, wl_fixed_t x, wl_fixed_t y)
     {
-        auto *backend { static_cast<LWaylandBackend*>(data) };
+        auto &wl { static_cast<LWaylandBackend*>(data)->wl };
+        wl.seat.touchFocus = surface ? static_cast<LWaylandOutput*>(wl_surface_get_user_data(surface)) : nullptr;
+
+        if (!wl.seat.touchFocus)
+            return;
+
+        const auto *output { wl.seat.touchFocus->output() };
         CZTouchDownEvent e {};
         e.id = id;
-        e.pos.fX = wl_fixed_to_double(x)/Float32(backend->outputs()[0]->size().width());
-        e.pos.fY = wl_fixed_to_double(y)/Float32(backend->outputs()[0]->size().height());
+        e.pos.fX = wl_fixed_to_double(x)/Float32(output->size().width());
+        e.pos.fY = wl_fixed_to_double(y)/Float32(output->size().height());
         CZCore::Get()->sendEvent(e, *seat());
     },
     .up = [](auto, auto, auto, auto, Int32 id)
@@ -153,11 +176,16 @@ static const wl_touch_listener touchLis
     },
     .motion = [](void *data, auto, auto, Int32 id, wl_fixed_t x, wl_fixed_t y)
     {
-        auto *backend { static_cast<LWaylandBackend*>(data) };
+        auto &wl { static_cast<LWaylandBackend*>(data)->wl };
+
+        if (!wl.seat.touchFocus)
+            return;
+
+        const auto *output { wl.seat.touchFocus->output() };
         CZTouchMoveEvent e {};
         e.id = id;
-        e.pos.fX = wl_fixed_to_double(x)/Float32(backend->outputs()[0]->size().width());
-        e.pos.fY = wl_fixed_to_double(y)/Float32(backend->outputs()[0]->size().height());
+        e.pos.fX = wl_fixed_to_double(x)/Float32(output->size().width());
+        e.pos.fY = wl_fixed_to_double(y)/Float32(output->size().height());
         CZCore::Get()->sendEvent(e, *seat());
     },
 
@@ -193,7 +221,7 @@ static const wl_seat_listener seatLis
         {
             if (wl.seat.pointer)
             {
-                pointerLis.leave(nullptr, nullptr, 0, nullptr);
+                pointerLis.leave(data, nullptr, 0, nullptr);
                 wl_pointer_destroy(wl.seat.pointer);
                 wl.seat.pointer = nullptr;
             }
@@ -261,6 +289,14 @@ static const wl_registry_listener registryLis
             wl.xdgWmBase = (xdg_wm_base*)wl_registry_bind(registry, name, &xdg_wm_base_interface, 1);
             xdg_wm_base_add_listener(wl.xdgWmBase, &xdgWmBaseLis, data);
         }
+        else if (!wl.subcompositor && strcmp(interface, wl_subcompositor_interface.name) == 0)
+        {
+            wl.subcompositor = (wl_subcompositor*)wl_registry_bind(registry, name, &wl_subcompositor_interface, 1);
+        }
+        else if (!wl.linuxDMABuf && strcmp(interface, zwp_linux_dmabuf_v1_interface.name) == 0 && version >= 3)
+        {
+            wl.linuxDMABuf = (zwp_linux_dmabuf_v1*)wl_registry_bind(registry, name, &zwp_linux_dmabuf_v1_interface, 3);
+        }
         else if (!wl.seat.proxy && strcmp(interface, wl_seat_interface.name) == 0)
         {
             wl.seat.proxy = (wl_seat*)wl_registry_bind(registry, name, &wl_seat_interface, 1);
@@ -275,7 +311,7 @@ bool LWaylandBackend::init() noexcept
     const auto ret {
         initDisplay() &&
         initReam() &&
-        initOutput() };
+        initOutputs() };
 
     if (!ret)
         unit();
@@ -294,6 +330,18 @@ void LWaylandBackend::unit() noexcept
 
     m_defaultFeedback.reset();
 
+    if (wl.linuxDMABuf)
+    {
+        zwp_linux_dmabuf_v1_destroy(wl.linuxDMABuf);
+        wl.linuxDMABuf = {};
+    }
+
+    if (wl.subcompositor)
+    {
+        wl_subcompositor_destroy(wl.subcompositor);
+        wl.subcompositor = {};
+    }
+
     if (wl.xdgWmBase)
     {
         xdg_wm_base_destroy(wl.xdgWmBase);
@@ -374,10 +422,34 @@ bool LWaylandBackend::initReam() noexcept
     return m_ream != nullptr;
 }
 
-bool LWaylandBackend::initOutput() noexcept
+bool LWaylandBackend::initOutputs() noexcept
 {
-    m_outputs.emplace_back(LWaylandOutput::Make(this));
-    return m_outputs[0] != nullptr;
+    Int32 count { 1 };
+
+    if (const char *env = getenv("CZ_LOUVRE_WAYLAND_OUTPUTS"))
+        count = std::clamp(atoi(env), 1, 16);
+
+    if (const char *env = getenv("CZ_LOUVRE_WAYLAND_PASSTHROUGH"))
+        m_passthrough = atoi(env) == 1;
+
+    if (m_passthrough && (!wl.subcompositor || !wl.linuxDMABuf))
+    {
+        log(CZWarning, CZLN, "Passthrough disabled: wl_subcompositor or zwp_linux_dmabuf_v1 >= 3 unsupported by the parent compositor");
+        m_passthrough = false;
+    }
+
+    // One parent toplevel per output
+    for (Int32 i = 1; i <= count; i++)
+    {
+        auto *output { LWaylandOutput::Make(this, i) };
+
+        if (!output)
+            return false;
+
+        m_outputs.emplace_back(output);
+    }
+
+    return true;
 }
 
 void LWaylandBackend::initDefaultFeedback() noexcept
@@ -3,6 +3,7 @@
 
 #include <CZ/Louvre/Backends/LBackend.h>
 #include <CZ/Louvre/Backends/Wayland/xdg-shell-client.h>
+#include <CZ/Louvre/Backends/Wayland/linux-dmabuf-v1-client.h>
 #include <CZ/Louvre/LLog.h>
 
 class CZ::LWaylandBackend : public LBackend
@@ -17,19 +18,18 @@ public:
         wl_touch *touch;
         UInt32 name;
         UInt32 pointerEnterSerial;
+        LWaylandOutput *pointerFocus;
+        LWaylandOutput *touchFocus;
     };
 
     struct WL
     {
         wl_display *display;
         wl_registry *registry;
-        wl_surface *cursorSurface;
-        wl_surface *surface;
         xdg_wm_base *xdgWmBase;
-        xdg_surface *xdgSurface;
-        xdg_toplevel *xdgToplevel;
         wl_compositor *compositor;
-        wl_callback *callback;
+        wl_subcompositor *subcompositor;
+        zwp_linux_dmabuf_v1 *linuxDMABuf;
         WLSeat seat;
     };
 
@@ -55,18 +55,22 @@ public:
     clockid_t presentationClock() const noexcept override { return CLOCK_MONOTONIC; };
     std::shared_ptr<SRMLease> createLease(const std::unordered_set<LOutput*> &) noexcept override { return {}; };
 
+    // Forward eligible DMA buffers to the parent compositor as subsurfaces (CZ_LOUVRE_WAYLAND_PASSTHROUGH)
+    bool passthroughEnabled() const noexcept { return m_passthrough; }
+
     WL wl {};
 protected:
     friend class LWaylandOutput;
     bool initDisplay() noexcept;
     bool initReam() noexcept;
-    bool initOutput() noexcept;
+    bool initOutputs() noexcept;
     void initDefaultFeedback() noexcept;
     std::shared_ptr<RCore> m_ream;
     std::shared_ptr<CZEventSource> m_source;
     std::vector<LOutput*> m_outputs;
     std::set<std::shared_ptr<CZInputDevice>> m_inputDevices;
     std::shared_ptr<LDMAFeedback> m_defaultFeedback;
+    bool m_passthrough { false };
     CZLogger log { LLog.newWithContext("Wayland Backend") };
 };
 
@@ -1,11 +1,17 @@
 #include <CZ/Louvre/Backends/Wayland/LWaylandOutputMode.h>
 #include <CZ/Louvre/Backends/Wayland/LWaylandOutput.h>
 #include <CZ/Louvre/Backends/Wayland/LWaylandBackend.h>
+#include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
 #include <CZ/Louvre/Private/LOutputPrivate.h>
+#include <CZ/Louvre/Private/LSurfacePrivate.h>
 #include <CZ/Louvre/Private/LFactory.h>
 #include <CZ/Louvre/Private/LLockGuard.h>
+#include <CZ/Louvre/Private/LSurfaceTree.h>
+#include <CZ/Louvre/Manager/LSessionLockManager.h>
 #include <CZ/Louvre/Cursor/LCursorSource.h>
 #include <CZ/Louvre/Cursor/LCursor.h>
+#include <CZ/Louvre/LCompositor.h>
+#include <CZ/Louvre/LLog.h>
 #include <CZ/Ream/WL/RWLSwapchain.h>
 #include <CZ/Ream/RPass.h>
 #include <CZ/Ream/RCore.h>
@@ -18,6 +24,8 @@ static wl_surface_listener surfaceLis {};
 static xdg_surface_listener xdgSurfaceLis {};
 static xdg_toplevel_listener xdgToplevelLis {};
 static wl_callback_listener callbackLis {};
+static zwp_linux_buffer_params_v1_listener paramsLis {};
+static wl_buffer_listener bufferLis {};
 
 void LWaylandOutput::handle_preferred_buffer_scale(void *data, wl_surface */*surface*/, Int32 factor) noexcept
 {
@@ -66,7 +74,7 @@ void LWaylandOutput::handle_callback_done(void *data, wl_callback *callback, UIn
     o->output()->imp()->backendPresented(timeInfo);
 
     wl_callback_destroy(callback);
-    o->m_backend->wl.callback = nullptr;
+    o->m_callback = nullptr;
 
     if (o->m_unitPromise.has_value())
         return;
@@ -75,9 +83,43 @@ void LWaylandOutput::handle_callback_done(void *data, wl_callback *callback, UIn
         o->repaint();
 }
 
-LOutput *LWaylandOutput::Make(LWaylandBackend *backend) noexcept
+void LWaylandOutput::handle_params_created(void *data, zwp_linux_buffer_params_v1 *params, wl_buffer *buffer) noexcept
 {
-    auto *o { new LWaylandOutput(backend) };
+    auto *b { static_cast<PassthroughBuffer*>(data) };
+    zwp_linux_buffer_params_v1_destroy(params);
+    b->params = nullptr;
+    b->proxy = buffer;
+    b->ready = true;
+    wl_buffer_add_listener(buffer, &bufferLis, b);
+}
+
+void LWaylandOutput::handle_params_failed(void *data, zwp_linux_buffer_params_v1 *params) noexcept
+{
+    auto *b { static_cast<PassthroughBuffer*>(data) };
+    zwp_linux_buffer_params_v1_destroy(params);
+    b->params = nullptr;
+
+    // Keep the entry so that the import isn't retried, the buffer is composited instead
+    b->failed = true;
+    LLog(CZDebug, CZLN, "[Wayland Backend] The parent compositor failed to import a DMA buffer, compositing it instead");
+}
+
+void LWaylandOutput::handle_buffer_release(void *data, wl_buffer */*buffer*/) noexcept
+{
+    auto *b { static_cast<PassthroughBuffer*>(data) };
+
+    if (!b->busy)
+        return;
+
+    b->busy = false;
+
+    if (b->buffer)
+        b->buffer->unhold();
+}
+
+LOutput *LWaylandOutput::Make(LWaylandBackend *backend, UInt32 id) noexcept
+{
+    auto *o { new LWaylandOutput(backend, id) };
     o->m_modes.emplace_back(std::shared_ptr<LWaylandOutputMode>(new LWaylandOutputMode(o)));
 
     surfaceLis.preferred_buffer_scale = &handle_preferred_buffer_scale;
@@ -88,17 +130,33 @@ LOutput *LWaylandOutput::Make(LWaylandBackend *backend) noexcept
     xdgToplevelLis.configure = &handle_xdg_toplevel_configure;
     xdgToplevelLis.close = &handle_xdg_toplevel_close;
     callbackLis.done = &handle_callback_done;
+    paramsLis.created = &handle_params_created;
+    paramsLis.failed = &handle_params_failed;
+    bufferLis.release = &handle_buffer_release;
 
+    // The user data of the main surface is used to map input events to outputs
     auto &wl { backend->wl };
-    wl.surface = wl_compositor_create_surface(wl.compositor);
-    wl_surface_add_listener(wl.surface, &surfaceLis, o);
-    wl.xdgSurface = xdg_wm_base_get_xdg_surface(wl.xdgWmBase, wl.surface);
-    xdg_surface_add_listener(wl.xdgSurface, &xdgSurfaceLis, o);
-    wl.xdgToplevel = xdg_surface_get_toplevel(wl.xdgSurface);
-    xdg_toplevel_add_listener(wl.xdgToplevel, &xdgToplevelLis, o);
+    o->m_surface = wl_compositor_create_surface(wl.compositor);
+    wl_surface_add_listener(o->m_surface, &surfaceLis, o);
+    o->m_xdgSurface = xdg_wm_base_get_xdg_surface(wl.xdgWmBase, o->m_surface);
+    xdg_surface_add_listener(o->m_xdgSurface, &xdgSurfaceLis, o);
+    o->m_xdgToplevel = xdg_surface_get_toplevel(o->m_xdgSurface);
+    xdg_toplevel_add_listener(o->m_xdgToplevel, &xdgToplevelLis, o);
+    xdg_toplevel_set_title(o->m_xdgToplevel, o->m_name.c_str());
+
+    if (backend->passthroughEnabled())
+    {
+        o->m_passthrough.surface = wl_compositor_create_surface(wl.compositor);
+        o->m_passthrough.subsurface = wl_subcompositor_get_subsurface(wl.subcompositor, o->m_passthrough.surface, o->m_surface);
 
-    wl.cursorSurface = wl_compositor_create_surface(wl.compositor);
-    o->m_cursorSwapchain = RWLSwapchain::Make(wl.cursorSurface, {64, 64});
+        // Input is always handled by the main surface
+        auto *region { wl_compositor_create_region(wl.compositor) };
+        wl_surface_set_input_region(o->m_passthrough.surface, region);
+        wl_region_destroy(region);
+    }
+
+    o->m_cursorSurface = wl_compositor_create_surface(wl.compositor);
+    o->m_cursorSwapchain = RWLSwapchain::Make(o->m_cursorSurface, {64, 64});
 
     LOutput::Params params {};
     params.backend.reset(o);
@@ -109,22 +167,44 @@ LWaylandOutput::~LWaylandOutput() noexcept
 {
     auto &wl { m_backend->wl };
 
-    xdg_toplevel_destroy(wl.xdgToplevel);
-    wl.xdgToplevel = nullptr;
+    if (wl.seat.pointerFocus == this)
+        wl.seat.pointerFocus = nullptr;
+
+    if (wl.seat.touchFocus == this)
+        wl.seat.touchFocus = nullptr;
+
+    destroyPassthroughBuffers(true);
+
+    if (m_passthrough.subsurface)
+    {
+        wl_subsurface_destroy(m_passthrough.subsurface);
+        m_passthrough.subsurface = nullptr;
+    }
+
+    if (m_passthrough.surface)
+    {
+        wl_surface_destroy(m_passthrough.surface);
+        m_passthrough.surface = nullptr;
+    }
+
+    xdg_toplevel_destroy(m_xdgToplevel);
+    m_xdgToplevel = nullptr;
 
-    xdg_surface_destroy(wl.xdgSurface);
-    wl.xdgSurface = nullptr;
+    xdg_surface_destroy(m_xdgSurface);
+    m_xdgSurface = nullptr;
 
     m_swapchain.reset();
 
-    wl_surface_destroy(wl.surface);
-    wl.surface = nullptr;
+    wl_surface_destroy(m_surface);
+    m_surface = nullptr;
 
     m_cursorSwapchain.reset();
-    wl_surface_destroy(wl.cursorSurface);
-    wl.cursorSurface = nullptr;
+    wl_surface_destroy(m_cursorSurface);
+    m_cursorSurface = nullptr;
 
     m_cursorImage.reset();
+    m_cursorImages.clear();
+    m_cursorLast = -1;
     m_images = {{}};
 }
 
@@ -136,13 +216,16 @@ bool LWaylandOutput::init() noexcept
     m_unitPromise.reset();
     m_pendingRepaint = false;
     m_configured = false;
-    xdg_toplevel_set_maximized(m_backend->wl.xdgToplevel);
-    wl_surface_attach(m_backend->wl.surface, NULL, 0, 0);
-    wl_surface_commit(m_backend->wl.surface);
+
+    // With multiple outputs let the parent compositor place them side by side
+    if (m_backend->outputs().size() == 1)
+        xdg_toplevel_set_maximized(m_xdgToplevel);
+
+    wl_surface_attach(m_surface, NULL, 0, 0);
+    wl_surface_commit(m_surface);
     wl_display_flush(m_backend->wl.display);
 
     std::thread([this](){
-        auto &wl { m_backend->wl };
         auto *mode { static_cast<LWaylandOutputMode*>(m_modes[0].get()) };
         auto core { CZCore::Get() };
         output()->imp()->backendInitializeGL();
@@ -160,17 +243,17 @@ bool LWaylandOutput::init() noexcept
                 break;
             }
 
-            if (wl.callback || !m_configured)
+            if (m_callback || !m_configured)
                 continue;
 
             m_paintEventId++;
 
             const SkISize newSize { m_size.fWidth * m_scale, m_size.fHeight * m_scale };
 
-            wl_surface_set_buffer_scale(wl.surface, m_scale);
+            wl_surface_set_buffer_scale(m_surface, m_scale);
 
             if (!m_swapchain)
-                m_swapchain = RWLSwapchain::Make(wl.surface, newSize);
+                m_swapchain = RWLSwapchain::Make(m_surface, newSize);
 
             if (output()->transform() != CZTransform::Normal || newSize != mode->m_size || output()->scale() != m_scale)
             {
@@ -187,9 +270,14 @@ bool LWaylandOutput::init() noexcept
             auto image { m_swapchain->acquire() };
             m_images[0] = image->image;
             m_age = image->age;
+
+            // Must be committed before the main surface (synchronized subsurface)
+            if (m_passthrough.subsurface)
+                updatePassthrough();
+
             output()->imp()->backendPaintGL();
-            wl.callback = wl_surface_frame(wl.surface);
-            wl_callback_add_listener(wl.callback, &callbackLis, this);
+            m_callback = wl_surface_frame(m_surface);
+            wl_callback_add_listener(m_callback, &callbackLis, this);
             m_swapchain->present(image.value(), m_damage.has_value() ? &m_damage.value() : nullptr);
             m_damage.reset();
             core->postEvent(event, *this);
@@ -215,23 +303,29 @@ void LWaylandOutput::unit() noexcept
     m_semaphore.release();
     future.get();
 
-    auto &wl { m_backend->wl };
+    if (m_callback)
+    {
+        wl_callback_destroy(m_callback);
+        m_callback = nullptr;
+    }
 
-    if (wl.callback)
+    output()->imp()->passthroughSurface.reset();
+
+    if (m_passthrough.current)
     {
-        wl_callback_destroy(wl.callback);
-        wl.callback = nullptr;
+        wl_surface_attach(m_passthrough.surface, NULL, 0, 0);
+        wl_surface_commit(m_passthrough.surface);
+        m_passthrough.current = nullptr;
     }
 
-    wl_surface_attach(m_backend->wl.surface, NULL, 0, 0);
-    wl_surface_commit(m_backend->wl.surface);
-    wl_display_flush(wl.display);
+    wl_surface_attach(m_surface, NULL, 0, 0);
+    wl_surface_commit(m_surface);
+    wl_display_flush(m_backend->wl.display);
 }
 
 const std::string &LWaylandOutput::name() const noexcept
 {
-    static const std::string str { "WL-1" };
-    return str;
+    return m_name;
 }
 
 const std::string &LWaylandOutput::make() const noexcept
@@ -266,7 +360,7 @@ RDevice *LWaylandOutput::device() const noexcept
 bool LWaylandOutput::hasCursor() const noexcept
 {
     return
-        m_backend->wl.cursorSurface != nullptr &&
+        m_cursorSurface != nullptr &&
         m_backend->wl.seat.pointer != nullptr;
 }
 
@@ -310,34 +404,226 @@ void LWaylandOutput::updateCursor() noexcept
         p->restore();
         pass.reset();
 
-        wl_surface_set_buffer_scale(m_backend->wl.cursorSurface, m_scale);
+        wl_surface_set_buffer_scale(m_cursorSurface, m_scale);
         m_cursorSwapchain->present(image.value());
-        wl_pointer_set_cursor(m_backend->wl.seat.pointer,
-                              m_backend->wl.seat.pointerEnterSerial,
-                              m_backend->wl.cursorSurface,
-                              m_cursorHotspot.x(), m_cursorHotspot.y());
+
+        // The serial is only valid for the surface with pointer focus
+        if (m_backend->wl.seat.pointerFocus == this)
+            wl_pointer_set_cursor(m_backend->wl.seat.pointer,
+                                  m_backend->wl.seat.pointerEnterSerial,
+                                  m_cursorSurface,
+                                  m_cursorHotspot.x(), m_cursorHotspot.y());
     }
-    else
+    else if (m_backend->wl.seat.pointerFocus == this)
     {
         wl_pointer_set_cursor(m_backend->wl.seat.pointer, m_backend->wl.seat.pointerEnterSerial, NULL, 0, 0);
     }
 }
 
-bool LWaylandOutput::setCursor(UInt8 *pixels) noexcept
+Int32 LWaylandOutput::acquireCursorImage() noexcept
 {
     if (!hasCursor())
+        return -1;
+
+    if (m_cursorImages.empty())
+        m_cursorImages = MakeCursorImages(4);
+
+    if (m_cursorImages.size() < 2)
+        return -1;
+
+    const Int32 count { Int32(m_cursorImages.size()) };
+    m_cursorLast = (m_cursorLast + 1) % count;
+
+    // Never the one being displayed
+    if (m_cursorImage && m_cursorImages[m_cursorLast] == m_cursorImage)
+        m_cursorLast = (m_cursorLast + 1) % count;
+
+    return m_cursorLast;
+}
+
+bool LWaylandOutput::commitCursorImage(Int32 index) noexcept
+{
+    if (!hasCursor() || index >= Int32(m_cursorImages.size()))
         return false;
 
-    if (pixels && cursor()->surface())
-        m_cursorImage = cursor()->surface()->image();
-    else
+    if (index < 0)
         m_cursorImage.reset();
+    else
+        m_cursorImage = m_cursorImages[index];
 
     updateCursor();
     return true;
 }
 
-LWaylandOutput::LWaylandOutput(LWaylandBackend *backend) noexcept : m_backend(backend) {}
+LWaylandOutput::LWaylandOutput(LWaylandBackend *backend, UInt32 id) noexcept :
+    m_backend(backend),
+    m_id(id),
+    m_name(std::format("WL-{}", id))
+{}
+
+LSurface *LWaylandOutput::findPassthroughCandidate() noexcept
+{
+    if (sessionLockManager()->state() != LSessionLockManager::Unlocked || output()->transform() != CZTransform::Normal)
+        return nullptr;
+
+    std::vector<LSurface*> surfaces;
+    LSurfaceTree::Collect(surfaces);
+
+    const SkIRect outputRect { output()->rect() };
+
+    for (auto it = surfaces.rbegin(); it != surfaces.rend(); it++)
+    {
+        LSurface *s { *it };
+        const SkIRect rect { SkIRect::MakePtSize(s->rolePos(), s->size()) };
+
+        if (!SkIRect::Intersects(outputRect, rect))
+            continue;
+
+        // Only the topmost surface can be placed above the composited image
+        if (!outputRect.contains(rect) || !s->bufferResource() || !LDMABuffer::isDMABuffer((wl_resource*)s->bufferResource()))
+            return nullptr;
+
+        if (s->role() && s->role()->exclusiveOutput() && s->role()->exclusiveOutput() != output())
+            return nullptr;
+
+        // Explicit sync points can't be forwarded
+        const auto &buffer { s->imp()->current.buffer };
+        if (buffer.acquireTimeline || buffer.releaseTimeline)
+            return nullptr;
+
+        // The parent must display it exactly as it would be composited
+        if (s->bufferTransform() != CZTransform::Normal ||
+            s->imp()->stateFlags.has(LSurface::LSurfacePrivate::ViewportIsScaled | LSurface::LSurfacePrivate::ViewportIsCropped))
+            return nullptr;
+
+        const auto image { s->image() };
+
+        if (!image || image->size() != SkISize(s->size().width() * s->scale(), s->size().height() * s->scale()))
+            return nullptr;
+
+        return s;
+    }
+
+    return nullptr;
+}
+
+LWaylandOutput::PassthroughBuffer *LWaylandOutput::getPassthroughBuffer(LDMABuffer *buffer) noexcept
+{
+    for (auto &b : m_passthrough.buffers)
+        if (b.buffer.get() == buffer)
+            return &b;
+
+    const auto &info { buffer->dmaInfo() };
+    auto &b { m_passthrough.buffers.emplace_back() };
+    b.buffer.reset(buffer);
+
+    if (info.planeCount == 0)
+    {
+        b.failed = true;
+        return &b;
+    }
+
+    b.params = zwp_linux_dmabuf_v1_create_params(m_backend->wl.linuxDMABuf);
+    zwp_linux_buffer_params_v1_add_listener(b.params, &paramsLis, &b);
+
+    for (int i = 0; i < info.planeCount; i++)
+        zwp_linux_buffer_params_v1_add(b.params, info.fd[i], i, info.offset[i], info.stride[i], info.modifier >> 32, info.modifier & 0xffffffff);
+
+    // Not create_immed, an import failure would be a protocol error
+    zwp_linux_buffer_params_v1_create(b.params, info.width, info.height, info.format, 0);
+    return &b;
+}
+
+void LWaylandOutput::updatePassthrough() noexcept
+{
+    LSurface *surface { findPassthroughCandidate() };
+    PassthroughBuffer *buffer { nullptr };
+
+    if (surface)
+    {
+        buffer = getPassthroughBuffer(static_cast<LDMABuffer*>(wl_resource_get_user_data((wl_resource*)surface->bufferResource())));
+
+        // Composited until the parent imports it
+        if (!buffer->ready)
+        {
+            surface = nullptr;
+            buffer = nullptr;
+        }
+    }
+
+    // The composited image must include or exclude it from now on
+    if (LSurface *prev { output()->imp()->passthroughSurface.get() }; prev != surface)
+    {
+        if (prev)
+            prev->imp()->damageAll();
+
+        if (surface)
+            surface->imp()->damageAll();
+
+        output()->imp()->stateFlags.remove(LOutput::LOutputPrivate::CursorOnlyRepaint);
+        output()->imp()->passthroughSurface.reset(surface);
+    }
+
+    if (!buffer)
+    {
+        if (m_passthrough.current)
+        {
+            wl_surface_attach(m_passthrough.surface, NULL, 0, 0);
+            wl_surface_commit(m_passthrough.surface);
+            m_passthrough.current = nullptr;
+        }
+    }
+    else
+    {
+        const SkIPoint pos { surface->rolePos() - output()->pos() };
+        wl_subsurface_set_position(m_passthrough.subsurface, pos.x(), pos.y());
+
+        if (buffer != m_passthrough.current || surface->damageId() != m_passthrough.damageId)
+        {
+            wl_surface_attach(m_passthrough.surface, buffer->proxy, 0, 0);
+            wl_surface_set_buffer_scale(m_passthrough.surface, surface->scale());
+            wl_surface_damage_buffer(m_passthrough.surface, 0, 0, INT32_MAX, INT32_MAX);
+            wl_surface_commit(m_passthrough.surface);
+            m_passthrough.current = buffer;
+            m_passthrough.damageId = surface->damageId();
+
+            // Released to the client once the parent releases it
+            if (!buffer->busy)
+            {
+                buffer->busy = true;
+                buffer->buffer->hold();
+            }
+        }
+    }
+
+    destroyPassthroughBuffers(false);
+}
+
+void LWaylandOutput::destroyPassthroughBuffers(bool all) noexcept
+{
+    for (auto it = m_passthrough.buffers.begin(); it != m_passthrough.buffers.end();)
+    {
+        if (!all && (it->buffer || it->busy || it->params || &(*it) == m_passthrough.current))
+        {
+            it++;
+            continue;
+        }
+
+        if (it->params)
+            zwp_linux_buffer_params_v1_destroy(it->params);
+
+        if (it->proxy)
+            wl_buffer_destroy(it->proxy);
+
+        if (it->busy && it->buffer)
+            it->buffer->unhold();
+
+        it = m_passthrough.buffers.erase(it);
+    }
+
+    if (all)
+        m_passthrough.current = nullptr;
+}
 
 bool LWaylandOutput::event(const CZEvent &e) noexcept
 {
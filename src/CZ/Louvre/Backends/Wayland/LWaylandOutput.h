@@ -2,17 +2,21 @@
 #define LWAYLANDOUTPUT_H
 
 #include <CZ/Louvre/Backends/Wayland/xdg-shell-client.h>
+#include <CZ/Louvre/Backends/Wayland/linux-dmabuf-v1-client.h>
 #include <CZ/Ream/WL/RWLSwapchain.h>
 #include <CZ/Louvre/Backends/LBackendOutput.h>
+#include <CZ/Louvre/Seat/LPlaneAssignment.h>
+#include <CZ/Core/CZWeak.h>
 #include <future>
 #include <semaphore>
+#include <list>
 
 namespace CZ
 {
 class LWaylandOutput : public LBackendOutput
 {
 public:
-    static LOutput *Make(LWaylandBackend *backend) noexcept;
+    static LOutput *Make(LWaylandBackend *backend, UInt32 id) noexcept;
     ~LWaylandOutput() noexcept;
 
     bool init() noexcept override;
@@ -28,7 +32,7 @@ public:
     SkISize mmSize() const noexcept override { return {0,0}; }
     RSubpixel subpixel() const noexcept override { return RSubpixel::Unknown; }
     bool isNonDesktop() const noexcept override { return false; };
-    UInt32 id() const noexcept override { return 1; };
+    UInt32 id() const noexcept override { return m_id; };
     RDevice *device() const noexcept override;
 
     void setContentType(RContentType /*type*/) noexcept override {};
@@ -52,6 +56,19 @@ public:
     bool canDisableVSync() const noexcept override { return false; };
     bool isVSyncEnabled() const noexcept override { return true; };
     bool enableVSync(bool /*enabled*/) noexcept override { return false; };
+
+    /* VRR */
+
+    bool hasVRR() const noexcept override { return false; };
+    bool isVRREnabled() const noexcept override { return false; };
+    bool setVRREnabled(bool /*enabled*/) noexcept override { return false; };
+    VRRRange vrrRange() const noexcept override { return {}; };
+
+    /* Overlay planes */
+
+    const std::vector<LPlane> &planes() const noexcept override { return m_planes; };
+    bool testPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept override { return assignments.empty(); };
+    bool setPlanes(const std::vector<LPlaneAssignment> &assignments) noexcept override { return assignments.empty(); };
     UInt64 paintEventId() const noexcept override { return m_paintEventId; };
 
     /* Modes */
@@ -60,26 +77,67 @@ public:
     const std::shared_ptr<LOutputMode> preferredMode() const noexcept override { return m_modes[0]; };
     const std::shared_ptr<LOutputMode> currentMode() const noexcept override { return m_modes[0]; };
     int setMode(std::shared_ptr<LOutputMode> /*mode*/) noexcept override { return 1; };
+    bool testMode(std::shared_ptr<LOutputMode> mode) const noexcept override { return mode == currentMode(); };
 
     /* Cursor */
 
     bool hasCursor() const noexcept override;
-    bool setCursor(UInt8 *pixels) noexcept override;
+    const std::vector<std::shared_ptr<RImage>> &cursorImages() const noexcept override { return m_cursorImages; };
+    Int32 acquireCursorImage() noexcept override;
+    bool commitCursorImage(Int32 index) noexcept override;
     bool setCursorPos(SkIPoint pos) noexcept override;
     void updateCursor() noexcept;
 
 protected:
     friend class LWaylandBackend;
-    LWaylandOutput(LWaylandBackend *backend) noexcept;
+
+    // A client DMA buffer imported by the parent compositor
+    struct PassthroughBuffer
+    {
+        CZWeak<LDMABuffer> buffer;
+        zwp_linux_buffer_params_v1 *params;
+        wl_buffer *proxy;
+        bool ready; // 'created' received
+        bool failed;
+        bool busy; // Attached and not yet released by the parent
+    };
+
+    struct Passthrough
+    {
+        wl_surface *surface;
+        wl_subsurface *subsurface;
+        PassthroughBuffer *current;
+        UInt32 damageId;
+
+        // std::list to keep the addresses stable (used as listener data)
+        std::list<PassthroughBuffer> buffers;
+    };
+
+    LWaylandOutput(LWaylandBackend *backend, UInt32 id) noexcept;
+    LSurface *findPassthroughCandidate() noexcept;
+    PassthroughBuffer *getPassthroughBuffer(LDMABuffer *buffer) noexcept;
+    void updatePassthrough() noexcept;
+    void destroyPassthroughBuffers(bool all) noexcept;
     bool event(const CZEvent &e) noexcept override;
     static void handle_preferred_buffer_scale(void *data, wl_surface *surface, Int32 factor) noexcept;
     static void handle_xdg_surface_configure(void *data, xdg_surface *xdgSurface, UInt32 serial) noexcept;
     static void handle_xdg_toplevel_configure(void *data, xdg_toplevel *toplevel, Int32 width, Int32 height, wl_array *states) noexcept;
     static void handle_xdg_toplevel_close(void *data, xdg_toplevel *toplevel) noexcept;
     static void handle_callback_done(void *data, wl_callback *callback, UInt32 ms) noexcept;
+    static void handle_params_created(void *data, zwp_linux_buffer_params_v1 *params, wl_buffer *buffer) noexcept;
+    static void handle_params_failed(void *data, zwp_linux_buffer_params_v1 *params) noexcept;
+    static void handle_buffer_release(void *data, wl_buffer *buffer) noexcept;
 
     std::binary_semaphore m_semaphore { 0 };
     CZWeak<LWaylandBackend> m_backend;
+    UInt32 m_id;
+    std::string m_name;
+    wl_surface *m_surface {};
+    xdg_surface *m_xdgSurface {};
+    xdg_toplevel *m_xdgToplevel {};
+    wl_callback *m_callback {};
+    Passthrough m_passthrough {};
+    std::vector<LPlane> m_planes; // Unsupported, see passthroughSurface()
     std::vector<std::shared_ptr<RImage>> m_images { {} };
     std::optional<SkRegion> m_damage;
     std::vector<std::shared_ptr<LOutputMode>> m_modes;
@@ -92,7 +150,10 @@ protected:
     bool m_pendingRepaint { false };
 
     std::shared_ptr<RImage> m_cursorImage;
+    std::vector<std::shared_ptr<RImage>> m_cursorImages;
+    Int32 m_cursorLast { -1 };
     SkIPoint m_cursorHotspot {};
+    wl_surface *m_cursorSurface {};
     std::shared_ptr<RWLSwapchain> m_cursorSwapchain;
 
     std::optional<std::promise<bool>> m_unitPromise;
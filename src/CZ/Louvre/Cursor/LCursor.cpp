@@ -42,15 +42,20 @@ LCursor::LCursor() noexcept
     m_hotspot = { 9, 9 };
     m_louvreSource = m_fallbackSource = LCursorSource::Make(m_image, m_hotspot);
 
-    // Sampling surface
+    m_animationTimer.setCallback([this](CZTimer *timer) {
+        if (!m_animatedSource)
+            return;
+
+        auto &source { *m_animatedSource };
+        source.m_frame = (source.m_frame + 1) % source.m_frames.size();
+        timer->start(source.m_frames[source.m_frame].delay);
+
+        // The frames are already uploaded, only the plane buffers are updated
+        setSource(m_source);
 
-    RImageConstraints cons {};
-    cons.allocator = ream->mainDevice();
-    cons.caps[cons.allocator] = RImageCap::RImageCap_Dst;
-    cons.readFormats = {DRM_FORMAT_ARGB8888, DRM_FORMAT_ABGR8888};
-    auto surfaceImage { RImage::Make({64, 64}, *format, &cons) };
-    assert(surfaceImage);
-    m_surface = RSurface::WrapImage(surfaceImage);
+        if (isVisible())
+            repaintOutputs(true);
+    });
 
     setSize(SkSize(24, 24));
     setSource({});
@@ -59,6 +64,7 @@ LCursor::LCursor() noexcept
 
 LCursor::~LCursor() noexcept
 {
+    m_animationTimer.stop(false);
     notifyDestruction();
 }
 
@@ -67,6 +73,8 @@ void LCursor::setSource(std::shared_ptr<LCursorSource> source) noexcept
     if (!source)
         source = m_fallbackSource;
 
+    updateAnimation(source);
+
     bool sourceIsVisible {};
 
     switch (source->visibility())
@@ -99,6 +107,37 @@ void LCursor::setSource(std::shared_ptr<LCursorSource> source) noexcept
     updateLater();
 }
 
+void LCursor::updateAnimation(std::shared_ptr<LCursorSource> source) noexcept
+{
+    auto animated { source->asImage() };
+
+    if (!animated)
+    {
+        if (auto shape = source->asShape())
+        {
+            animated = getShapeAsset(shape->shape());
+
+            if (!animated)
+                animated = m_fallbackSource;
+        }
+    }
+
+    if (animated && animated->m_frames.empty())
+        animated.reset();
+
+    if (animated == m_animatedSource)
+        return;
+
+    m_animationTimer.stop(false);
+    m_animatedSource = animated;
+
+    if (animated)
+    {
+        animated->m_frame = 0;
+        m_animationTimer.start(animated->m_frames.front().delay);
+    }
+}
+
 void LCursor::setFallbackSource(std::shared_ptr<LImageCursorSource> source) noexcept
 {
     if (!source)
@@ -137,14 +176,23 @@ void LCursor::updateLater() const noexcept
     compositor()->imp()->unlockPoll();
 }
 
-static void Image2Buffer(std::shared_ptr<RSurface> surface, std::shared_ptr<RImage> image, UInt8 *buffer, SkSize size, CZTransform transform) noexcept
+// Renders the cursor image directly into one of the backend cursor images
+static bool RenderCursorImage(std::shared_ptr<RImage> dst, std::shared_ptr<RImage> image, SkISize size, CZTransform transform) noexcept
 {
+    auto surface { RSurface::WrapImage(dst) };
+
+    if (!surface)
+        return false;
+
     surface->setGeometry({
         .viewport = SkRect::MakeWH(64, 64),
         .dst = SkRect::MakeWH(64, 64),
         .transform = transform});
     auto pass { surface->beginPass(RPassCap_Painter) };
-    assert(pass);
+
+    if (!pass)
+        return false;
+
     auto *p { pass->getPainter() };
     p->save();
     p->setBlendMode(RBlendMode::Src);
@@ -157,33 +205,55 @@ static void Image2Buffer(std::shared_ptr<RSurface> surface, std::shared_ptr<RIma
     info.magFilter = RImageFilter::Linear;
     info.minFilter = RImageFilter::Linear;
     info.src = SkRect::Make(info.image->size());
-    info.dst = SkIRect::MakeSize(size.toRound());
+    info.dst = SkIRect::MakeSize(size);
     p->drawImage(info);
     p->restore();
-    pass.reset();
+    return true;
+}
+
+void LCursor::updatePlane(LOutput *output) noexcept
+{
+    auto *backend { output->backend() };
+    const auto &images { backend->cursorImages() };
+    auto &keys { output->imp()->cursorImageKeys };
+    keys.resize(images.size());
+
+    LOutput::LOutputPrivate::CursorImageKey key {};
+    key.image = m_image;
+    key.writeSerial = m_image->writeSerial();
+    key.size = SkISize::Make(m_size.width() * output->fractionalScale(), m_size.height() * output->fractionalScale());
+    key.transform = output->transform();
+
+    // Already rendered (e.g. a previous frame of an animated cursor)
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (keys[i].matches(key))
+        {
+            backend->commitCursorImage(i);
+            return;
+        }
+    }
 
-    RPixelBufferRegion trans {};
-    trans.pixels = buffer;
-    trans.region.setRect(SkIRect::MakeWH(64, 64));
-    trans.stride = 64 * 4;
-    trans.format = DRM_FORMAT_ARGB8888;
+    const Int32 index { backend->acquireCursorImage() };
 
-    if (!surface->image()->readPixels(trans))
+    if (index < 0 || size_t(index) >= images.size())
     {
-        trans.format = DRM_FORMAT_ABGR8888;
+        backend->commitCursorImage(-1);
+        return;
+    }
 
-        if (!surface->image()->readPixels(trans))
-            return;
+    // Backends may create the images lazily within acquireCursorImage()
+    keys.resize(images.size());
+    keys[index] = {};
 
-        // Convert to RGBA8888
-        UInt8 tmp;
-        for (Int32 i = 0; i < 64*64*4; i+=4)
-        {
-            tmp = buffer[i];
-            buffer[i] = buffer[i+2];
-            buffer[i+2] = tmp;
-        }
+    if (!RenderCursorImage(images[index], m_image, key.size, key.transform))
+    {
+        backend->commitCursorImage(-1);
+        return;
     }
+
+    keys[index] = std::move(key);
+    backend->commitCursorImage(index);
 }
 
 void LCursor::update() noexcept
@@ -206,6 +276,8 @@ void LCursor::update() noexcept
 
     for (LOutput *o : compositor()->outputs())
     {
+        const bool wasIntersected { m_intersectedOutputs.contains(o) };
+
         if (m_isVisible && SkIRect::Intersects(o->rect(), m_rect))
         {
             const auto it { m_intersectedOutputs.insert(o) };
@@ -216,28 +288,22 @@ void LCursor::update() noexcept
             if (hasPlane(o) && (m_imageChanged || it.second))
             {
                 if (isPlaneEnabled(o))
-                {
-                    Image2Buffer(
-                        m_surface,
-                        m_image,
-                        m_buffer,
-                        SkSize(m_size.width() * o->fractionalScale(),
-                               m_size.height() * o->fractionalScale()),
-                        o->transform());
-
-                    o->backend()->setCursor(m_buffer);
-                }
+                    updatePlane(o);
                 else
-                    o->backend()->setCursor(nullptr);
+                    o->backend()->commitCursorImage(-1);
             }
         }
         else
         {
             leave.emplace(o);
             m_intersectedOutputs.erase(o);
-            o->backend()->setCursor(nullptr);
+            o->backend()->commitCursorImage(-1);
         }
 
+        // Clear the previous rect and paint the new one, see LOutput::paintCursor()
+        if (!isPlaneEnabled(o) && (wasIntersected || m_intersectedOutputs.contains(o)))
+            o->imp()->repaintCursor();
+
         if (cursor()->isPlaneEnabled(o))
         {
             SkPoint p { newPosS - SkPoint::Make(o->pos().x(), o->pos().y()) };
@@ -360,7 +426,9 @@ void LCursor::setVisible(bool visible) noexcept
     if (!isVisible())
     {
         for (LOutput *o : compositor()->outputs())
-            o->backend()->setCursor(nullptr);
+            o->backend()->commitCursorImage(-1);
+
+        repaintOutputs(true);
     }
     else
     {
@@ -372,14 +440,18 @@ void LCursor::setVisible(bool visible) noexcept
 void LCursor::repaintOutputs(bool softwareOnly) noexcept
 {
     for (auto *o : intersectedOutputs())
-        if (!softwareOnly || !isPlaneEnabled(o))
+    {
+        if (!isPlaneEnabled(o))
+            o->imp()->repaintCursor();
+        else if (!softwareOnly)
             o->repaint();
+    }
 }
 
 bool LCursor::hasPlane(const LOutput *output) const noexcept
 {
     if (!output) return false;
-    return m_surface && output->backend()->hasCursor();
+    return output->backend()->hasCursor();
 }
 
 void LCursor::enablePlane(LOutput *output, bool enabled) noexcept
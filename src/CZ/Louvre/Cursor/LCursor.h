@@ -5,6 +5,7 @@
 #include <CZ/Louvre/LObject.h>
 #include <CZ/Core/CZWeak.h>
 #include <CZ/Core/CZCursorShape.h>
+#include <CZ/Core/CZTimer.h>
 #include <CZ/skia/core/SkRect.h>
 #include <memory>
 
@@ -13,7 +14,7 @@
  *
  * Louvre creates a single instance of this class to display the cursor across all outputs.
  * This class also takes advantage of overlay cursor planes that may be available on outputs.
- * When cursor planes are not available or are disabled, the cursor should be painted manually.
+ * When cursor planes are not available or are disabled, the cursor should be painted with LOutput::paintCursor() or manually.
  */
 class CZ::LCursor : public LObject
 {
@@ -91,7 +92,8 @@ public:
      *
      * Returns the cursor rect, which is defined as SkIRect(pos - hotspot, size), in compositor-global coordinates.
      *
-     * You should use this rect and the current source to paint the cursor when a plane is not available.
+     * You should use this rect and the current source to paint the cursor when a plane is not available,
+     * unless it is painted with LOutput::paintCursor().
      */
     const SkIRect &rect() const noexcept { return m_rect; };
 
@@ -135,6 +137,8 @@ public:
     /**
      * @brief Invokes LOutput::repaint() for each intersected outputs.
      *
+     * Outputs without a cursor plane are repainted as if only the cursor changed, see LOutput::paintCursor().
+     *
      * @param softwareOnly If `true`, only repaints outputs that don't have a cursor plane.
      */
     void repaintOutputs(bool softwareOnly = true) noexcept;
@@ -147,7 +151,7 @@ public:
     /**
      * @brief Toggles the cursor plane for the specified output.
      *
-     * When disabled, the cursor should be painted manually (see rect()).
+     * When disabled, the cursor should be painted with LOutput::paintCursor() or manually (see rect()).
      *
      * The cursor plane is enabled by default if the output has one.
      *
@@ -163,7 +167,6 @@ public:
      */
     bool isPlaneEnabled(const LOutput *output) const noexcept;
 
-    std::shared_ptr<const RSurface> surface() const noexcept { return m_surface; }
     ~LCursor() noexcept;
 
 private:
@@ -174,6 +177,9 @@ private:
     void updateLater() const noexcept;
     void update() noexcept;
 
+    // Renders or reuses one of the backend cursor images
+    void updatePlane(LOutput *output) noexcept;
+
     SkPoint m_pos {};
     SkSize m_size {};
     SkIPoint m_hotspot {};
@@ -193,8 +199,10 @@ private:
 
     ShapeAssets m_shapeAssets;
 
-    std::shared_ptr<RSurface> m_surface;
-    UInt8 m_buffer[64*64*4];
+    // Cycles the frames of animated image sources
+    void updateAnimation(std::shared_ptr<LCursorSource> source) noexcept;
+    std::shared_ptr<LImageCursorSource> m_animatedSource;
+    CZTimer m_animationTimer;
 };
 
 #endif // LCURSOR_H
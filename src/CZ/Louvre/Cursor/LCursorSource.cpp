@@ -1,6 +1,7 @@
 #include <CZ/Louvre/Cursor/LImageCursorSource.h>
 #include <CZ/Louvre/Cursor/LShapeCursorSource.h>
 #include <CZ/Louvre/Cursor/LRoleCursorSource.h>
+#include <CZ/Louvre/Cursor/LXCursorTheme.h>
 #include <CZ/Louvre/LLog.h>
 
 #include <CZ/Ream/RCore.h>
@@ -9,8 +10,6 @@
 
 #include <CZ/Core/CZBitset.h>
 
-#include <X11/Xcursor/Xcursor.h>
-
 using namespace CZ;
 
 std::shared_ptr<LImageCursorSource> LCursorSource::Make(std::shared_ptr<RImage> image, SkIPoint hotspot) noexcept
@@ -40,48 +39,16 @@ std::shared_ptr<LImageCursorSource> LCursorSource::MakeFromTheme(const char *nam
         return {};
     }
 
-    auto ream { RCore::Get() };
-
-    if (!ream)
-    {
-        LLog(CZError, CZLN, "Cursors must be created after the compositor is initialized");
-        return  {};
-    }
-
-    const auto &formats { ream->mainDevice()->textureFormats().formats() };
-    auto format { formats.find(DRM_FORMAT_ABGR8888) };
+    auto xCursorTheme { LXCursorTheme::Get(theme) };
 
-    if (format == formats.end())
+    if (!xCursorTheme)
         return {};
 
-    auto *xCursor { XcursorLibraryLoadImage(name, theme, suggestedSize) };
+    auto source { xCursorTheme->cursor(name, suggestedSize) };
 
-    if (!xCursor)
-    {
+    if (!source)
         LLog(CZError, CZLN, "Failed to load X Cursor {}", name);
-        return {};
-    }
-
-    const auto hotspot { SkIPoint::Make(xCursor->xhot, xCursor->yhot) };
 
-    RPixelBufferInfo info {};
-    info.pixels = (UInt8*)xCursor->pixels;
-    info.alphaType = kPremul_SkAlphaType;
-    info.format = DRM_FORMAT_ABGR8888;
-    info.stride = xCursor->width * 4;
-    info.size = SkISize::Make(xCursor->width, xCursor->height);
-
-    auto image { RImage::MakeFromPixels(info, *format) };
-    XcursorImageDestroy(xCursor);
-
-    if (!image)
-    {
-        LLog(CZError, CZLN, "Failed to create image from X Cursor");
-        return {};
-    }
-
-    auto source { std::shared_ptr<LImageCursorSource>(new LImageCursorSource(image, hotspot)) };
-    source->m_self = source;
     return source;
 }
 
@@ -62,6 +62,9 @@ public:
     /**
      * @brief Load a cursor from an XCursor theme.
      *
+     * The theme is parsed once and shared, see LXCursorTheme. The returned source is animated
+     * if the cursor has multiple frames.
+     *
      * @param name           The name of the cursor to load (must not be nullptr).
      * @param theme          The XCursor theme name, or nullptr to use the default theme.
      * @param suggestedSize  The preferred size of the cursor in pixels (default: 64).
@@ -3,20 +3,56 @@
 
 #include <CZ/Louvre/Cursor/LCursorSource.h>
 #include <CZ/skia/core/SkPoint.h>
+#include <vector>
 
 class CZ::LImageCursorSource : public LCursorSource
 {
 public:
-    std::shared_ptr<RImage> image() const noexcept override { return m_image; };
-    SkIPoint hotspot() const noexcept override { return m_hotspot; };
+    /**
+     * @brief Animation frame, see frames().
+     */
+    struct Frame
+    {
+        /// The frame image
+        std::shared_ptr<RImage> image;
+
+        /// The hotspot in buffer coordinates
+        SkIPoint hotspot;
+
+        /// Time the frame is displayed in milliseconds
+        UInt32 delay;
+    };
+
+    std::shared_ptr<RImage> image() const noexcept override { return m_frames.empty() ? m_image : m_frames[m_frame].image; };
+    SkIPoint hotspot() const noexcept override { return m_frames.empty() ? m_hotspot : m_frames[m_frame].hotspot; };
+
+    /**
+     * @brief Animation frames.
+     *
+     * Empty unless the source is animated (e.g. an animated XCursor, see LXCursorTheme), in which case
+     * LCursor cycles through them while the source is applied, without uploading the images again.
+     */
+    const std::vector<Frame> &frames() const noexcept { return m_frames; }
 
 protected:
     friend class LCursorSource;
+    friend class LXCursorTheme;
+    friend class LCursor;
     LImageCursorSource(std::shared_ptr<RImage> image, SkIPoint hotspot) noexcept :
         LCursorSource(Image), m_image(image), m_hotspot(hotspot) {}
 
+    // Animated only if frames.size() > 1
+    LImageCursorSource(std::vector<Frame> &&frames) noexcept :
+        LCursorSource(Image), m_image(frames.front().image), m_hotspot(frames.front().hotspot)
+    {
+        if (frames.size() > 1)
+            m_frames = std::move(frames);
+    }
+
     std::shared_ptr<RImage> m_image;
     SkIPoint m_hotspot;
+    std::vector<Frame> m_frames;
+    size_t m_frame { 0 };
 };
 
 #endif // CZ_LCURSORIMAGE_H
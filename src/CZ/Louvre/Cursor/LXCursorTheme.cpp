@@ -0,0 +1,437 @@
+#include <CZ/Louvre/Private/LCompositorPrivate.h>
+#include <CZ/Louvre/Cursor/LXCursorTheme.h>
+#include <CZ/Louvre/LLog.h>
+
+#include <CZ/Ream/RCore.h>
+#include <CZ/Ream/RImage.h>
+#include <CZ/Ream/RDevice.h>
+
+#include <X11/Xcursor/Xcursor.h>
+
+#include <unordered_set>
+#include <algorithm>
+#include <fstream>
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <cstring>
+
+using namespace CZ;
+
+static const std::array<std::vector<const char*>, size_t(CZCursorShape::MoveOrResize)> ShapeNamesTable
+{{
+    /* Default */        { "left_ptr", "arrow" },
+    /* ContextMenu */    { "context-menu", "arrow" },
+    /* Help */           { "question_arrow", "help" },
+    /* Pointer */        { "hand2", "pointer" },
+    /* Progress */       { "watch", "left_ptr_watch" },
+    /* Wait */           { "watch", "left_ptr_watch" },
+    /* Cell */           { "xterm", "crosshair" },
+    /* Crosshair */      { "crosshair", "tcross" },
+    /* Text */           { "xterm", "ibeam" },
+    /* VerticalText */   { "xterm", "ibeam" },
+    /* Alias */          { "alias", "draped_box" },
+    /* Copy */           { "copy", "draped_box" },
+    /* Move */           { "move", "fleur" },
+    /* NoDrop */         { "no-drop", "circle" },
+    /* NotAllowed */     { "not-allowed", "circle" },
+    /* Grab */           { "grab", "fleur" },
+    /* Grabbing */       { "grabbing", "fleur" },
+    /* ResizeR */        { "right_side", "e-resize" },
+    /* ResizeT */        { "top_side", "n-resize" },
+    /* ResizeTR */       { "top_right_corner", "ne-resize" },
+    /* ResizeTL */       { "top_left_corner", "nw-resize" },
+    /* ResizeB */        { "bottom_side", "s-resize" },
+    /* ResizeBR */       { "bottom_right_corner", "se-resize" },
+    /* ResizeBL */       { "bottom_left_corner", "sw-resize" },
+    /* ResizeL */        { "left_side", "w-resize" },
+    /* ResizeLR */       { "sb_h_double_arrow", "h_double_arrow" },
+    /* ResizeTB */       { "sb_v_double_arrow", "v_double_arrow" },
+    /* ResizeTRBL */     { "top_right_corner", "bottom_left_corner" },
+    /* ResizeTLBR */     { "top_left_corner", "bottom_right_corner" },
+    /* ResizeColumn */   { "sb_h_double_arrow", "h_double_arrow" },
+    /* ResizeRow */      { "sb_v_double_arrow", "v_double_arrow" },
+    /* AllScroll */      { "fleur", "cross" },
+    /* ZoomIn */         { "zoom-in", "plus" },
+    /* ZoomOut */        { "zoom-out", "minus" },
+    /* DragAndDropAsk */ { "question_arrow", "hand2" },
+    /* MoveOrResize */   { "fleur", "hand2" },
+}};
+
+const std::vector<const char*> &LXCursorTheme::ShapeNames(CZCursorShape shape) noexcept
+{
+    static const std::vector<const char*> empty;
+
+    if (shape < CZCursorShape::Default || shape > CZCursorShape::MoveOrResize)
+        return empty;
+
+    return ShapeNamesTable[size_t(shape) - 1];
+}
+
+std::shared_ptr<LXCursorTheme> LXCursorTheme::Get(const char *theme) noexcept
+{
+    if (!compositor() || !RCore::Get())
+    {
+        LLog(CZError, CZLN, "Cursor themes must be loaded after the compositor is initialized");
+        return {};
+    }
+
+    std::string name;
+
+    if (theme)
+        name = theme;
+    else if (const char *env = getenv("XCURSOR_THEME"))
+        name = env;
+
+    if (name.empty())
+        name = "default";
+
+    auto &themes { compositor()->imp()->xCursorThemes };
+    auto it { themes.find(name) };
+
+    if (it != themes.end())
+        return it->second;
+
+    auto ret { std::shared_ptr<LXCursorTheme>(new LXCursorTheme(name)) };
+    themes.emplace(name, ret);
+    return ret;
+}
+
+LXCursorTheme::LXCursorTheme(const std::string &name) noexcept : m_name(name)
+{
+    const int fd { eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) };
+
+    if (fd < 0)
+    {
+        LLog(CZWarning, CZLN, "Failed to create eventfd, loading cursor theme {} synchronously", m_name);
+        m_parsedDirs = ResolveDirs(m_name);
+        handleReady();
+        return;
+    }
+
+    m_readySource = CZEventSource::Make(fd, EPOLLIN, CZOwn::Own, [this](int fd, UInt32, CZEventSource*) {
+        eventfd_t value;
+        eventfd_read(fd, &value);
+        handleReady();
+    });
+
+    m_worker = std::thread([this, fd]{
+        pthread_setname_np(pthread_self(), "LXCursorTheme");
+        m_parsedDirs = ResolveDirs(m_name);
+
+        for (const auto &names : ShapeNamesTable)
+        {
+            for (const char *name : names)
+            {
+                if (m_parsed.contains(name))
+                    continue;
+
+                Cursor cursor;
+
+                if (Parse(m_parsedDirs, name, cursor))
+                    m_parsed.emplace(name, std::move(cursor));
+            }
+        }
+
+        eventfd_write(fd, 1);
+    });
+}
+
+LXCursorTheme::~LXCursorTheme() noexcept
+{
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void LXCursorTheme::wait() noexcept
+{
+    if (m_ready)
+        return;
+
+    if (m_worker.joinable())
+        m_worker.join();
+
+    handleReady();
+}
+
+void LXCursorTheme::onReady(const std::function<void()> &callback) noexcept
+{
+    if (!callback)
+        return;
+
+    if (m_ready)
+        callback();
+    else
+        m_onReady.emplace_back(callback);
+}
+
+void LXCursorTheme::handleReady() noexcept
+{
+    if (m_ready)
+        return;
+
+    if (m_worker.joinable())
+        m_worker.join();
+
+    m_dirs = std::move(m_parsedDirs);
+
+    // Cursors parsed synchronously in the meantime take precedence
+    for (auto &[name, cursor] : m_parsed)
+        m_cursors.try_emplace(name, std::move(cursor));
+
+    m_parsed.clear();
+    m_ready = true;
+
+    LLog(CZDebug, CZLN, "Cursor theme {} loaded ({} cursors)", m_name, m_cursors.size());
+
+    auto callbacks { std::move(m_onReady) };
+    m_onReady.clear();
+
+    for (auto &callback : callbacks)
+        callback();
+}
+
+std::shared_ptr<LImageCursorSource> LXCursorTheme::cursor(const std::string &name, Int32 size) noexcept
+{
+    auto it { m_cursors.find(name) };
+
+    if (it == m_cursors.end())
+    {
+        // The worker thread is still using m_parsedDirs
+        if (m_dirs.empty())
+            m_dirs = ResolveDirs(m_name);
+
+        Cursor cursor;
+
+        if (!Parse(m_dirs, name, cursor))
+        {
+            // Avoid parsing again
+            if (m_ready)
+                m_cursors.emplace(name, Cursor());
+
+            return {};
+        }
+
+        it = m_cursors.emplace(name, std::move(cursor)).first;
+    }
+
+    Cursor &cursor { it->second };
+
+    if (cursor.sizes.empty())
+        return {};
+
+    auto lookup { cursor.lookup.find(size) };
+
+    if (lookup != cursor.lookup.end())
+        return lookup->second;
+
+    // Closest nominal size, the larger one on ties
+    auto best { cursor.sizes.begin() };
+
+    for (auto s = cursor.sizes.begin(); s != cursor.sizes.end(); s++)
+        if (std::abs(s->nominal - size) <= std::abs(best->nominal - size))
+            best = s;
+
+    if (!best->source)
+        best->source = Upload(*best);
+
+    cursor.lookup.emplace(size, best->source);
+    return best->source;
+}
+
+std::shared_ptr<LImageCursorSource> LXCursorTheme::shape(CZCursorShape shape, Int32 size) noexcept
+{
+    if (shape < CZCursorShape::Default || shape > CZCursorShape::MoveOrResize)
+        return {};
+
+    auto &lookup { m_shapeLookup[size_t(shape) - 1] };
+    auto it { lookup.find(size) };
+
+    if (it != lookup.end())
+        return it->second;
+
+    std::shared_ptr<LImageCursorSource> source;
+
+    for (const char *name : ShapeNames(shape))
+        if ((source = cursor(name, size)))
+            break;
+
+    // Misses are only final once the whole theme is parsed
+    if (source || m_ready)
+        lookup.emplace(size, source);
+
+    return source;
+}
+
+std::vector<std::string> LXCursorTheme::ResolveDirs(const std::string &theme) noexcept
+{
+    std::vector<std::string> searchPath;
+    const char *libraryPath { XcursorLibraryPath() };
+
+    if (libraryPath)
+    {
+        const char *home { getenv("HOME") };
+        std::string path { libraryPath };
+        size_t start { 0 };
+
+        while (start <= path.size())
+        {
+            size_t end { path.find(':', start) };
+
+            if (end == std::string::npos)
+                end = path.size();
+
+            std::string dir { path.substr(start, end - start) };
+
+            if (!dir.empty() && dir[0] == '~')
+            {
+                if (home)
+                    searchPath.emplace_back(home + dir.substr(1));
+            }
+            else if (!dir.empty())
+                searchPath.emplace_back(std::move(dir));
+
+            start = end + 1;
+        }
+    }
+
+    std::vector<std::string> dirs;
+    std::unordered_set<std::string> visited;
+    std::vector<std::string> pending { theme };
+
+    if (theme != "default")
+        pending.emplace_back("default");
+
+    // Breadth-first over the Inherits= entries of each index.theme
+    for (size_t i = 0; i < pending.size() && i < 64; i++)
+    {
+        if (!visited.emplace(pending[i]).second)
+            continue;
+
+        for (const auto &base : searchPath)
+        {
+            const std::string themeDir { base + "/" + pending[i] };
+
+            if (access((themeDir + "/cursors").c_str(), R_OK) == 0)
+                dirs.emplace_back(themeDir + "/cursors");
+
+            std::ifstream index { themeDir + "/index.theme" };
+            std::string line;
+
+            while (std::getline(index, line))
+            {
+                if (!line.starts_with("Inherits"))
+                    continue;
+
+                const size_t eq { line.find('=') };
+
+                if (eq == std::string::npos)
+                    continue;
+
+                std::string inherited;
+
+                for (char c : line.substr(eq + 1))
+                {
+                    if (c == ',' || c == ';' || c == ':' || c == ' ' || c == '\t')
+                    {
+                        if (!inherited.empty())
+                            pending.emplace_back(std::move(inherited));
+
+                        inherited.clear();
+                    }
+                    else
+                        inherited += c;
+                }
+
+                if (!inherited.empty())
+                    pending.emplace_back(std::move(inherited));
+            }
+        }
+    }
+
+    return dirs;
+}
+
+bool LXCursorTheme::Parse(const std::vector<std::string> &dirs, const std::string &name, Cursor &cursor) noexcept
+{
+    XcursorImages *images {};
+
+    for (const auto &dir : dirs)
+        if ((images = XcursorFilenameLoadAllImages((dir + "/" + name).c_str())))
+            break;
+
+    if (!images)
+        return false;
+
+    for (int i = 0; i < images->nimage; i++)
+    {
+        const XcursorImage *img { images->images[i] };
+
+        if (!img || img->width == 0 || img->height == 0)
+            continue;
+
+        auto size { std::find_if(cursor.sizes.begin(), cursor.sizes.end(), [img](const Size &s) { return s.nominal == Int32(img->size); }) };
+
+        if (size == cursor.sizes.end())
+        {
+            cursor.sizes.emplace_back(Int32(img->size));
+            size = cursor.sizes.end() - 1;
+        }
+
+        Frame &frame { size->frames.emplace_back() };
+        frame.size = SkISize::Make(img->width, img->height);
+        frame.hotspot = SkIPoint::Make(img->xhot, img->yhot);
+        frame.delay = std::max(img->delay, XcursorUInt(1));
+        frame.pixels.assign(img->pixels, img->pixels + img->width * img->height);
+    }
+
+    XcursorImagesDestroy(images);
+
+    std::sort(cursor.sizes.begin(), cursor.sizes.end(), [](const Size &a, const Size &b) { return a.nominal < b.nominal; });
+    return !cursor.sizes.empty();
+}
+
+std::shared_ptr<LImageCursorSource> LXCursorTheme::Upload(Size &size) noexcept
+{
+    auto ream { RCore::Get() };
+
+    if (!ream)
+        return {};
+
+    const auto &formats { ream->mainDevice()->textureFormats().formats() };
+    auto format { formats.find(DRM_FORMAT_ABGR8888) };
+
+    if (format == formats.end())
+        return {};
+
+    std::vector<LImageCursorSource::Frame> frames;
+    frames.reserve(size.frames.size());
+
+    for (auto &frame : size.frames)
+    {
+        RPixelBufferInfo info {};
+        info.pixels = (UInt8*)frame.pixels.data();
+        info.alphaType = kPremul_SkAlphaType;
+        info.format = DRM_FORMAT_ABGR8888;
+        info.stride = frame.size.width() * 4;
+        info.size = frame.size;
+
+        auto image { RImage::MakeFromPixels(info, *format) };
+
+        if (!image)
+        {
+            LLog(CZError, CZLN, "Failed to create image from X Cursor");
+            return {};
+        }
+
+        frames.emplace_back(image, frame.hotspot, frame.delay);
+    }
+
+    // No longer needed
+    for (auto &frame : size.frames)
+        frame.pixels = {};
+
+    auto source { std::shared_ptr<LImageCursorSource>(new LImageCursorSource(std::move(frames))) };
+    source->m_self = source;
+    return source;
+}
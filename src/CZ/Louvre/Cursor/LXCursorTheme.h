@@ -0,0 +1,132 @@
+#ifndef CZ_LXCURSORTHEME_H
+#define CZ_LXCURSORTHEME_H
+
+#include <CZ/Louvre/Cursor/LImageCursorSource.h>
+#include <CZ/Core/CZCursorShape.h>
+#include <CZ/Core/CZEventSource.h>
+#include <CZ/skia/core/SkSize.h>
+#include <unordered_map>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <array>
+
+/**
+ * @brief Shared XCursor theme cache.
+ *
+ * Each theme is parsed only once, on a worker thread, keeping every nominal size and animation frame
+ * of the cursors referenced by the CZCursorShape set (see ShapeNames()). The frames of each (cursor, size) pair
+ * are uploaded to RImages the first time they are requested, later lookups are served from hash tables.
+ *
+ * Cursors with multiple frames are returned as animated LImageCursorSources, see LImageCursorSource::frames().
+ *
+ * Instances are shared and kept alive until the compositor is uninitialized, see Get().
+ */
+class CZ::LXCursorTheme final
+{
+public:
+    /**
+     * @brief Gets a cached theme.
+     *
+     * Starts loading it on a worker thread if this is the first request.
+     *
+     * @param theme The theme name, or `nullptr` to use the `XCURSOR_THEME` environment variable or "default" if unset.
+     * @return The theme instance, or `nullptr` if called before the compositor is initialized.
+     */
+    static std::shared_ptr<LXCursorTheme> Get(const char *theme = nullptr) noexcept;
+
+    /**
+     * @brief XCursor names tried in order for the given shape.
+     */
+    static const std::vector<const char*> &ShapeNames(CZCursorShape shape) noexcept;
+
+    /**
+     * @brief The theme name.
+     */
+    const std::string &name() const noexcept { return m_name; }
+
+    /**
+     * @brief Checks whether the worker thread finished parsing the theme.
+     */
+    bool ready() const noexcept { return m_ready; }
+
+    /**
+     * @brief Blocks until ready().
+     */
+    void wait() noexcept;
+
+    /**
+     * @brief Invokes the callback from the main thread once ready(), or immediately if it already is.
+     */
+    void onReady(const std::function<void()> &callback) noexcept;
+
+    /**
+     * @brief Gets a cursor by name.
+     *
+     * If the theme is not ready() and the cursor has not been requested before, it is parsed
+     * synchronously instead of waiting for the worker thread.
+     *
+     * @param name The XCursor name, e.g. "left_ptr".
+     * @param size The preferred size, the closest nominal size available is used.
+     * @return The cursor source, or `nullptr` if not found.
+     */
+    std::shared_ptr<LImageCursorSource> cursor(const std::string &name, Int32 size) noexcept;
+
+    /**
+     * @brief Gets the cursor for a shape.
+     *
+     * Same as cursor() with the first available name of ShapeNames(), results are memoized per size.
+     *
+     * @return The cursor source, or `nullptr` if none of the names were found.
+     */
+    std::shared_ptr<LImageCursorSource> shape(CZCursorShape shape, Int32 size) noexcept;
+
+    ~LXCursorTheme() noexcept;
+private:
+    struct Frame
+    {
+        SkISize size;
+        SkIPoint hotspot;
+        UInt32 delay;
+        std::vector<UInt32> pixels; // Released once uploaded
+    };
+
+    struct Size
+    {
+        Int32 nominal;
+        std::vector<Frame> frames;
+        std::shared_ptr<LImageCursorSource> source;
+    };
+
+    struct Cursor
+    {
+        std::vector<Size> sizes; // Sorted by nominal size
+        std::unordered_map<Int32, std::shared_ptr<LImageCursorSource>> lookup; // By requested size
+    };
+
+    using ShapeLookup = std::array<std::unordered_map<Int32, std::shared_ptr<LImageCursorSource>>, size_t(CZCursorShape::MoveOrResize)>;
+
+    LXCursorTheme(const std::string &name) noexcept;
+    static std::vector<std::string> ResolveDirs(const std::string &theme) noexcept;
+    static bool Parse(const std::vector<std::string> &dirs, const std::string &name, Cursor &cursor) noexcept;
+    static std::shared_ptr<LImageCursorSource> Upload(Size &size) noexcept;
+    void handleReady() noexcept;
+
+    std::string m_name;
+    bool m_ready { false };
+
+    // Only touched by the main thread
+    std::unordered_map<std::string, Cursor> m_cursors;
+    ShapeLookup m_shapeLookup;
+    std::vector<std::string> m_dirs;
+    std::vector<std::function<void()>> m_onReady;
+
+    // Written by the worker thread, merged into m_cursors once ready
+    std::unordered_map<std::string, Cursor> m_parsed;
+    std::vector<std::string> m_parsedDirs;
+    std::thread m_worker;
+    std::shared_ptr<CZEventSource> m_readySource;
+};
+
+#endif // CZ_LXCURSORTHEME_H
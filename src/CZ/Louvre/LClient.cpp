@@ -88,6 +88,51 @@ const std::string &LClient::privateHandle() const noexcept
     return imp()->privateHandle;
 }
 
+UInt32 LClient::fdCount() const noexcept
+{
+    return imp()->fdCount;
+}
+
+const LClient::FdLimits &LClient::fdLimits() const noexcept
+{
+    return imp()->fdLimits;
+}
+
+void LClient::setFdLimits(const FdLimits &limits) noexcept
+{
+    imp()->fdLimits = limits;
+
+    if (imp()->fdLimits.soft > imp()->fdLimits.hard)
+        imp()->fdLimits.soft = imp()->fdLimits.hard;
+}
+
+bool LClient::LClientPrivate::exceedsFdLimit(UInt32 count) const noexcept
+{
+    return fdCount + count > fdLimits.hard;
+}
+
+bool LClient::LClientPrivate::acquireFds(UInt32 count, bool enforce) noexcept
+{
+    if (enforce && exceedsFdLimit(count))
+    {
+        lClient->fdLimitExceeded(true);
+        return false;
+    }
+
+    const bool wasBelowSoft { fdCount <= fdLimits.soft };
+    fdCount += count;
+
+    if (wasBelowSoft && fdCount > fdLimits.soft)
+        lClient->fdLimitExceeded(false);
+
+    return true;
+}
+
+void LClient::LClientPrivate::releaseFds(UInt32 count) noexcept
+{
+    fdCount = count > fdCount ? 0 : fdCount - count;
+}
+
 const CZEvent *LClient::findEventBySerial(UInt32 serial) const noexcept
 {
     if (imp()->eventHistory.keyboard.enter.serial == serial)
@@ -292,6 +337,11 @@ const std::vector<ImageCaptureSource::GForeignToplevelImageCaptureSourceManager
     return imp()->foreignToplevelImageCaptureSourceManagerGlobals;
 }
 
+const std::vector<ImageCopyCapture::GImageCopyCaptureManager *> &LClient::imageCopyCaptureManagerGlobals() const noexcept
+{
+    return imp()->imageCopyCaptureManagerGlobals;
+}
+
 const std::vector<LayerShell::GLayerShell *> &LClient::layerShellGlobals() const noexcept
 {
     return imp()->layerShellGlobals;
@@ -185,7 +185,9 @@ public:
     /**
      * @brief Immediately flushes pending events.
      *
-     * Use this method to forcefully and immediately send any pending messages to the client.
+     * Use this method to forcefully and immediately send any pending messages to the client.\n
+     * Otherwise events are batched and flushed once per LCompositor::dispatch() iteration, see LCompositor::flushClients().
+     * Only worth it for latency-sensitive events sent outside the main loop dispatch.
      */
     void flush() noexcept;
 
@@ -262,6 +264,53 @@ public:
      */
     std::shared_ptr<LCursorSource> cursor() const noexcept;
 
+    /**
+     * @brief File descriptor limits.
+     *
+     * @see setFdLimits()
+     */
+    struct FdLimits
+    {
+        /// fdLimitExceeded() is invoked each time fdCount() rises above it
+        UInt32 soft { 1024 };
+
+        /// Requests that would exceed it are rejected with a `no_memory` error, disconnecting the client
+        UInt32 hard { 4096 };
+    };
+
+    /**
+     * @brief Number of file descriptors currently held on behalf of the client.
+     *
+     * Includes the planes of DMA buffers (pending `zwp_linux_buffer_params_v1` and created `wl_buffer`s)
+     * and imported DRM sync timelines.
+     *
+     * Keymaps and data offer fds are not included since they are only held while being sent.
+     */
+    UInt32 fdCount() const noexcept;
+
+    /**
+     * @brief Current file descriptor limits.
+     */
+    const FdLimits &fdLimits() const noexcept;
+
+    /**
+     * @brief Sets the file descriptor limits.
+     *
+     * Fds already held are never closed, lowering the limits only affects new requests.
+     */
+    void setFdLimits(const FdLimits &limits) noexcept;
+
+    /**
+     * @brief Notifies that the client exceeded one of its fdLimits().
+     *
+     * @param hard `true` if a request was rejected because of the hard limit (the client is disconnected right after),
+     *             `false` if fdCount() just rose above the soft limit.
+     *
+     * @par Default Implementation
+     * @snippet LClientDefault.cpp fdLimitExceeded
+     */
+    virtual void fdLimitExceeded(bool hard);
+
     /**
      * Resources created when the client binds to the [wl_output](https://wayland.app/protocols/wayland#wl_output) global.\n
      *
@@ -404,6 +453,13 @@ public:
      */
     const std::vector<Protocols::ImageCaptureSource::GForeignToplevelImageCaptureSourceManager*> &foreignToplevelImageCaptureSourceManagerGlobals() const noexcept;
 
+    /**
+     * Resources created when the client binds to the
+     * [ext_image_copy_capture_manager_v1](https://wayland.app/protocols/ext-image-copy-capture-v1#ext_image_copy_capture_manager_v1) global
+     * of the Image Copy Capture protocol.
+     */
+    const std::vector<Protocols::ImageCopyCapture::GImageCopyCaptureManager*> &imageCopyCaptureManagerGlobals() const noexcept;
+
     /**
      * Resources created when the client binds to the
      * [zwlr_layer_shell_v1](https://wayland.app/protocols/wlr-layer-shell-unstable-v1#zwlr_layer_shell_v1) global
@@ -8,6 +8,8 @@
 #include <CZ/Louvre/Private/LSurfacePrivate.h>
 #include <CZ/Louvre/Private/LOutputPrivate.h>
 #include <CZ/Louvre/Private/LLockGuard.h>
+#include <CZ/Louvre/Private/LProtocolRecorder.h>
+#include <CZ/Louvre/Private/LTracer.h>
 
 #include <CZ/Louvre/Backends/LBackend.h>
 
@@ -268,6 +270,7 @@ bool LCompositor::start()
     imp()->threadId = std::this_thread::get_id();
     imp()->state = CompositorState::Initializing;
     imp()->ream.reset();
+    imp()->raiseFdLimit();
 
     if (!imp()->initWayland())
     {
@@ -297,6 +300,8 @@ bool LCompositor::start()
 
     imp()->ream = RCore::Get();
     imp()->state = CompositorState::Initialized;
+    LTracer::Init();
+    LProtocolRecorder::Init();
     initialized();
     return true;
 
@@ -319,9 +324,11 @@ int LCompositor::dispatch(int msTimeout)
     auto ream { RCore::Get() };
     const int ret { poll(&pollfd, 1, msTimeout) };
     const auto lock { LLockGuard() };
+    LTRACE_SCOPE("dispatch");
 
     seat()->setIsUserIdleHint(true);
     imp()->dispatchPresentationTimeEvents();
+    imp()->dispatchMainThreadTasks();
     imp()->handleUnreleasedBuffers();
     imp()->processRemovedGlobals();
     imp()->handlePosixSignalChanges();
@@ -335,6 +342,8 @@ int LCompositor::dispatch(int msTimeout)
                 idleListener->resetTimer();
 
     cursor()->update();
+    imp()->updateToplevelsVisibility();
+    imp()->updateOutputsContent();
     flushClients();
     imp()->handleDestroyedClients();
 
@@ -409,54 +418,105 @@ void LCompositor::repaintAllOutputs() noexcept
 
 bool LCompositor::addOutput(LOutput *output)
 {
-    // Check if already initialized
-    for (LOutput *o : outputs())
-        if (o == output)
-            return true;
+    return addOutputs({ &output, 1 });
+}
+
+bool LCompositor::addOutputs(std::span<LOutput* const> outputs)
+{
+    struct Pending
+    {
+        LOutput *output;
+        std::future<bool> future;
+        bool ok;
+    };
+
+    std::vector<Pending> pending;
+    pending.reserve(outputs.size());
+    const UInt64 startMs { CZTime::Ms() };
+
+    for (LOutput *output : outputs)
+    {
+        // Check if already initialized (or listed twice)
+        if (std::find(imp()->outputs.begin(), imp()->outputs.end(), output) != imp()->outputs.end())
+            continue;
 
-    if (output->lease())
-        output->lease()->finished();
+        if (output->lease())
+            output->lease()->finished();
 
-    imp()->outputs.push_back(output);
+        imp()->outputs.push_back(output);
+        imp()->toplevelsVisibilityChanged = true;
 
-    if (imp()->outputs.size() == 1)
-        cursor()->setOutput(output);
+        if (imp()->outputs.size() == 1)
+            cursor()->setOutput(output);
 
-    bool ok;
-    output->imp()->state = LOutput::PendingInitialize;
-    output->imp()->initPromise = std::promise<bool>();
-    auto future { output->imp()->initPromise.get_future() };
+        output->imp()->state = LOutput::PendingInitialize;
+        output->imp()->initPromise = std::promise<bool>();
+        pending.emplace_back(output, output->imp()->initPromise.get_future(), true);
+    }
+
+    if (pending.empty())
+        return true;
 
     const auto didUnlock { LLockGuard::Unlock() };
 
-    try {
-        if (!output->backend()->init())
-            output->imp()->initPromise.set_value(false);
-        ok = future.get();
+    // Start all threads first, each initializeGL() still runs with the lock held
+    for (auto &p : pending)
+    {
+        try {
+            if (!p.output->backend()->init())
+                p.output->imp()->initPromise.set_value(false);
+        }
+        catch(...) {
+            p.ok = false;
+        }
     }
-    catch(...) {
-        ok = false;
+
+    const UInt64 startedMs { CZTime::Ms() };
+
+    for (auto &p : pending)
+    {
+        if (!p.ok)
+            continue;
+
+        try {
+            p.ok = p.future.get();
+        }
+        catch(...) {
+            p.ok = false;
+        }
     }
 
     if (didUnlock)
         LLockGuard::Lock();
 
-    if (!ok)
+    bool allOk { true };
+
+    for (auto &p : pending)
     {
-        output->imp()->state = LOutput::Uninitialized;
-        LLog(CZError, CZLN, "Failed to initialize output {}", output->name());
-        CZVectorUtils::RemoveOne(imp()->outputs, output);
+        if (!p.ok)
+        {
+            allOk = false;
+            p.output->imp()->state = LOutput::Uninitialized;
+            LLog(CZError, CZLN, "Failed to initialize output {}", p.output->name());
+            CZVectorUtils::RemoveOne(imp()->outputs, p.output);
+            imp()->toplevelsVisibilityChanged = true;
 
-        if (imp()->outputs.empty())
-            cursor()->setOutput(nullptr);
+            if (imp()->outputs.empty())
+                cursor()->setOutput(nullptr);
 
-        return false;
+            continue;
+        }
+
+        for (auto *head : p.output->imp()->wlrOutputHeads)
+            head->enabled(true);
+
+        LLog(CZDebug, CZLN, "Output {} initialized in {} ms", p.output->name(), p.output->imp()->initializedMs - startMs);
     }
 
-    for (auto *head : output->imp()->wlrOutputHeads)
-        head->enabled(true);
+    LLog(CZDebug, CZLN, "{} output(s) added: threads started in {} ms, all ready in {} ms",
+         pending.size(), startedMs - startMs, CZTime::Ms() - startMs);
 
-    return true;
+    return allOk;
 }
 
 void LCompositor::removeOutput(LOutput *output)
@@ -474,6 +534,8 @@ void LCompositor::removeOutput(LOutput *output)
         if (output->threadId() == std::this_thread::get_id())
             return;
 
+        output->imp()->finishModeset();
+
         output->imp()->state = LOutput::PendingUninitialize;
         output->imp()->unitPromise = std::promise<bool>();
         auto future { output->imp()->unitPromise.get_future() };
@@ -489,10 +551,18 @@ void LCompositor::removeOutput(LOutput *output)
         for (auto *head : output->imp()->wlrOutputHeads)
             head->enabled(false);
 
-        for (LSurface *s : surfaces())
+        std::vector<LSurface*> outputSurfaces;
+
+        for (const auto &[client, clientSurfaces] : output->imp()->clientSurfaces)
+            outputSurfaces.insert(outputSurfaces.end(), clientSurfaces.begin(), clientSurfaces.end());
+
+        for (LSurface *s : outputSurfaces)
             s->sendOutputLeaveEvent(output);
 
+        output->imp()->clientSurfaces.clear();
+
         CZVectorUtils::RemoveOne(imp()->outputs, output);
+        imp()->toplevelsVisibilityChanged = true;
 
         // Remove all wl_outputs from clients
         for (LClient *client : clients())
@@ -513,6 +583,8 @@ void LCompositor::removeOutput(LOutput *output)
             }
         }
 
+        output->imp()->clientGlobals.clear();
+
         if (output->imp()->global)
             removeGlobal(output->imp()->global);
 
@@ -537,6 +609,40 @@ const std::array<std::list<LSurface *>, 5> &LCompositor::layers() const noexcept
     return imp()->layers;
 }
 
+void LCompositor::setToplevelAutoSuspend(bool enabled) noexcept
+{
+    if (imp()->toplevelAutoSuspend == enabled)
+        return;
+
+    imp()->toplevelAutoSuspend = enabled;
+
+    if (enabled)
+        imp()->toplevelsVisibilityChanged = true;
+    else
+        imp()->resumeAutoSuspendedToplevels();
+}
+
+bool LCompositor::toplevelAutoSuspend() const noexcept
+{
+    return imp()->toplevelAutoSuspend;
+}
+
+void LCompositor::setToplevelAutoSuspendDelay(UInt32 ms) noexcept
+{
+    imp()->toplevelAutoSuspendDelay = ms;
+    imp()->toplevelsVisibilityChanged = true;
+}
+
+UInt32 LCompositor::toplevelAutoSuspendDelay() const noexcept
+{
+    return imp()->toplevelAutoSuspendDelay;
+}
+
+UInt32 LCompositor::suspendedClientsCount() const noexcept
+{
+    return imp()->suspendedClientsCount;
+}
+
 const std::vector<LOutput *> &LCompositor::outputs() const noexcept
 {
     return imp()->outputs;
@@ -549,6 +655,7 @@ const std::vector<LClient *> &LCompositor::clients() const noexcept
 
 void LCompositor::flushClients() noexcept
 {
+    LTRACE_SCOPE("flushClients");
     compositor()->imp()->sendPendingConfigurations();
     wl_display_flush_clients(LCompositor::display());
 }
@@ -9,6 +9,7 @@
 
 #include <filesystem>
 #include <thread>
+#include <span>
 #include <unordered_set>
 #include <vector>
 #include <list>
@@ -53,6 +54,7 @@ public:
         CZWeak<LGlobal> ForeignToplevelList;
         CZWeak<LGlobal> ForeignToplevelImageCaptureSourceManager;
         CZWeak<LGlobal> OutputImageCaptureSourceManager;
+        CZWeak<LGlobal> ImageCopyCaptureManager;
 
         CZWeak<LGlobal> XdgWmBase;
         CZWeak<LGlobal> XdgDecorationManager;
@@ -234,6 +236,10 @@ public:
      * @brief Flush all pending client events.
      *
      * This method immediatly flushes all pending client events and configurations.
+     *
+     * Events are not flushed as they are queued, this is called once at the end of each dispatch() and after each
+     * LOutput::paintGL(), so that clients with multiple pending events (e.g. buffer releases from many subsurface commits)
+     * are written to only once. Only clients with pending events are written to.
      */
     static void flushClients() noexcept;
 
@@ -270,6 +276,21 @@ public:
      */
     bool addOutput(LOutput *output);
 
+    /**
+     * @brief Initializes multiple outputs at once.
+     *
+     * Same as addOutput() but all rendering threads are started before waiting for any of them, so that the
+     * graphic context creation and first modeset of each output overlap. Preferred over calling addOutput()
+     * in a loop at startup or when multiple outputs are plugged in at once.
+     *
+     * The duration of each phase is logged with the debug level.
+     *
+     * @param outputs The outputs to initialize, obtained from LSeat::outputs().
+     *
+     * @return `true` if all outputs were initialized, `false` if any failed (the rest remain initialized).
+     */
+    bool addOutputs(std::span<LOutput* const> outputs);
+
     /**
      * @brief Uninitializes the specified output.
      *
@@ -292,6 +313,57 @@ public:
      */
     void repaintAllOutputs() noexcept;
 
+    /**
+     * @name Toplevel Auto Suspension
+     */
+
+    ///@{
+
+    /**
+     * @brief Enables or disables the automatic suspension of hidden toplevels.
+     *
+     * When enabled, Louvre tracks the visibility of toplevels using the output rects, the opaque regions of the surfaces
+     * and the stacking order given by layers(). It is recomputed only when surfaces are mapped, moved, resized, restacked
+     * or minimized, or when the outputs or the session lock state change.
+     * Toplevels hidden for longer than toplevelAutoSuspendDelay() are configured with the @ref CZWinSuspended state,
+     * see LToplevelRole::isAutoSuspended().
+     *
+     * @warning The visibility is only accurate for the default scene, i.e. surfaces drawn at LSurface::rolePos() by the
+     *          default LOutput::paintGL(), without transforms. Compositors with a custom scene should leave it disabled,
+     *          otherwise visible windows may be suspended. Disabled by default.
+     */
+    void setToplevelAutoSuspend(bool enabled) noexcept;
+
+    /**
+     * @brief Checks if automatic suspension of hidden toplevels is enabled.
+     *
+     * @see setToplevelAutoSuspend()
+     */
+    bool toplevelAutoSuspend() const noexcept;
+
+    /**
+     * @brief Sets the time in milliseconds a toplevel must remain hidden before being suspended.
+     *
+     * Toplevels are resumed immediately once visible again. Defaults to 1000 ms.
+     */
+    void setToplevelAutoSuspendDelay(UInt32 ms) noexcept;
+
+    /**
+     * @brief Time in milliseconds a toplevel must remain hidden before being suspended.
+     *
+     * @see setToplevelAutoSuspendDelay()
+     */
+    UInt32 toplevelAutoSuspendDelay() const noexcept;
+
+    /**
+     * @brief Number of clients whose mapped toplevels are all automatically suspended.
+     *
+     * Updated each time the toplevels visibility is recalculated.
+     */
+    UInt32 suspendedClientsCount() const noexcept;
+
+    ///@}
+
     /**
      * @brief Searches for the most intersected output
      *
@@ -429,7 +501,12 @@ public:
      */
     virtual void initialized() noexcept;
 
-    // TODO: Add doc
+    /**
+     * @brief Loads the cursor shape assets.
+     *
+     * Called from the default initialized() implementation. By default, the default XCursor theme is parsed on a worker thread
+     * (see LXCursorTheme) and the assets are assigned with LCursor::setShapeAsset() once ready, without delaying the first frame.
+     */
     virtual void loadCursorShapes() noexcept;
 
     /**
@@ -70,8 +70,17 @@ void LExclusiveZone::setOutput(LOutput *output) noexcept
 
     if (m_output)
     {
+        LExclusiveZone *next { nextZone() };
         m_output->imp()->exclusiveZones.erase(m_outputLink);
-        m_output->imp()->updateExclusiveZones();
+
+        // The next zone takes its place
+        if (next)
+        {
+            next->m_edgesBefore = m_edgesBefore;
+            m_output->imp()->updateExclusiveZones(next);
+        }
+        else
+            m_output->imp()->updateExclusiveZones();
     }
 
     m_output.reset(output);
@@ -80,6 +89,7 @@ void LExclusiveZone::setOutput(LOutput *output) noexcept
     {
         output->imp()->exclusiveZones.emplace_back(this);
         m_outputLink = std::prev(output->imp()->exclusiveZones.end());
+        m_edgesBefore = output->imp()->exclusiveEdges;
     }
 
     update();
@@ -143,7 +153,7 @@ LExclusiveZone *LExclusiveZone::prevZone() const noexcept
 void LExclusiveZone::update() noexcept
 {
     if (output())
-        output()->imp()->updateExclusiveZones();
+        output()->imp()->updateExclusiveZones(this);
     else
         m_rect.setEmpty();
 }
@@ -203,6 +203,7 @@ private:
     CZEdge m_edge;
     Int32 m_size { 0 };
     SkIRect m_rect { 0, 0, 0, 0 };
+    LMargins m_edgesBefore; // Exclusive edges taken by previous zones, see LOutputPrivate::updateExclusiveZones()
     mutable std::list<LExclusiveZone*>::iterator m_outputLink;
     OnRectChangeCallback m_onRectChangeCallback { nullptr };
 };
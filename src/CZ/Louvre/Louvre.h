@@ -29,6 +29,7 @@
 #define LOUVRE_SCREEN_COPY_MANAGER_VERSION 3
 #define LOUVRE_OUTPUT_IMAGE_CAPTURE_SOURCE_MANAGER 1
 #define LOUVRE_FOREIGN_TOPLEVEL_IMAGE_CAPTURE_SOURCE_MANAGER 1
+#define LOUVRE_IMAGE_COPY_CAPTURE_MANAGER_VERSION 1
 #define LOUVRE_LAYER_SHELL_VERSION 5
 #define LOUVRE_FOREIGN_TOPLEVEL_MANAGER_VERSION 3
 #define LOUVRE_FOREIGN_TOPLEVEL_LIST_VERSION 1
@@ -124,6 +125,8 @@ namespace CZ
     class LClipboard;
     class LOutput;
     class LOutputMode;
+    struct LPlane;
+    struct LPlaneAssignment;
 
     // Roles
     class LBaseSurfaceRole;
@@ -144,6 +147,7 @@ namespace CZ
     class LShapeCursorSource;
     class LImageCursorSource;
     class LRoleCursorSource;
+    class LXCursorTheme;
 
     /// @brief 24 bits Wayland float
     typedef wl_fixed_t      Float24;
@@ -153,6 +157,7 @@ namespace CZ
     class LBackendOutput;
     class LDRMBackend;
     class LWaylandBackend;
+    class LWaylandOutput;
     class LOffscreenBackend;
 
     enum class LBackendId
@@ -299,6 +304,15 @@ namespace CZ
             class RImageCaptureSource;
         }
 
+        namespace ImageCopyCapture
+        {
+            class GImageCopyCaptureManager;
+
+            class RImageCopyCaptureSession;
+            class RImageCopyCaptureCursorSession;
+            class RImageCopyCaptureFrame;
+        }
+
         namespace PointerConstraints
         {
             class GPointerConstraints;
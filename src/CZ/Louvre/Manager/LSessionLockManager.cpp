@@ -51,6 +51,7 @@ void LSessionLockManager::forceUnlock()
     }
 
     m_state = Unlocked;
+    compositor()->imp()->toplevelsVisibilityChanged = true;
     stateChanged();
 }
 
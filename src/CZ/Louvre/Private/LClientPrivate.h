@@ -14,12 +14,14 @@ struct LClient::Params
 class LClient::LClientPrivate
 {
 public:
-    LClientPrivate(LClient *, wl_client *wlClient) noexcept :
+    LClientPrivate(LClient *lClient, wl_client *wlClient) noexcept :
+        lClient {lClient},
         client {wlClient}
     {}
 
     ~LClientPrivate() noexcept = default;
 
+    LClient *lClient;
     wl_client *client;
     EventHistory eventHistory;
     std::shared_ptr<LCursorSource> cursor;
@@ -56,6 +58,7 @@ public:
     std::vector<DRMLease::GDRMLeaseDevice*> drmLeaseDeviceGlobals;
     std::vector<ImageCaptureSource::GOutputImageCaptureSourceManager*> outputImageCaptureSourceManagerGlobals;
     std::vector<ImageCaptureSource::GForeignToplevelImageCaptureSourceManager*> foreignToplevelImageCaptureSourceManagerGlobals;
+    std::vector<ImageCopyCapture::GImageCopyCaptureManager*> imageCopyCaptureManagerGlobals;
     std::vector<WlrOutputManagement::GWlrOutputManager*> wlrOutputManagerGlobals;
     std::vector<BackgroundBlur::GBackgroundBlurManager*> backgroundBlurManagerGlobals;
     std::vector<CursorShape::GCursorShapeManager*> cursorShapeManagerGlobals;
@@ -65,6 +68,18 @@ public:
     std::vector<DRMSyncObj::GDRMSyncObjManager*> drmSyncObjManagerGlobals;
     std::vector<PrivateHandle::GPrivateHandleManager*> privateHandleManagerGlobals;
 
+    // See LClient::fdCount()
+    FdLimits fdLimits;
+    UInt32 fdCount { 0 };
+
+    // True if accounting count more fds would exceed the hard limit (nothing is notified)
+    bool exceedsFdLimit(UInt32 count) const noexcept;
+
+    /* If enforce is true and the hard limit would be exceeded, nothing is accounted,
+     * fdLimitExceeded(true) is invoked and false returned (the caller should post no_memory) */
+    bool acquireFds(UInt32 count, bool enforce) noexcept;
+    void releaseFds(UInt32 count) noexcept;
+
     bool pendingDestroyLater { false };
     bool destroyed { false };
 };
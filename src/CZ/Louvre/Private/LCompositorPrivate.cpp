@@ -8,10 +8,14 @@
 #include <CZ/Louvre/Private/LToplevelRolePrivate.h>
 #include <CZ/Louvre/Private/LPopupRolePrivate.h>
 #include <CZ/Louvre/Private/LFactory.h>
+#include <CZ/Louvre/Private/LProtocolRecorder.h>
+#include <CZ/Louvre/Private/LTracer.h>
 #include <CZ/Louvre/Manager/LActivationTokenManager.h>
 #include <CZ/Louvre/Manager/LSessionLockManager.h>
 #include <CZ/Louvre/Roles/LSessionLockRole.h>
 #include <CZ/Louvre/Roles/LBackgroundBlur.h>
+#include <CZ/Louvre/Roles/LSubsurfaceRole.h>
+#include <CZ/Louvre/Roles/LLayerRole.h>
 #include <CZ/Louvre/Seat/LClipboard.h>
 #include <CZ/Louvre/Seat/LKeyboard.h>
 #include <CZ/Louvre/Seat/LPointer.h>
@@ -31,10 +35,12 @@
 
 #include <dlfcn.h>
 #include <cassert>
+#include <cstring>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <csignal>
+#include <limits>
 
 #include <CZ/Louvre/Private/LFactory.h>
 
@@ -69,6 +75,10 @@ static void clientDisconnectedEvent(wl_listener *listener, void *data)
     while (!disconnectedClient->imp()->resources.empty())
         disconnectedClient->imp()->resources.back()->destroy();
 
+    // After its buffers recycled their images
+    if (compositor()->imp()->dmaImporter)
+        compositor()->imp()->dmaImporter->removeClient(disconnectedClient);
+
     CZVectorUtils::RemoveOneUnordered(compositor()->imp()->clients, disconnectedClient);
     delete disconnectedClient;
 }
@@ -207,17 +217,25 @@ void LCompositor::LCompositorPrivate::unitCompositor()
     while (!clients.empty())
         clients.back()->destroy();
 
+    dmaImporter.reset();
+    LTracer::Unit();
+    LProtocolRecorder::Unit();
     unitThreadData();
     unitBackend();
+    mainThreadTasks.clear();
     unitSeat();
     unitPosixSignals();
     unitWayland();
+    xCursorThemes.clear();
+    singlePixelImages.clear();
     cursor.reset();
     core->dispatch();
 
     if (ream)
         ream->clearGarbage();
 
+    restoreFdLimit();
+
     LLog(CZDebug, CZLN, "Compositor uninitialized");
     state = CompositorState::Uninitialized;
 }
@@ -301,6 +319,13 @@ void LCompositor::LCompositorPrivate::unlockPoll()
     core->unlockLoop();
 }
 
+void LCompositor::LCompositorPrivate::scheduleFlush() noexcept
+{
+    // The main thread flushes at the end of each dispatch()
+    if (std::this_thread::get_id() != threadId)
+        unlockPoll();
+}
+
 void LCompositor::LCompositorPrivate::sendPendingConfigurations()
 {
     for (LSurface *s : surfaces)
@@ -404,6 +429,13 @@ void LCompositor::LCompositorPrivate::unitPosixSignals() noexcept
 
 static int posixSignalHandler(int signal, void *)
 {
+    // Reserved by CZ_LOUVRE_TRACE_SIGNAL
+    if (signal == LTracer::ToggleSignal())
+    {
+        LTracer::Toggle();
+        return 0;
+    }
+
     compositor()->onPosixSignal(signal);
     return 0;
 }
@@ -489,24 +521,261 @@ void LCompositor::LCompositorPrivate::unitBackend()
 
 void LCompositor::LCompositorPrivate::dispatchPresentationTimeEvents() noexcept
 {
-    std::lock_guard<std::mutex> lock { presentationMutex };
-    for (auto *o : compositor()->outputs())
+    std::vector<std::pair<CZWeak<LOutput>, std::queue<CZPresentationEvent>>> events;
+
+    // Swapped out so that render threads are not blocked while the events are delivered
     {
-        while (!o->imp()->presentationEventQueue.empty())
+        std::lock_guard<std::mutex> lock { presentationMutex };
+
+        for (auto *o : compositor()->outputs())
+            if (!o->imp()->presentationEventQueue.empty())
+                events.emplace_back(o, std::exchange(o->imp()->presentationEventQueue, {}));
+    }
+
+    for (auto &[output, queue] : events)
+    {
+        while (output && !queue.empty())
         {
-            core->sendEvent(o->imp()->presentationEventQueue.front(), *o);
-            o->imp()->presentationEventQueue.pop();
+            core->sendEvent(queue.front(), *output.get());
+            queue.pop();
         }
     }
 }
 
+void LCompositor::LCompositorPrivate::raiseFdLimit() noexcept
+{
+    if (getrlimit(RLIMIT_NOFILE, &originalFdLimit) != 0)
+    {
+        LLog(CZWarning, CZLN, "Failed to get RLIMIT_NOFILE: {}", strerror(errno));
+        originalFdLimit = {};
+        return;
+    }
+
+    if (originalFdLimit.rlim_cur >= originalFdLimit.rlim_max)
+        return;
+
+    rlimit limit { originalFdLimit };
+    limit.rlim_cur = limit.rlim_max;
+
+    if (setrlimit(RLIMIT_NOFILE, &limit) != 0)
+        LLog(CZWarning, CZLN, "Failed to raise RLIMIT_NOFILE to {}: {}", limit.rlim_max, strerror(errno));
+    else
+        LLog(CZDebug, CZLN, "RLIMIT_NOFILE raised from {} to {}", originalFdLimit.rlim_cur, limit.rlim_cur);
+}
+
+void LCompositor::LCompositorPrivate::restoreFdLimit() noexcept
+{
+    // Not raised
+    if (originalFdLimit.rlim_max == 0 || originalFdLimit.rlim_cur >= originalFdLimit.rlim_max)
+        return;
+
+    setrlimit(RLIMIT_NOFILE, &originalFdLimit);
+}
+
+void LCompositor::LCompositorPrivate::postMainThreadTask(std::function<void()> &&task) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock { mainThreadTasksMutex };
+        mainThreadTasks.emplace_back(std::move(task));
+    }
+
+    unlockPoll();
+}
+
+void LCompositor::LCompositorPrivate::dispatchMainThreadTasks() noexcept
+{
+    std::vector<std::function<void()>> tasks;
+
+    {
+        std::lock_guard<std::mutex> lock { mainThreadTasksMutex };
+        tasks.swap(mainThreadTasks);
+    }
+
+    // Tasks may post new tasks
+    for (auto &task : tasks)
+        task();
+}
+
 void LCompositor::LCompositorPrivate::handleUnreleasedBuffers() noexcept
 {
     for (auto it = unreleasedBuffers.begin(); it != unreleasedBuffers.end();)
     {
-        if (it->release())
+        // Buffers waiting for a read fence are released by their event source
+        if (it->releaseSource ? it->released : it->release())
             it = unreleasedBuffers.erase(it);
         else
             it++;
     }
 }
+
+// Subtracts the opaque region of the surface from the uncovered area, returns true if visible
+static bool OccludeSurface(LSurface *s, SkRegion &uncovered) noexcept
+{
+    const SkIPoint pos { s->rolePos() };
+    const bool visible { uncovered.intersects(SkIRect::MakePtSize(pos, s->size())) };
+
+    if (visible && !s->opaqueRegion().isEmpty())
+    {
+        SkRegion opaque { s->opaqueRegion() };
+        opaque.translate(pos.x(), pos.y());
+        uncovered.op(opaque, SkRegion::kDifference_Op);
+    }
+
+    return visible;
+}
+
+static bool OccludeSubsurfaces(const std::vector<LSubsurfaceRole*> &subsurfaces, SkRegion &uncovered) noexcept
+{
+    bool visible { false };
+
+    for (auto it = subsurfaces.rbegin(); it != subsurfaces.rend(); it++)
+    {
+        LSurface *s { (*it)->surface() };
+
+        if (!s->mapped())
+            continue;
+
+        visible |= OccludeSubsurfaces(s->subsurfacesAbove(), uncovered);
+        visible |= OccludeSurface(s, uncovered);
+        visible |= OccludeSubsurfaces(s->subsurfacesBelow(), uncovered);
+    }
+
+    return visible;
+}
+
+static void OccludePopups(const std::list<LPopupRole*> &popups, SkRegion &uncovered, LToplevelRole *owner, std::unordered_set<LToplevelRole*> &visible) noexcept;
+
+// Same stacking as LSurfaceTree::ForEach() but from top to bottom
+static void OccludeTree(LSurface *s, SkRegion &uncovered, LToplevelRole *owner, std::unordered_set<LToplevelRole*> &visible) noexcept
+{
+    if (!s->mapped() || (s->toplevel() && s->toplevel()->isMinimized()))
+        return;
+
+    if (auto *toplevel = s->toplevel())
+    {
+        owner = toplevel;
+
+        for (auto it = toplevel->childToplevels().rbegin(); it != toplevel->childToplevels().rend(); it++)
+            OccludeTree((*it)->surface(), uncovered, owner, visible);
+
+        OccludePopups(toplevel->childPopups(), uncovered, owner, visible);
+    }
+    else if (auto *popup = s->popup())
+        OccludePopups(popup->childPopups(), uncovered, owner, visible);
+    else if (auto *layerRole = s->layerRole())
+        OccludePopups(layerRole->childPopups(), uncovered, owner, visible);
+
+    bool isVisible { OccludeSubsurfaces(s->subsurfacesAbove(), uncovered) };
+    isVisible |= OccludeSurface(s, uncovered);
+    isVisible |= OccludeSubsurfaces(s->subsurfacesBelow(), uncovered);
+
+    // Popups keep their toplevel visible
+    if (isVisible && owner)
+        visible.emplace(owner);
+}
+
+static void OccludePopups(const std::list<LPopupRole*> &popups, SkRegion &uncovered, LToplevelRole *owner, std::unordered_set<LToplevelRole*> &visible) noexcept
+{
+    for (auto it = popups.rbegin(); it != popups.rend(); it++)
+        OccludeTree((*it)->surface(), uncovered, owner, visible);
+}
+
+void LCompositor::LCompositorPrivate::updateOutputsContent() noexcept
+{
+    for (LOutput *o : outputs)
+    {
+        if (!o->imp()->stateFlags.has(LOutput::LOutputPrivate::PendingContentUpdate))
+            continue;
+
+        o->imp()->stateFlags.remove(LOutput::LOutputPrivate::PendingContentUpdate);
+        o->updateContentPolicy();
+
+        if (o->hasVRR())
+            o->updateVRRPolicy();
+    }
+}
+
+void LCompositor::LCompositorPrivate::updateToplevelsVisibility() noexcept
+{
+    if (!toplevelAutoSuspend || !toplevelsVisibilityChanged)
+        return;
+
+    toplevelsVisibilityChanged = false;
+
+    // Area not yet covered by opaque regions, everything is hidden while the session is locked
+    SkRegion uncovered;
+
+    if (sessionLockManager->state() == LSessionLockManager::Unlocked)
+        for (LOutput *o : outputs)
+            uncovered.op(o->rect(), SkRegion::kUnion_Op);
+
+    std::unordered_set<LToplevelRole*> visible;
+
+    for (auto layer = layers.rbegin(); layer != layers.rend() && !uncovered.isEmpty(); layer++)
+    {
+        for (auto it = layer->rbegin(); it != layer->rend() && !uncovered.isEmpty(); it++)
+        {
+            LSurface *s { *it };
+
+            // Child surfaces are handled by OccludeTree
+            if (s->parent() || s->cursorRole())
+                continue;
+
+            OccludeTree(s, uncovered, nullptr, visible);
+        }
+    }
+
+    const UInt64 now { CZTime::Ms() };
+    UInt64 nextCheckMs { std::numeric_limits<UInt64>::max() };
+
+    // Clients with at least one mapped toplevel, true if all are suspended
+    std::unordered_map<LClient*, bool> clientsSuspended;
+
+    for (LSurface *s : surfaces)
+    {
+        auto *toplevel { s->toplevel() };
+
+        if (!toplevel || !s->mapped())
+            continue;
+
+        // Captured toplevels must keep updating
+        const bool hidden { !visible.contains(toplevel) && toplevel->m_imageCopyCaptureSessions.empty() };
+        toplevel->setHidden(hidden, now, &nextCheckMs);
+
+        auto [client, inserted] { clientsSuspended.try_emplace(s->client(), true) };
+        client->second = client->second && toplevel->isAutoSuspended();
+    }
+
+    UInt32 count { 0 };
+
+    for (const auto &client : clientsSuspended)
+        count += client.second;
+
+    if (count != suspendedClientsCount)
+    {
+        LLog(CZDebug, CZLN, "Suspended clients: {}", count);
+        suspendedClientsCount = count;
+    }
+
+    toplevelAutoSuspendTimer.stop(false);
+
+    if (nextCheckMs != std::numeric_limits<UInt64>::max())
+    {
+        toplevelAutoSuspendTimer.setCallback([this](auto)
+        {
+            toplevelsVisibilityChanged = true;
+        });
+
+        toplevelAutoSuspendTimer.start(nextCheckMs);
+    }
+}
+
+void LCompositor::LCompositorPrivate::resumeAutoSuspendedToplevels() noexcept
+{
+    toplevelAutoSuspendTimer.stop(false);
+    suspendedClientsCount = 0;
+
+    for (LSurface *s : surfaces)
+        if (s->toplevel())
+            s->toplevel()->setHidden(false, 0, nullptr);
+}
@@ -4,16 +4,21 @@
 #include <CZ/Louvre/LCompositor.h>
 #include <CZ/Louvre/Seat/LOutput.h>
 #include <CZ/Louvre/Roles/LSurface.h>
+#include <CZ/Louvre/Events/LSurfaceCommitEvent.h>
+#include <CZ/Louvre/Private/LDMAImporter.h>
 
 #include <CZ/Core/CZEventSource.h>
+#include <CZ/Core/CZTimer.h>
 #include <CZ/Core/CZWeak.h>
 
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include <sys/epoll.h>
+#include <sys/resource.h>
 #include <unordered_map>
 #include <unistd.h>
 #include <filesystem>
+#include <functional>
 #include <set>
 #include <unordered_set>
 
@@ -52,6 +57,9 @@ LPRIVATE_CLASS(LCompositor)
     void unlockPoll();
     std::thread::id threadId;
 
+    // Wakes dispatch() if called from another thread, so that events queued after a paintGL() flush are sent
+    void scheduleFlush() noexcept;
+
     bool loadGraphicBackend(const std::filesystem::path &path);
     bool loadInputBackend(const std::filesystem::path &path);
 
@@ -72,9 +80,36 @@ LPRIVATE_CLASS(LCompositor)
     ThreadData &initThreadData(LOutput *output = nullptr) noexcept;
     void unitThreadData() noexcept;
 
+    // Shared by LXCursorTheme::Get()
+    std::unordered_map<std::string, std::shared_ptr<LXCursorTheme>> xCursorThemes;
+
+    // Single pixel buffer images by ARGB8888 value, expired entries are pruned once the size doubles
+    std::unordered_map<UInt32, std::weak_ptr<RImage>> singlePixelImages;
+    size_t singlePixelImagesPruneSize { 64 };
+
+    // Used by zwp_linux_buffer_params_v1, destroyed before the backend
+    std::unique_ptr<LDMAImporter> dmaImporter;
+
+    // Synced subsurface commits released by a parent commit, applied in a single pass by LSurfacePrivate::applyCommit()
+    struct SubsurfaceTransaction
+    {
+        std::vector<std::shared_ptr<LSurfaceLock>> locks;
+
+        // Commit events are sent once the whole tree is applied, in reverse order (children first)
+        std::vector<std::pair<CZWeak<LSurface>, CZBitset<LSurfaceCommitEvent::Changes>>> events;
+        UInt32 applied { 0 }; // Subsurface states applied
+        bool active { false };
+    } subsurfaceTransaction;
+
     std::mutex presentationMutex;
     void dispatchPresentationTimeEvents() noexcept;
 
+    // Tasks posted from worker threads, run by the main thread within dispatch()
+    std::mutex mainThreadTasksMutex;
+    std::vector<std::function<void()>> mainThreadTasks;
+    void postMainThreadTask(std::function<void()> &&task) noexcept; // Thread safe
+    void dispatchMainThreadTasks() noexcept;
+
     // Posix signals
     std::unordered_set<int> posixSignals;
     std::unordered_map<int, wl_event_source*> posixSignalSources;
@@ -83,6 +118,12 @@ LPRIVATE_CLASS(LCompositor)
     void handlePosixSignalChanges() noexcept; // Called from the main thread
     void unitPosixSignals() noexcept;
 
+    /* Raised to the hard limit while running so that clients can't easily push
+     * the compositor to EMFILE, see LClient::fdLimits() */
+    rlimit originalFdLimit {};
+    void raiseFdLimit() noexcept;
+    void restoreFdLimit() noexcept;
+
     void sendPendingConfigurations();
 
     void handleDestroyedClients();
@@ -90,6 +131,18 @@ LPRIVATE_CLASS(LCompositor)
 
     void handleUnreleasedBuffers() noexcept;
     std::list<LSurfaceBuffer> unreleasedBuffers;
+
+    // Toplevel auto suspension, see LToplevelRole::isAutoSuspended()
+    void updateToplevelsVisibility() noexcept;
+
+    // Calls LOutput::updateContentPolicy() and updateVRRPolicy() on outputs flagged with PendingContentUpdate
+    void updateOutputsContent() noexcept;
+    void resumeAutoSuspendedToplevels() noexcept;
+    bool toplevelAutoSuspend { false };
+    bool toplevelsVisibilityChanged { false }; // Set when the stacking, mapping or geometry of surfaces or outputs change
+    UInt32 toplevelAutoSuspendDelay { 1000 };
+    UInt32 suspendedClientsCount { 0 };
+    CZTimer toplevelAutoSuspendTimer;
 };
 
 #endif // LCOMPOSITORPRIVATE_H
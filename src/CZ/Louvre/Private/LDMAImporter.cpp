@@ -0,0 +1,245 @@
+#include <CZ/Louvre/Private/LCompositorPrivate.h>
+#include <CZ/Louvre/Private/LDMAImporter.h>
+#include <CZ/Louvre/LLog.h>
+#include <CZ/Ream/RCore.h>
+#include <CZ/Ream/RDevice.h>
+#include <unordered_set>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <unistd.h>
+
+using namespace CZ;
+
+// Enough to hide the import latency without competing with the rendering threads
+static constexpr size_t WorkersCount { 2 };
+
+LDMAImporter::LDMAImporter(ImportFunc &&importFunc) noexcept : m_import(std::move(importFunc)) {}
+
+LDMAImporter::~LDMAImporter() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_finish = true;
+    }
+
+    m_cond.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+
+    // Never imported, the fds are still ours
+    while (!m_pending.empty())
+    {
+        std::unordered_set<int> fds;
+
+        for (int i = 0; i < m_pending.front()->info.planeCount; i++)
+            if (m_pending.front()->info.fd[i] >= 0)
+                fds.emplace(m_pending.front()->info.fd[i]);
+
+        for (int fd : fds)
+            close(fd);
+
+        m_pending.pop();
+    }
+
+    m_done.clear();
+}
+
+size_t LDMAImporter::KeyHash::operator()(const Key &key) const noexcept
+{
+    size_t hash { std::hash<UInt64>{}(key.plane.ino) };
+    hash ^= std::hash<const void*>{}(key.client) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<UInt64>{}(key.plane.dev) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<UInt64>{}((UInt64(key.offset) << 32) ^ key.modifier) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+bool LDMAImporter::GetPlanes(const RDMABufferInfo &info, std::array<PlaneId, 4> &planes) noexcept
+{
+    struct stat st;
+
+    for (int i = 0; i < info.planeCount; i++)
+    {
+        if (fstat(info.fd[i], &st) != 0)
+            return false;
+
+        planes[i].dev = st.st_dev;
+        planes[i].ino = st.st_ino;
+    }
+
+    return true;
+}
+
+std::shared_ptr<RImage> LDMAImporter::find(LClient *client, RDMABufferInfo &info) noexcept
+{
+    std::array<PlaneId, 4> planes {};
+
+    if (info.planeCount <= 0 || !GetPlanes(info, planes))
+        return {};
+
+    const auto it { m_cache.find({ client, planes[0], info.offset[0], info.modifier }) };
+
+    if (it == m_cache.end())
+        return {};
+
+    auto image { it->second.image.lock() };
+
+    if (!image)
+    {
+        m_cache.erase(it);
+        return {};
+    }
+
+    const auto &cached { it->second.info };
+
+    if (cached.width != info.width ||
+        cached.height != info.height ||
+        cached.format != info.format ||
+        cached.planeCount != info.planeCount)
+        return {};
+
+    for (int i = 0; i < info.planeCount; i++)
+        if (cached.offset[i] != info.offset[i] ||
+            cached.stride[i] != info.stride[i] ||
+            it->second.planes[i] != planes[i])
+            return {};
+
+    info = cached;
+
+    // Owned by the new buffer until it's destroyed and recycled again
+    m_cache.erase(it);
+
+    for (auto &recent : m_recent)
+        if (recent == image)
+            recent.reset();
+
+    return image;
+}
+
+void LDMAImporter::recycle(LClient *client, const RDMABufferInfo &info, std::shared_ptr<RImage> &&image) noexcept
+{
+    if (!image)
+        return;
+
+    Entry entry { image, info, {} };
+
+    // The image owns the fds, they remain valid while it is alive
+    if (!GetPlanes(info, entry.planes))
+        return;
+
+    if (m_cache.size() >= m_cachePruneSize)
+    {
+        std::erase_if(m_cache, [](const auto &pair) { return pair.second.image.expired(); });
+
+        if (m_cache.size() >= m_cachePruneSize / 2)
+            m_cachePruneSize *= 2;
+    }
+
+    m_cache.insert_or_assign({ client, entry.planes[0], info.offset[0], info.modifier }, std::move(entry));
+    m_recent[m_recentIndex++ % m_recent.size()] = std::move(image);
+}
+
+void LDMAImporter::removeClient(LClient *client) noexcept
+{
+    std::erase_if(m_cache, [this, client](const auto &pair) {
+        if (pair.first.client != client)
+            return false;
+
+        if (const auto image { pair.second.image.lock() })
+            for (auto &recent : m_recent)
+                if (recent == image)
+                    recent.reset();
+
+        return true;
+    });
+}
+
+std::shared_ptr<RImage> LDMAImporter::import(const RDMABufferInfo &info) noexcept
+{
+    return m_import(info);
+}
+
+void LDMAImporter::importAsync(const RDMABufferInfo &info, Callback &&callback) noexcept
+{
+    auto job { std::make_shared<Job>() };
+    job->info = info;
+    job->callback = std::move(callback);
+
+    if (m_workers.empty())
+        startWorkers();
+
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        m_pending.emplace(job);
+    }
+
+    m_cond.notify_one();
+}
+
+void LDMAImporter::dispatch() noexcept
+{
+    std::vector<std::shared_ptr<Job>> done;
+
+    {
+        std::lock_guard<std::mutex> lock { m_mutex };
+        done.swap(m_done);
+    }
+
+    for (auto &job : done)
+    {
+        if (job->callback)
+            job->callback(std::move(job->image));
+    }
+}
+
+std::shared_ptr<RImage> LDMAImporter::Import(const RDMABufferInfo &info) noexcept
+{
+    auto ream { RCore::Get() };
+
+    if (!ream)
+        return {};
+
+    RImageConstraints cons {};
+    cons.allocator = ream->mainDevice();
+    cons.caps[ream->mainDevice()] = RImageCap_Src; // At least the main device should be able to sample from it
+    return RImage::FromDMA(info, CZOwn::Own, &cons);
+}
+
+void LDMAImporter::startWorkers() noexcept
+{
+    for (size_t i = 0; i < WorkersCount; i++)
+        m_workers.emplace_back([this]{ work(); });
+}
+
+void LDMAImporter::work() noexcept
+{
+    pthread_setname_np(pthread_self(), "LDMAImporter");
+
+    while (true)
+    {
+        std::shared_ptr<Job> job;
+
+        {
+            std::unique_lock<std::mutex> lock { m_mutex };
+            m_cond.wait(lock, [this]{ return m_finish || !m_pending.empty(); });
+
+            if (m_finish)
+                return;
+
+            job = m_pending.front();
+            m_pending.pop();
+        }
+
+        job->image = m_import(job->info);
+
+        {
+            std::lock_guard<std::mutex> lock { m_mutex };
+            m_done.emplace_back(std::move(job));
+        }
+
+        compositor()->imp()->postMainThreadTask([]{
+            if (compositor()->imp()->dmaImporter)
+                compositor()->imp()->dmaImporter->dispatch();
+        });
+    }
+}
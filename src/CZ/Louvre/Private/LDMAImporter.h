@@ -0,0 +1,119 @@
+#ifndef CZ_LDMAIMPORTER_H
+#define CZ_LDMAIMPORTER_H
+
+#include <CZ/Louvre/Louvre.h>
+#include <CZ/Ream/RDMABufferInfo.h>
+#include <CZ/Ream/RImage.h>
+#include <condition_variable>
+#include <unordered_map>
+#include <functional>
+#include <sys/types.h>
+#include <thread>
+#include <array>
+#include <mutex>
+#include <queue>
+
+/* DMA-BUF importer used by zwp_linux_buffer_params_v1
+ *
+ * Imports can take milliseconds (EGLImage/Vulkan import of multi-planar buffers), so non-immediate
+ * create requests are imported by a small pool of worker threads and their callbacks invoked from the
+ * main thread once done.
+ *
+ * Once a wl_buffer is destroyed its image is memoized by the (client, dev, inode, offset, modifier) of the
+ * first plane, so buffers re-submitted by the same client (e.g. recreated wl_buffers) reuse it. Images are
+ * never shared between clients nor between live wl_buffers, each LDMABuffer keeps its own image and sync
+ * state. Only the few most recent images are kept alive, and all of a client's are dropped on disconnect. */
+
+namespace CZ
+{
+    class LDMAImporter
+    {
+    public:
+        using Callback = std::function<void(std::shared_ptr<RImage>)>;
+
+        // Must take ownership of the fds, called from worker threads too (e.g. replaced by a fake importer)
+        using ImportFunc = std::function<std::shared_ptr<RImage>(const RDMABufferInfo &info)>;
+
+        LDMAImporter(ImportFunc &&importFunc = &Import) noexcept;
+        ~LDMAImporter() noexcept;
+
+        /* Returns a cached image of a destroyed buffer of the same client, or nullptr if none.
+         * On hit, info is replaced by the one of the cached image (whose fds are owned by it),
+         * the caller is responsible for closing its own fds */
+        std::shared_ptr<RImage> find(LClient *client, RDMABufferInfo &info) noexcept;
+
+        // Memoizes the image of a destroyed buffer
+        void recycle(LClient *client, const RDMABufferInfo &info, std::shared_ptr<RImage> &&image) noexcept;
+
+        // Drops the images of a disconnected client
+        void removeClient(LClient *client) noexcept;
+
+        // Blocking import, takes ownership of the fds
+        std::shared_ptr<RImage> import(const RDMABufferInfo &info) noexcept;
+
+        // Takes ownership of the fds, the callback is invoked from the main thread (nullptr on failure)
+        void importAsync(const RDMABufferInfo &info, Callback &&callback) noexcept;
+
+        // Invokes the callbacks of finished imports, main thread only
+        void dispatch() noexcept;
+
+    private:
+        struct PlaneId
+        {
+            dev_t dev { 0 };
+            ino_t ino { 0 };
+            bool operator==(const PlaneId &) const = default;
+        };
+
+        struct Key
+        {
+            LClient *client;
+            PlaneId plane;
+            UInt32 offset;
+            RModifier modifier;
+            bool operator==(const Key &) const = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &key) const noexcept;
+        };
+
+        struct Entry
+        {
+            std::weak_ptr<RImage> image;
+            RDMABufferInfo info;
+            std::array<PlaneId, 4> planes;
+        };
+
+        struct Job
+        {
+            RDMABufferInfo info;
+            std::shared_ptr<RImage> image;
+            Callback callback;
+        };
+
+        static std::shared_ptr<RImage> Import(const RDMABufferInfo &info) noexcept;
+        static bool GetPlanes(const RDMABufferInfo &info, std::array<PlaneId, 4> &planes) noexcept;
+        void startWorkers() noexcept;
+        void work() noexcept;
+
+        const ImportFunc m_import;
+
+        // Only touched by the main thread
+        std::unordered_map<Key, Entry, KeyHash> m_cache;
+        size_t m_cachePruneSize { 64 };
+        std::array<std::shared_ptr<RImage>, 4> m_recent;
+        size_t m_recentIndex { 0 };
+
+        // Shared with the workers
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        std::queue<std::shared_ptr<Job>> m_pending;
+        std::vector<std::shared_ptr<Job>> m_done;
+        bool m_finish { false };
+        std::vector<std::thread> m_workers;
+    };
+}
+
+#endif // CZ_LDMAIMPORTER_H
@@ -1,11 +1,15 @@
 #include <CZ/Louvre/Protocols/Wayland/GOutput.h>
 #include <CZ/Louvre/Protocols/SessionLock/RSessionLock.h>
 #include <CZ/Louvre/Protocols/PresentationTime/RPresentationFeedback.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
+#include <CZ/Louvre/Protocols/WlrOutputManagement/RWlrOutputHead.h>
+#include <CZ/Louvre/Protocols/WlrOutputManagement/RWlrOutputMode.h>
 #include <CZ/Louvre/Private/LOutputPrivate.h>
 #include <CZ/Louvre/Private/LCompositorPrivate.h>
 #include <CZ/Louvre/Private/LSurfacePrivate.h>
 #include <CZ/Louvre/Private/LClientPrivate.h>
 #include <CZ/Louvre/Private/LLockGuard.h>
+#include <CZ/Louvre/Private/LTracer.h>
 #include <CZ/Louvre/Backends/LBackend.h>
 #include <CZ/Louvre/Manager/LSessionLockManager.h>
 #include <CZ/Louvre/Roles/LSessionLockRole.h>
@@ -17,6 +21,8 @@
 #include <CZ/Louvre/Cursor/LCursor.h>
 #include <CZ/Core/CZTime.h>
 #include <CZ/Core/CZCore.h>
+#include <cassert>
+#include <atomic>
 
 #include <CZ/Ream/RCore.h>
 #include <CZ/Core/Utils/CZRegionUtils.h>
@@ -44,6 +50,7 @@ void LOutput::LOutputPrivate::backendInitializeGL()
 
     output->initializeGL();
     compositor()->flushClients();
+    initializedMs = CZTime::Ms();
     initPromise.set_value(true);
 }
 
@@ -54,40 +61,90 @@ void LOutput::LOutputPrivate::backendPaintGL()
     if (output->imp()->state != LOutput::Initialized)
         return;
 
+    LTRACE_SCOPE("backendPaintGL", output);
     compositor()->imp()->dispatchPresentationTimeEvents();
     compositor()->imp()->disablePendingPosixSignals();
 
+    bool sceneChanged { !stateFlags.has(CursorOnlyRepaint) };
     stateFlags.remove(PendingRepaint);
+    stateFlags.remove(CursorOnlyRepaint);
 
     if (lastPos != rect.topLeft())
     {
         output->moveGL();
         lastPos = rect.topLeft();
+        sceneChanged = true;
     }
 
     if (lastSize != rect.size())
     {
         output->resizeGL();
         lastSize = rect.size();
+        sceneChanged = true;
     }
 
     // Update active LAnimations
     compositor()->imp()->core->updateAnimations();
 
+    // Animations request a repaint each time they update the scene
+    if (stateFlags.has(PendingRepaint))
+        sceneChanged = true;
+
+    updatePlaneAssignments();
+
     compositor()->imp()->currentOutput = output;
 
     /* Mark the entire output rect as damaged for compositors
      * that do not track damage.*/
     output->damage.setRect(SkIRect::MakeSize(output->size()));
 
+    resizeOSSurface();
+
+    // Only the cursor moved or changed, skip paintGL()
+    if (!sceneChanged && paintCursorOnly())
+    {
+        compositor()->imp()->currentOutput = nullptr;
+        stateFlags.add(IsBlittingFramebuffers);
+
+        {
+            LTRACE_SCOPE("blitFramebuffers", output);
+            damageToBufferCoords();
+            blitFramebuffers(true);
+        }
+
+        stateFlags.remove(IsBlittingFramebuffers);
+        RCore::Get()->clearGarbage();
+        return;
+    }
+
+    if (sceneChanged)
+        sceneSerial++;
+
+    // Leave only the scene in the image, paintGL() may not repaint the cursor rect
+    if (auto *backing { findCursorBacking(output->image()) })
+    {
+        if (output->imageAge() != 0)
+            restoreCursorBacking(*backing);
+
+        backing->sceneSerial = 0;
+    }
+
     const bool needsFullRepaintPrev { stateFlags.has(NeedsFullRepaint) };
 
     /* Let users do their rendering*/
     stateFlags.add(IsInPaintGL);
-    resizeOSSurface();
-    output->paintGL();
+    stateFlags.remove(CursorPainted);
+
+    {
+        LTRACE_SCOPE("paintGL", output);
+        output->paintGL();
+    }
+
     stateFlags.remove(IsInPaintGL);
 
+    if (!stateFlags.has(CursorPainted))
+        cursorRect.setEmpty();
+
     handleUnpresentedSurfaces();
 
     stateFlags.setFlag(NeedsFullRepaint, needsFullRepaintPrev);
@@ -103,8 +160,13 @@ void LOutput::LOutputPrivate::backendPaintGL()
      * blitting if oversampling is enabled or there are
      * screen copy requests*/
     stateFlags.add(IsBlittingFramebuffers);
-    damageToBufferCoords();
-    blitFramebuffers();
+
+    {
+        LTRACE_SCOPE("blitFramebuffers", output);
+        damageToBufferCoords();
+        blitFramebuffers(false);
+    }
+
     stateFlags.remove(IsBlittingFramebuffers);
 
     /* Ensure clients receive frame callbacks and pending roles configurations on time */
@@ -145,6 +207,14 @@ void LOutput::LOutputPrivate::backendUninitializeGL()
 
     output->uninitializeGL();
     removeFromSessionLockPendingRepaint();
+    planeAssignments.clear();
+    output->backend()->setPlanes(planeAssignments);
+    cursorImageKeys.clear();
+    cursorBackings.clear();
+    cursorRect.setEmpty();
+
+    while (!imageCopyCaptureSessions.empty())
+        imageCopyCaptureSessions.back()->stop();
 
     compositor()->flushClients();
     output->imp()->state = LOutput::Uninitialized;
@@ -171,6 +241,83 @@ void LOutput::LOutputPrivate::backendDiscarded(UInt64 paintEventId) noexcept
     presentationEventQueue.emplace(e);
 }
 
+std::vector<CZWeak<Protocols::PresentationTime::RPresentationFeedback>> &LOutput::LOutputPrivate::presentationBucket(UInt64 paintEventId) noexcept
+{
+    auto &bucket { presentationBuckets[paintEventId % presentationBuckets.size()] };
+
+    if (bucket.paintEventId != paintEventId)
+    {
+        // Never presented nor discarded
+        for (auto &feedback : bucket.feedback)
+            if (feedback)
+                feedback->discarded();
+
+        bucket.feedback.clear();
+        bucket.paintEventId = paintEventId;
+    }
+
+    return bucket.feedback;
+}
+
+// Paints the cursor image within LCursor::rect() with the output geometry
+static void DrawCursor(LOutput *output, const std::shared_ptr<RImage> &target, const std::shared_ptr<RImage> &image) noexcept
+{
+    auto surface { RSurface::WrapImage(target) };
+
+    if (!surface)
+        return;
+
+    surface->setGeometry({
+        .viewport = SkRect::Make(output->rect()),
+        .dst = SkRect::Make(target->size()),
+        .transform = output->transform()});
+
+    auto pass { surface->beginPass(RPassCap_Painter) };
+
+    if (!pass)
+        return;
+
+    RDrawImageInfo info {};
+    info.image = image;
+    info.src = SkRect::Make(info.image->size());
+    info.dst = cursor()->rect();
+    info.srcScale = 1.f;
+    info.srcTransform = CZTransform::Normal;
+    info.magFilter = RImageFilter::Linear;
+    info.minFilter = RImageFilter::Linear;
+    pass->getPainter()->drawImage(info);
+}
+
+// Plain pixel copy, both rects in buffer coords
+static bool CopyImageRect(const std::shared_ptr<RImage> &src, const SkIRect &srcRect, const std::shared_ptr<RImage> &dst, SkIPoint dstPos) noexcept
+{
+    auto surface { RSurface::WrapImage(dst) };
+
+    if (!surface)
+        return false;
+
+    surface->setGeometry({
+        .viewport = SkRect::Make(dst->size()),
+        .dst = SkRect::Make(dst->size()),
+        .transform = CZTransform::Normal});
+
+    auto pass { surface->beginPass(RPassCap_Painter) };
+
+    if (!pass)
+        return false;
+
+    auto *p { pass->getPainter() };
+    p->setBlendMode(RBlendMode::Src);
+    RDrawImageInfo info {};
+    info.image = src;
+    info.src = SkRect::Make(srcRect);
+    info.dst = SkIRect::MakePtSize(dstPos, srcRect.size());
+    info.srcScale = 1.f;
+    info.srcTransform = CZTransform::Normal;
+    p->drawImage(info);
+    return true;
+}
+
 void LOutput::LOutputPrivate::damageToBufferCoords() noexcept
 {
     CZRegionUtils::ApplyTransform(output->damage, rect.size(), transform);
@@ -194,54 +341,328 @@ void LOutput::LOutputPrivate::damageToBufferCoords() noexcept
     output->backend()->setDamage(output->damage);
 }
 
-void LOutput::LOutputPrivate::blitFractionalScaleFb(bool /*cursorOnly*/) noexcept
-{
-
-    /* TODO
-    stateFlags.remove(UsingFractionalScale);
-    const CZTransform prevTrasform { transform };
-    transform = CZTransform::Normal;
-    const Float32 prevScale { scale };
-    const Float32 prevFracScale { fractionalScale };
-    scale = 1.f;
-    const SkIPoint prevPos { rect.topLeft() };
-    const SkISize prevSize { rect.size() };
-    rect.offsetTo(0, 0);
-    updateRect();
-    painter->bindFramebuffer(&fb);
-    painter->enableCustomTextureColor(false);
-    painter->enableAutoBlendFunc(true);
-    painter->setAlpha(1.f);
-    painter->setColorFactor(1.f, 1.f, 1.f, 1.f);
-    fractionalFb.setFence();
-    painter->bindTextureMode({
-        .texture = fractionalFb.texture(0),
-        .pos = rect.topLeft(),
-        .srcRect = SkRect::MakeWH(fractionalFb.sizeB().width(), fractionalFb.sizeB().height()),
-        .dstSize = rect.size(),
-        .srcTransform = CZTransform::Normal,
-        .srcScale = 1.f
-    });
+void LOutput::LOutputPrivate::blitFractionalScaleFb(bool cursorOnly) noexcept
+{
+    auto src { output->osImage() };
+    auto dst { output->backendImage() };
+
+    if (!src || !dst)
+        return;
+
+    /* The backend image was last blitted age - 1 frames ago, so only the damage
+     * of those frames plus the current one needs to be resampled. The previous cursor
+     * rects are part of that damage, see paintCursor() */
+    const UInt32 age { stateFlags.has(OSSurfaceReset) || stateFlags.has(NeedsFullRepaint) ? 0 : output->backend()->imageAge() };
+    const SkIRect fullRect { SkIRect::MakeSize(dst->size()) };
+    SkRegion region { output->damage };
+
+    if (age == 0 || age > osDamageHistory.size() + 1)
+        region.setRect(fullRect);
+    else
+        for (UInt32 i = 0; i < age - 1; i++)
+            region.op(osDamageHistory[i], SkRegion::kUnion_Op);
+
+    for (size_t i = osDamageHistory.size() - 1; i > 0; i--)
+        osDamageHistory[i] = osDamageHistory[i - 1];
+
+    osDamageHistory[0] = output->damage;
+    stateFlags.remove(OSSurfaceReset);
+
+    if (!region.op(fullRect, SkRegion::kIntersect_Op))
+        return;
 
+    auto surface { RSurface::WrapImage(dst) };
+    surface->setGeometry({
+        .viewport = SkRect::Make(fullRect),
+        .dst = SkRect::Make(fullRect),
+        .transform = CZTransform::Normal});
 
-    if (cursorOnly)
+    auto pass { surface->beginPass(RPassCap_Painter) };
+
+    if (!pass)
+        return;
+
+    // The oversampled image is already transformed, this is a plain downscale
+    auto *p { pass->getPainter() };
+    p->setBlendMode(RBlendMode::Src);
+    RDrawImageInfo info {};
+    info.image = src;
+    info.src = SkRect::Make(src->size());
+    info.dst = fullRect;
+    info.srcScale = 1.f;
+    info.srcTransform = CZTransform::Normal;
+    info.magFilter = RImageFilter::Linear;
+    info.minFilter = RImageFilter::Linear;
+    p->drawImage(info, &region);
+    pass.reset();
+
+    /* The cursor is painted at the backend resolution and never into the oversampled image,
+     * which is left untouched if only the cursor changed, see paintCursorOnly() */
+    if ((cursorOnly || stateFlags.has(CursorPainted)) && !cursorRect.isEmpty())
+        DrawCursor(output, dst, cursor()->m_image);
+}
+
+void LOutput::LOutputPrivate::blitFramebuffers(bool cursorOnly) noexcept
+{
+    if (osSurface && stateFlags.hasAll(UsingFractionalScale | OversamplingEnabled))
+        blitFractionalScaleFb(cursorOnly);
+
+    // After the downsample so that captures see the final image
+    if (!imageCopyCaptureSessions.empty())
+        Protocols::ImageCopyCapture::RImageCopyCaptureSession::HandleOutputPaint(output);
+}
+
+void LOutput::LOutputPrivate::repaintCursor() noexcept
+{
+    // Something else already requested a paintGL()
+    const bool sceneChanged { stateFlags.has(PendingRepaint) && !stateFlags.has(CursorOnlyRepaint) };
+
+    output->repaint();
+
+    if (!sceneChanged && stateFlags.has(PendingRepaint))
+        stateFlags.add(CursorOnlyRepaint);
+}
+
+bool LOutput::LOutputPrivate::paintCursorOnly() noexcept
+{
+    // The last paintGL() may paint its own cursor, and planes depend on the cursor rect
+    if (!stateFlags.has(CursorPainted) || passthroughSurface || !planeAssignments.empty() || output->imageAge() == 0)
+        return false;
+
+    if (!stateFlags.hasAll(UsingFractionalScale | OversamplingEnabled))
     {
-        //painter->drawRegion(cursorDamage);
+        auto *backing { findCursorBacking(output->image()) };
+
+        // The image contains an older scene, or the pixels under the cursor couldn't be saved
+        if (!backing || backing->sceneSerial != sceneSerial)
+            return false;
+
+        restoreCursorBacking(*backing);
     }
-    //else
-    //    painter->drawRegion(damage);
 
-    stateFlags.add(UsingFractionalScale);
-    transform = prevTrasform;
-    scale = prevScale;
-    rect.offsetTo(prevPos.x(), prevPos.y());
-    updateRect();
-    */
+    output->damage.setEmpty();
+    paintCursor();
+    return true;
 }
 
-void LOutput::LOutputPrivate::blitFramebuffers() noexcept
+void LOutput::LOutputPrivate::paintCursor() noexcept
 {
+    stateFlags.add(CursorPainted);
+
+    // Both the previous and new rects must be updated
+    output->damage.op(cursorRect, SkRegion::kUnion_Op);
+    cursorRect.setEmpty();
 
+    if (cursor()->isVisible() && !cursor()->isPlaneEnabled(output) && cursor()->m_image)
+    {
+        SkIRect localRect { cursor()->rect() };
+
+        if (localRect.intersect(rect))
+        {
+            localRect.offset(-rect.x(), -rect.y());
+            cursorRect = localRect;
+            output->damage.op(cursorRect, SkRegion::kUnion_Op);
+        }
+    }
+
+    // Painted after the downscale, see blitFractionalScaleFb()
+    if (stateFlags.hasAll(UsingFractionalScale | OversamplingEnabled))
+        return;
+
+    auto target { output->image() };
+
+    if (!target)
+        return;
+
+    auto *backing { findCursorBacking(target) };
+
+    if (!backing)
+    {
+        // Prune those of destroyed images (e.g. after a modeset)
+        std::erase_if(cursorBackings, [](const auto &b) { return b.target.expired(); });
+        backing = &cursorBackings.emplace_back();
+        backing->target = target;
+    }
+
+    backing->sceneSerial = 0;
+    backing->rect.setEmpty();
+
+    if (cursorRect.isEmpty())
+    {
+        backing->sceneSerial = sceneSerial;
+        return;
+    }
+
+    const SkIRect bufferRect { cursorRectToBuffer(cursorRect, target->size()) };
+
+    if (bufferRect.isEmpty())
+        return;
+
+    if (!backing->saved ||
+        backing->saved->image()->size().width() < bufferRect.width() ||
+        backing->saved->image()->size().height() < bufferRect.height())
+        backing->saved = RSurface::Make(bufferRect.size(), 1.f, false);
+
+    // Without a copy of the pixels below, the next cursor-only frames call paintGL()
+    if (backing->saved && target->checkDeviceCaps(RImageCap_Src, RCore::Get()->mainDevice()).get() == RImageCap_Src &&
+        CopyImageRect(target, bufferRect, backing->saved->image(), SkIPoint::Make(0, 0)))
+    {
+        backing->rect = bufferRect;
+        backing->sceneSerial = sceneSerial;
+    }
+
+    DrawCursor(output, target, cursor()->m_image);
+}
+
+LOutput::LOutputPrivate::CursorBacking *LOutput::LOutputPrivate::findCursorBacking(const std::shared_ptr<RImage> &target) noexcept
+{
+    if (!target)
+        return nullptr;
+
+    for (auto &backing : cursorBackings)
+        if (backing.target.lock() == target)
+            return &backing;
+
+    return nullptr;
+}
+
+void LOutput::LOutputPrivate::restoreCursorBacking(CursorBacking &backing) noexcept
+{
+    auto target { backing.target.lock() };
+
+    if (target && backing.saved && !backing.rect.isEmpty())
+        CopyImageRect(backing.saved->image(), SkIRect::MakeSize(backing.rect.size()), target, backing.rect.topLeft());
+
+    backing.rect.setEmpty();
+}
+
+SkIRect LOutput::LOutputPrivate::cursorRectToBuffer(const SkIRect &localRect, SkISize bufferSize) const noexcept
+{
+    SkRegion region { localRect };
+    CZRegionUtils::ApplyTransform(region, rect.size(), transform);
+
+    const SkISize transformedSize { CZ::Is90Transform(transform) ? SkISize::Make(rect.height(), rect.width()) : rect.size() };
+
+    if (transformedSize.isEmpty())
+        return SkIRect::MakeEmpty();
+
+    const Float32 sx { Float32(bufferSize.width()) / Float32(transformedSize.width()) };
+    const Float32 sy { Float32(bufferSize.height()) / Float32(transformedSize.height()) };
+    const SkIRect &bounds { region.getBounds() };
+
+    // Padded to also cover pixels touched by the linear filter
+    SkIRect bufferRect { SkRect::MakeLTRB(
+        Float32(bounds.left()) * sx,
+        Float32(bounds.top()) * sy,
+        Float32(bounds.right()) * sx,
+        Float32(bounds.bottom()) * sy).roundOut() };
+    bufferRect.outset(1, 1);
+
+    if (!bufferRect.intersect(SkIRect::MakeSize(bufferSize)))
+        return SkIRect::MakeEmpty();
+
+    return bufferRect;
+}
+
+void LOutput::LOutputPrivate::SetModesAsync(const std::vector<ModeRequest> &requests, std::function<void(const std::vector<int>&)> &&callback) noexcept
+{
+    struct Batch
+    {
+        std::vector<CZWeak<LOutput>> outputs; // Those with a worker thread
+        std::vector<int> results;
+        std::function<void(const std::vector<int>&)> callback;
+        std::atomic<size_t> pending { 1 };
+    };
+
+    auto batch { std::make_shared<Batch>() };
+    batch->results.resize(requests.size(), 1);
+    batch->callback = std::move(callback);
+
+    // The last one to finish notifies the main thread, the calling thread included
+    const auto done { [](std::shared_ptr<Batch> batch) {
+        if (batch->pending.fetch_sub(1) != 1)
+            return;
+
+        compositor()->imp()->postMainThreadTask([batch]{
+            for (auto &output : batch->outputs)
+                if (output)
+                    output->imp()->finishModeset();
+
+            if (batch->callback)
+                batch->callback(batch->results);
+        });
+    }};
+
+    // Setting output modes from a rendering thread is not allowed
+    for (LOutput *o : compositor()->outputs())
+    {
+        if (o->threadId() == std::this_thread::get_id())
+        {
+            batch->results.assign(requests.size(), 0);
+            done(batch);
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        LOutput *output { requests[i].output };
+        const auto &mode { requests[i].mode };
+        output->imp()->finishModeset();
+
+        if (!mode || mode->output() != output)
+            batch->results[i] = 0;
+        else if (mode == output->currentMode())
+            batch->results[i] = 1;
+        else if (output->imp()->state == Uninitialized)
+            batch->results[i] = output->backend()->setMode(mode);
+        else if (output->imp()->state != Initialized)
+            batch->results[i] = 0;
+        else
+        {
+            /* The backend blocks until the output thread applies the mode,
+             * so running them in parallel costs a single modeset */
+            output->imp()->state = ChangingMode;
+            batch->outputs.emplace_back(output);
+            batch->pending++;
+            output->imp()->modesetThread = std::thread([output, mode, i, batch, done]{
+                batch->results[i] = output->backend()->setMode(mode);
+                done(batch);
+            });
+        }
+    }
+
+    done(batch);
+}
+
+void LOutput::LOutputPrivate::finishModeset() noexcept
+{
+    if (!modesetThread.joinable())
+        return;
+
+    const auto unlocked { LLockGuard::Unlock() };
+    modesetThread.join();
+    state = LOutput::Initialized;
+
+    if (unlocked)
+        LLockGuard::Lock();
+
+    updateWlrHeadsMode();
+}
+
+void LOutput::LOutputPrivate::updateWlrHeadsMode() noexcept
+{
+    for (auto *head : wlrOutputHeads)
+    {
+        for (auto *mode : head->modes())
+        {
+            if (mode->mode() == output->currentMode())
+            {
+                head->currentMode(mode);
+                break;
+            }
+        }
+    }
 }
 
 void LOutput::LOutputPrivate::updateRect()
@@ -268,19 +689,44 @@ void LOutput::LOutputPrivate::updateRect()
         roundf(Float32(bufferSize.width())/scale),
         roundf(Float32(bufferSize.height())/scale));
 
+    compositor()->imp()->toplevelsVisibilityChanged = true;
+
     if (!stateFlags.has(IsBlittingFramebuffers))
         updateExclusiveZones();
 }
 
+void LOutput::LOutputPrivate::addSurface(LSurface *surface) noexcept
+{
+    clientSurfaces[surface->client()].emplace(surface);
+}
+
+void LOutput::LOutputPrivate::removeSurface(LSurface *surface) noexcept
+{
+    auto it { clientSurfaces.find(surface->client()) };
+
+    if (it == clientSurfaces.end())
+        return;
+
+    it->second.erase(surface);
+
+    if (it->second.empty())
+        clientSurfaces.erase(it);
+}
+
+void LOutput::LOutputPrivate::sendPreferredScale() noexcept
+{
+    for (auto &[client, surfaces] : clientSurfaces)
+        for (LSurface *s : surfaces)
+            s->imp()->sendPreferredScale();
+}
+
 void LOutput::LOutputPrivate::updateGlobals()
 {
-    for (LClient *c : compositor()->clients())
-        for (GOutput *global : c->outputGlobals())
-            if (output == global->output())
-                global->sendConfiguration();
+    for (auto &[client, globals] : clientGlobals)
+        for (GOutput *global : globals)
+            global->sendConfiguration();
 
-    for (LSurface *s : compositor()->surfaces())
-        s->imp()->sendPreferredScale();
+    sendPreferredScale();
 
     if (output->sessionLockRole())
         output->sessionLockRole()->configure(output->size());
@@ -297,57 +743,109 @@ void LOutput::LOutputPrivate::removeFromSessionLockPendingRepaint() noexcept
     }
 }
 
-void LOutput::LOutputPrivate::updateExclusiveZones() noexcept
+// Places a zone anchored to an edge after the edges taken by the previous zones
+static void PlaceEdgeZone(const LExclusiveZone *zone, SkISize outputSize, LMargins &edges, SkIRect &dst) noexcept
+{
+    switch (zone->edge())
+    {
+    case CZEdgeNone:
+        break;
+    case CZEdgeLeft:
+        dst.fLeft = edges.left;
+        dst.fTop = edges.top;
+        dst.fRight = dst.fLeft + zone->size();
+        dst.fBottom = outputSize.height() - edges.bottom;
+        edges.left += zone->size();
+        break;
+    case CZEdgeTop:
+        dst.fLeft = edges.left;
+        dst.fTop = edges.top;
+        dst.fBottom = dst.fTop + zone->size();
+        dst.fRight = outputSize.width() - edges.right;
+        edges.top += zone->size();
+        break;
+    case CZEdgeRight:
+        dst.fTop = edges.top;
+        dst.fBottom = outputSize.height() - edges.bottom;
+        edges.right += zone->size();
+        dst.fLeft = outputSize.width() - edges.right;
+        dst.fRight = dst.fLeft + zone->size();
+        break;
+    case CZEdgeBottom:
+        dst.fLeft = edges.left;
+        dst.fRight = outputSize.width() - edges.right;
+        edges.bottom += zone->size();
+        dst.fTop = outputSize.height() - edges.bottom;
+        dst.fBottom = dst.fTop + zone->size();
+        break;
+    }
+}
+
+// Places zones that fill the available geometry or the whole output
+static void PlaceFillZone(const LExclusiveZone *zone, SkISize outputSize, const SkIRect &availableGeometry, SkIRect &dst) noexcept
+{
+    if (zone->edge() == CZEdgeNone)
+    {
+        if (zone->size() >= 0)
+            dst = availableGeometry;
+        else
+            dst.setSize(outputSize);
+    }
+    else
+    {
+        if (zone->size() == 0)
+            dst = availableGeometry;
+        else if (zone->size() < 0)
+            dst.setXYWH(
+                dst.x(),
+                dst.y(),
+                outputSize.width(),
+                outputSize.height());
+    }
+}
+
+void LOutput::LOutputPrivate::updateExclusiveZones(LExclusiveZone *changed) noexcept
 {
-    exclusiveEdges = {0, 0, 0, 0};
+    /* Zones only depend on the edges taken by the zones before them, so when a single zone changes
+     * the layout is recomputed from it, up to the first following zone whose previous edges didn't change */
+    auto it { exclusiveZones.begin() };
+    LMargins edges {};
+    bool unchangedTail { false };
     SkIRect prev { 0, 0, 0, 0 };
 
-    for (LExclusiveZone *zone : exclusiveZones)
+    if (changed)
     {
+        it = changed->m_outputLink;
+        edges = changed->m_edgesBefore;
+    }
+
+    for (; it != exclusiveZones.end(); it++)
+    {
+        LExclusiveZone *zone { *it };
+
+        if (changed && zone != changed && zone->m_edgesBefore == edges)
+        {
+            unchangedTail = true;
+            break;
+        }
+
+        zone->m_edgesBefore = edges;
+
         if (zone->size() <= 0)
             continue;
 
         if (zone->m_onRectChangeCallback)
             prev = zone->m_rect;
 
-        switch (zone->edge())
-        {
-        case CZEdgeNone:
-            break;
-        case CZEdgeLeft:
-            zone->m_rect.fLeft = exclusiveEdges.left;
-            zone->m_rect.fTop = exclusiveEdges.top;
-            zone->m_rect.fRight = zone->m_rect.fLeft + zone->size();
-            zone->m_rect.fBottom = rect.height() - exclusiveEdges.bottom;
-            exclusiveEdges.left += zone->size();
-            break;
-        case CZEdgeTop:
-            zone->m_rect.fLeft = exclusiveEdges.left;
-            zone->m_rect.fTop = exclusiveEdges.top;
-            zone->m_rect.fBottom = zone->m_rect.fTop + zone->size();
-            zone->m_rect.fRight = rect.width() - exclusiveEdges.right;
-            exclusiveEdges.top += zone->size();
-            break;
-        case CZEdgeRight:
-            zone->m_rect.fTop = exclusiveEdges.top;
-            zone->m_rect.fBottom = rect.height() - exclusiveEdges.bottom;
-            exclusiveEdges.right += zone->size();
-            zone->m_rect.fLeft = rect.width() - exclusiveEdges.right;
-            zone->m_rect.fRight = zone->m_rect.fLeft + zone->size();
-            break;
-        case CZEdgeBottom:
-            zone->m_rect.fLeft = exclusiveEdges.left;
-            zone->m_rect.fRight = rect.width() - exclusiveEdges.right;
-            exclusiveEdges.bottom += zone->size();
-            zone->m_rect.fTop = rect.height() - exclusiveEdges.bottom;
-            zone->m_rect.fBottom = zone->m_rect.fTop + zone->size();
-            break;
-        }
+        PlaceEdgeZone(zone, rect.size(), edges, zone->m_rect);
 
         if (zone->m_onRectChangeCallback && prev != zone->m_rect)
             zone->m_onRectChangeCallback(zone);
     }
 
+    if (!unchangedTail)
+        exclusiveEdges = edges;
+
     prev = availableGeometry;
     availableGeometry.fLeft = exclusiveEdges.left;
     availableGeometry.fTop = exclusiveEdges.top;
@@ -358,36 +856,65 @@ void LOutput::LOutputPrivate::updateExclusiveZones() noexcept
 
     for (LExclusiveZone *zone : exclusiveZones)
     {
+        // Zones filling the available geometry only change along with it
+        if (changed && zone != changed && !availableGeometryChanged)
+            continue;
+
         if (zone->m_onRectChangeCallback)
             prev = zone->m_rect;
 
-        if (zone->edge() == CZEdgeNone)
-        {
-            if (zone->size() >= 0)
-                zone->m_rect = availableGeometry;
-            else
-                zone->m_rect.setSize(rect.size());
-        }
-        else
-        {
-            if (zone->size() == 0)
-                zone->m_rect = availableGeometry;
-            else if ( zone->size() < 0)
-                zone->m_rect.setXYWH(
-                    zone->m_rect.x(),
-                    zone->m_rect.y(),
-                    rect.width(),
-                    rect.height());
-        }
+        PlaceFillZone(zone, rect.size(), availableGeometry, zone->m_rect);
 
         if (zone->m_onRectChangeCallback && prev != zone->m_rect)
             zone->m_onRectChangeCallback(zone);
     }
 
+#ifndef NDEBUG
+    if (changed)
+        checkExclusiveZones();
+#endif
+
     if (availableGeometryChanged)
         output->availableGeometryChanged();
 }
 
+#ifndef NDEBUG
+void LOutput::LOutputPrivate::checkExclusiveZones() const noexcept
+{
+    // Full recompute, the incremental update must produce the same layout
+    LMargins edges {};
+    std::vector<SkIRect> rects;
+    rects.reserve(exclusiveZones.size());
+
+    for (const LExclusiveZone *zone : exclusiveZones)
+    {
+        assert(zone->m_edgesBefore == edges && "Incremental exclusive zone update: Wrong previous edges");
+        rects.emplace_back(zone->m_rect);
+
+        if (zone->size() > 0)
+            PlaceEdgeZone(zone, rect.size(), edges, rects.back());
+    }
+
+    assert(exclusiveEdges == edges && "Incremental exclusive zone update: Wrong exclusive edges");
+
+    const SkIRect available { SkIRect::MakeLTRB(
+        edges.left,
+        edges.top,
+        rect.width() - edges.right,
+        rect.height() - edges.bottom) };
+
+    assert(availableGeometry == available && "Incremental exclusive zone update: Wrong available geometry");
+
+    size_t i { 0 };
+    for (const LExclusiveZone *zone : exclusiveZones)
+    {
+        PlaceFillZone(zone, rect.size(), available, rects[i]);
+        assert(zone->m_rect == rects[i] && "Incremental exclusive zone update: Wrong zone rect");
+        i++;
+    }
+}
+#endif
+
 void LOutput::LOutputPrivate::updateLayerSurfacesMapping() noexcept
 {
     for (LSurface *s : compositor()->surfaces())
@@ -395,6 +922,35 @@ void LOutput::LOutputPrivate::updateLayerSurfacesMapping() noexcept
             s->layerRole()->updateMappingState();
 }
 
+void LOutput::LOutputPrivate::updatePlaneAssignments() noexcept
+{
+    planeAssignments.clear();
+
+    if (output->planes().empty())
+        return;
+
+    // Captures must include all the content
+    if (imageCopyCaptureSessions.empty())
+        output->assignPlanes(planeAssignments);
+
+    // Explicit sync points can't be forwarded to the backend
+    std::erase_if(planeAssignments, [](const LPlaneAssignment &assignment) {
+        return !assignment.plane || !assignment.surface || !assignment.buffer ||
+            assignment.surface->imp()->current.buffer.acquireTimeline ||
+            assignment.surface->imp()->current.buffer.releaseTimeline;
+    });
+
+    // Fallback to composition, starting from the lowest priority
+    while (!planeAssignments.empty() && !output->backend()->testPlanes(planeAssignments))
+        planeAssignments.pop_back();
+
+    if (!output->backend()->setPlanes(planeAssignments) && !planeAssignments.empty())
+    {
+        planeAssignments.clear();
+        output->backend()->setPlanes(planeAssignments);
+    }
+}
+
 void LOutput::LOutputPrivate::handleUnpresentedSurfaces() noexcept
 {
     for (LSurface *s : compositor()->surfaces())
@@ -425,6 +981,12 @@ void LOutput::LOutputPrivate::resizeOSSurface() noexcept
         fbSize.fWidth = fbSize.width() + fbSize.width() % (Int32)scale;
         fbSize.fHeight = fbSize.height() + fbSize.height() % (Int32)scale;
 
+        if (osSurface && osSurface->image()->size() == fbSize)
+            return;
+
+        // New contents are undefined, paint and blit everything
+        stateFlags.add(OSSurfaceReset);
+
         if (osSurface)
             osSurface->resize(fbSize, 1, true);
         else
@@ -9,9 +9,13 @@
 #include <CZ/Core/Events/CZPresentationEvent.h>
 #include <CZ/Core/CZBitset.h>
 #include <CZ/Core/CZWeak.h>
+#include <array>
+#include <functional>
 #include <future>
 #include <list>
 #include <queue>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace CZ;
 
@@ -33,6 +37,11 @@ LPRIVATE_CLASS_NO_COPY(LOutput)
         NeedsFullRepaint                    = static_cast<UInt32>(1) << 4,
         IsBlittingFramebuffers              = static_cast<UInt32>(1) << 5,
         IsInPaintGL                         = static_cast<UInt32>(1) << 6,
+        OSSurfaceReset                      = static_cast<UInt32>(1) << 7,
+        PendingContentUpdate                = static_cast<UInt32>(1) << 8, // See LCompositorPrivate::updateOutputsContent()
+        CursorOnlyRepaint                   = static_cast<UInt32>(1) << 9, // Only the software cursor changed since the last frame, see repaintCursor()
+        CursorPainted                       = static_cast<UInt32>(1) << 10, // The last paintGL() called LOutput::paintCursor()
+        ContentPolicyApplied                = static_cast<UInt32>(1) << 11, // A policy with a surface is in effect, see LOutput::setContentPolicy()
     };
 
     LOutputPrivate(LOutput *output) noexcept : output(output) {}
@@ -49,6 +58,9 @@ LPRIVATE_CLASS_NO_COPY(LOutput)
     // Framebuffer for fractional scaling with oversampling
     std::shared_ptr<RSurface> osSurface;
 
+    // Damage of the previous downsample blits in buffer coords, most recent first
+    std::array<SkRegion, 4> osDamageHistory;
+
     // The wp_fractional_v1 scale set with setScale() returned with fractionalScale()
     Float32 fractionalScale { 1.f };
 
@@ -71,7 +83,7 @@ LPRIVATE_CLASS_NO_COPY(LOutput)
 
     void resizeOSSurface() noexcept;
     void damageToBufferCoords() noexcept;
-    void blitFramebuffers() noexcept;
+    void blitFramebuffers(bool cursorOnly) noexcept;
     void blitFractionalScaleFb(bool cursorOnly) noexcept;
 
     // DRM Lease
@@ -82,17 +94,44 @@ LPRIVATE_CLASS_NO_COPY(LOutput)
     // Wlr Output Management
     std::vector<Protocols::WlrOutputManagement::RWlrOutputHead*> wlrOutputHeads;
 
+    // ext-image-copy-capture-v1 sessions capturing this output
+    std::vector<Protocols::ImageCopyCapture::RImageCopyCaptureSession*> imageCopyCaptureSessions;
+
     // From the last gamma LUT set by a client
     CZWeak<Protocols::GammaControl::RZwlrGammaControlV1> wlrGammaControl;
 
     // Thread sync stuff
     std::promise<bool> initPromise;
+    UInt64 initializedMs { 0 }; // Set right before initPromise, see LCompositor::addOutputs()
     std::promise<bool> unitPromise;
     std::thread::id threadId;
 
     CZWeak<LSessionLockRole> sessionLockRole;
+
+    // Set by the backend before paintGL(), see LOutput::passthroughSurface()
+    CZWeak<LSurface> passthroughSurface;
     void removeFromSessionLockPendingRepaint() noexcept;
 
+    // Accepted by the backend, see LOutput::assignPlanes()
+    std::vector<LPlaneAssignment> planeAssignments;
+    void updatePlaneAssignments() noexcept;
+
+    // Asynchronous modesets, see LOutput::setModeAsync()
+    struct ModeRequest
+    {
+        LOutput *output;
+        std::shared_ptr<LOutputMode> mode;
+    };
+
+    /* Starts the backend modesets of all initialized outputs concurrently, each from its own worker thread.
+     * The callback is invoked from the main thread once all finish, with the LOutput::setMode() result of each request. */
+    static void SetModesAsync(const std::vector<ModeRequest> &requests, std::function<void(const std::vector<int>&)> &&callback) noexcept;
+
+    // Joins the worker thread of a pending modeset if any, required before touching the backend
+    void finishModeset() noexcept;
+    void updateWlrHeadsMode() noexcept;
+    std::thread modesetThread;
+
     /* Functions called by the backend, from a render thread */
 
     // Notifies the successful output initialization
@@ -110,16 +149,95 @@ LPRIVATE_CLASS_NO_COPY(LOutput)
     // Send discard events to unpresented surfaces after a paintGL event
     void handleUnpresentedSurfaces() noexcept;
     // Marked as presented in paintGL but waiting for a page flip/discard
-    // Handled when the output sends an CZPresentationEvent
-    std::list<CZWeak<Protocols::PresentationTime::RPresentationFeedback>> waitingPresentationFeedback;
+    // Handled when the output sends an CZPresentationEvent, bucketed by paintEventId % size
+    struct PresentationBucket
+    {
+        UInt64 paintEventId { 0 };
+        std::vector<CZWeak<Protocols::PresentationTime::RPresentationFeedback>> feedback;
+    };
+    std::array<PresentationBucket, 8> presentationBuckets;
+
+    // Discards leftovers if the ring wrapped around
+    std::vector<CZWeak<Protocols::PresentationTime::RPresentationFeedback>> &presentationBucket(UInt64 paintEventId) noexcept;
+
+    // wl_output resources bound by each client, see GOutput
+    std::unordered_map<LClient*, std::vector<Protocols::Wayland::GOutput*>> clientGlobals;
+
+    /* Surfaces within the output by client, see LSurface::sendOutputEnterEvent() and sendOutputLeaveEvent()
+     * Hashed instead of intrusive per-output links in LSurface: enter/leave events are rare compared to lookups
+     * by client (wl_output binds), and surfaces would otherwise need a link per output, which can come and go */
+    std::unordered_map<LClient*, std::unordered_set<LSurface*>> clientSurfaces;
+    void addSurface(LSurface *surface) noexcept;
+    void removeSurface(LSurface *surface) noexcept;
+    void sendPreferredScale() noexcept;
     // Presented/discarded frames
     std::queue<CZPresentationEvent> presentationEventQueue;
 
     std::list<LExclusiveZone*> exclusiveZones;
     SkIRect availableGeometry { 0, 0, 0, 0 };
     LMargins exclusiveEdges;
-    void updateExclusiveZones() noexcept;
+    void updateExclusiveZones(LExclusiveZone *changed = nullptr) noexcept; // nullptr = full update
+#ifndef NDEBUG
+    void checkExclusiveZones() const noexcept; // Asserts incremental updates match a full update
+#endif
     void updateLayerSurfacesMapping() noexcept;
+
+    // See LOutput::setContentPolicy()
+    ContentPolicy contentPolicy;
+
+    // State set by the compositor, saved while ContentPolicyApplied and restored afterwards
+    struct
+    {
+        RContentType contentType { RContentType::Graphics };
+        bool vsync { true };
+        bool vrr { false };
+    } userContentState;
+
+    // What each LBackendOutput::cursorImages() contains, reused while it matches, see LCursor::updatePlane()
+    struct CursorImageKey
+    {
+        std::weak_ptr<RImage> image;
+        UInt32 writeSerial { 0 };
+        SkISize size { 0, 0 };
+        CZTransform transform { CZTransform::Normal };
+
+        bool matches(const CursorImageKey &other) const noexcept
+        {
+            return !image.expired() && image.lock() == other.image.lock() && writeSerial == other.writeSerial &&
+                size == other.size && transform == other.transform;
+        }
+    };
+    std::vector<CursorImageKey> cursorImageKeys;
+
+    /* Software cursor, see LOutput::paintCursor()
+     *
+     * The pixels under the cursor are saved before painting it into each image(), so that frames where only the
+     * cursor changed restore the old rect and paint the new one instead of calling paintGL(). With oversampling the
+     * cursor is painted into the backend image after the downscale instead, so the oversampled image never contains it. */
+    struct CursorBacking
+    {
+        std::weak_ptr<RImage> target; // The image() the cursor was painted into
+        std::shared_ptr<RSurface> saved; // Pixels of target under rect, at (0, 0)
+        SkIRect rect { 0, 0, 0, 0 }; // Painted rect in target buffer coords, empty if not painted
+        UInt64 sceneSerial { 0 }; // The scene target contains, 0 if unknown
+    };
+    std::vector<CursorBacking> cursorBackings;
+
+    // Incremented each paintGL() not triggered by the cursor alone
+    UInt64 sceneSerial { 1 };
+
+    // Output-local rect of the cursor painted in the last frame, empty if none
+    SkIRect cursorRect { 0, 0, 0, 0 };
+
+    // Like repaint() but allows skipping paintGL() if nothing else requests a repaint before the next frame
+    void repaintCursor() noexcept;
+
+    // Restores and paints the cursor without calling paintGL(), returns false if not possible
+    bool paintCursorOnly() noexcept;
+    void paintCursor() noexcept;
+    CursorBacking *findCursorBacking(const std::shared_ptr<RImage> &target) noexcept;
+    void restoreCursorBacking(CursorBacking &backing) noexcept;
+    SkIRect cursorRectToBuffer(const SkIRect &localRect, SkISize bufferSize) const noexcept;
 };
 
 #endif // LOUTPUTPRIVATE_H
@@ -0,0 +1,401 @@
+#include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
+#include <CZ/Louvre/Protocols/Wayland/RWlSurface.h>
+#include <CZ/Louvre/Private/LProtocolRecorder.h>
+#include <CZ/Louvre/Private/LCompositorPrivate.h>
+#include <CZ/Louvre/Private/LSurfacePrivate.h>
+#include <CZ/Louvre/LGlobal.h>
+#include <CZ/Louvre/LLog.h>
+#include <CZ/Ream/RImage.h>
+#include <wayland-server.h>
+#include <drm_fourcc.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+#include <time.h>
+
+using namespace CZ;
+
+namespace
+{
+    struct RecordedClient
+    {
+        wl_listener destroyListener;
+        UInt32 id { 0 }; // 0 if not recorded
+        std::unordered_map<UInt32, UInt64> shmHashes;
+        std::unordered_set<UInt32> dmaBuffers;
+    };
+
+    FILE *s_file { nullptr };
+    wl_protocol_logger *s_logger { nullptr };
+    UInt64 s_startNs { 0 };
+    UInt32 s_nextClientId { 1 };
+    std::vector<std::string> s_filters;
+    std::unordered_map<wl_client*, std::unique_ptr<RecordedClient>> s_clients;
+    std::vector<UInt8> s_payload;
+
+    UInt64 NowNs() noexcept
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return UInt64(ts.tv_sec) * 1000000000ULL + UInt64(ts.tv_nsec);
+    }
+
+    template<class T>
+    void Put(T value) noexcept
+    {
+        const auto *bytes { reinterpret_cast<const UInt8*>(&value) };
+        s_payload.insert(s_payload.end(), bytes, bytes + sizeof(T));
+    }
+
+    void PutBytes(const void *data, size_t size) noexcept
+    {
+        const auto *bytes { static_cast<const UInt8*>(data) };
+        s_payload.insert(s_payload.end(), bytes, bytes + size);
+    }
+
+    void PutString(const char *str) noexcept
+    {
+        if (!str)
+        {
+            Put<UInt32>(LProtocolRecorder::NullString);
+            return;
+        }
+
+        const UInt32 len ( strlen(str) );
+        Put<UInt32>(len);
+        PutBytes(str, len);
+    }
+
+    void WriteRecord(LProtocolRecorder::RecordType type, UInt32 clientId) noexcept
+    {
+        const UInt8 type8 { type };
+        const UInt64 time { NowNs() - s_startNs };
+        const UInt32 size ( s_payload.size() );
+        fwrite(&type8, sizeof(type8), 1, s_file);
+        fwrite(&time, sizeof(time), 1, s_file);
+        fwrite(&clientId, sizeof(clientId), 1, s_file);
+        fwrite(&size, sizeof(size), 1, s_file);
+
+        if (size > 0)
+            fwrite(s_payload.data(), 1, size, s_file);
+
+        s_payload.clear();
+    }
+
+    // FNV-1a, only used to skip unchanged buffers
+    UInt64 Hash(const UInt8 *data, size_t size) noexcept
+    {
+        UInt64 hash { 14695981039346656037ULL };
+
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    bool MatchesFilters(pid_t pid) noexcept
+    {
+        if (s_filters.empty())
+            return true;
+
+        std::string comm;
+        std::ifstream file { "/proc/" + std::to_string(pid) + "/comm" };
+        std::getline(file, comm);
+
+        for (const auto &filter : s_filters)
+            if (filter == comm || filter == std::to_string(pid))
+                return true;
+
+        return false;
+    }
+
+    void HandleClientDestroyed(wl_listener *listener, void *data) noexcept
+    {
+        auto it { s_clients.find(static_cast<wl_client*>(data)) };
+
+        if (it == s_clients.end())
+            return;
+
+        if (it->second->id != 0 && s_file)
+            WriteRecord(LProtocolRecorder::ClientDisconnected, it->second->id);
+
+        wl_list_remove(&listener->link);
+        s_clients.erase(it);
+    }
+
+    // Returns nullptr if the client is not being recorded
+    RecordedClient *GetClient(wl_client *wlClient) noexcept
+    {
+        auto it { s_clients.find(wlClient) };
+
+        if (it != s_clients.end())
+            return it->second->id == 0 ? nullptr : it->second.get();
+
+        auto client { std::make_unique<RecordedClient>() };
+        client->destroyListener.notify = HandleClientDestroyed;
+        wl_client_add_destroy_listener(wlClient, &client->destroyListener);
+
+        pid_t pid { -1 };
+        wl_client_get_credentials(wlClient, &pid, nullptr, nullptr);
+
+        if (MatchesFilters(pid))
+        {
+            client->id = s_nextClientId++;
+            WriteRecord(LProtocolRecorder::ClientConnected, client->id);
+            LLog(CZInfo, CZLN, "Recording client {} (pid {})", client->id, pid);
+        }
+
+        auto *ret { client->id == 0 ? nullptr : client.get() };
+        s_clients.emplace(wlClient, std::move(client));
+        return ret;
+    }
+
+    void RecordShmContents(RecordedClient &client, wl_resource *buffer) noexcept
+    {
+        auto *shm { wl_shm_buffer_get(buffer) };
+
+        if (!shm)
+            return;
+
+        const UInt32 bufferId { wl_resource_get_id(buffer) };
+        const UInt32 size ( wl_shm_buffer_get_stride(shm) * wl_shm_buffer_get_height(shm) );
+
+        wl_shm_buffer_begin_access(shm);
+        const auto *data { static_cast<const UInt8*>(wl_shm_buffer_get_data(shm)) };
+        const UInt64 hash { Hash(data, size) };
+        auto it { client.shmHashes.find(bufferId) };
+
+        if (it == client.shmHashes.end() || it->second != hash)
+        {
+            client.shmHashes[bufferId] = hash;
+            Put<UInt32>(bufferId);
+            Put<UInt32>(size);
+            PutBytes(data, size);
+            WriteRecord(LProtocolRecorder::ShmContents, client.id);
+        }
+
+        wl_shm_buffer_end_access(shm);
+    }
+
+    void RecordDMAContents(RecordedClient &client, wl_resource *buffer) noexcept
+    {
+        if (!buffer || !LDMABuffer::isDMABuffer(buffer))
+            return;
+
+        const UInt32 bufferId { wl_resource_get_id(buffer) };
+
+        if (!client.dmaBuffers.emplace(bufferId).second)
+            return;
+
+        auto *dmaBuffer { static_cast<LDMABuffer*>(wl_resource_get_user_data(buffer)) };
+        auto image { dmaBuffer->image() };
+
+        if (!image)
+            return;
+
+        const SkISize size { image->size() };
+        std::vector<UInt8> pixels (size.width() * size.height() * 4);
+
+        RPixelBufferRegion info {};
+        info.pixels = pixels.data();
+        info.region.setRect(SkIRect::MakeSize(size));
+        info.stride = size.width() * 4;
+        info.format = DRM_FORMAT_ARGB8888;
+
+        if (!image->readPixels(info))
+        {
+            LLog(CZWarning, CZLN, "Failed to read back DMA buffer {} of client {}, it will be replayed black", bufferId, client.id);
+            std::fill(pixels.begin(), pixels.end(), 0);
+        }
+
+        Put<UInt32>(bufferId);
+        Put<Int32>(size.width());
+        Put<Int32>(size.height());
+        PutBytes(pixels.data(), pixels.size());
+        WriteRecord(LProtocolRecorder::DMAContents, client.id);
+    }
+
+    void Logger(void */*data*/, wl_protocol_logger_type type, const wl_protocol_logger_message *msg) noexcept
+    {
+        if (type != WL_PROTOCOL_LOGGER_REQUEST || !s_file)
+            return;
+
+        auto *client { GetClient(wl_resource_get_client(msg->resource)) };
+
+        if (!client)
+            return;
+
+        const char *interface { wl_resource_get_class(msg->resource) };
+
+        // Buffer contents must precede the requests that use them
+        if (strcmp(interface, wl_surface_interface.name) == 0)
+        {
+            if (msg->message_opcode == WL_SURFACE_ATTACH && msg->arguments[0].o)
+                RecordDMAContents(*client, reinterpret_cast<wl_resource*>(msg->arguments[0].o));
+            else if (msg->message_opcode == WL_SURFACE_COMMIT)
+            {
+                auto *surfaceRes { static_cast<Protocols::Wayland::RWlSurface*>(wl_resource_get_user_data(msg->resource)) };
+                const auto &pending { surfaceRes->surface()->imp()->pending };
+
+                if (pending.buffer.attached && pending.buffer.buffer.res())
+                    RecordShmContents(*client, pending.buffer.buffer.res());
+            }
+        }
+
+        Put<UInt32>(wl_resource_get_id(msg->resource));
+        Put<UInt16>(msg->message_opcode);
+        PutString(interface);
+        Put<UInt8>(msg->arguments_count);
+
+        Int32 argI { 0 };
+
+        for (const char *sig = msg->message->signature; *sig; sig++)
+        {
+            if (*sig == '?' || (*sig >= '0' && *sig <= '9'))
+                continue;
+
+            const wl_argument &arg { msg->arguments[argI++] };
+            Put<char>(*sig);
+
+            switch (*sig)
+            {
+            case 'i':
+                Put<Int32>(arg.i);
+                break;
+            case 'f':
+                Put<Int32>(arg.f);
+                break;
+            case 'u':
+                Put<UInt32>(arg.u);
+                break;
+            case 'n':
+                Put<UInt32>(arg.n);
+                break;
+            case 'o':
+                Put<UInt32>(arg.o ? wl_resource_get_id(reinterpret_cast<wl_resource*>(arg.o)) : 0);
+                break;
+            case 's':
+                PutString(arg.s);
+                break;
+            case 'a':
+                Put<UInt32>(arg.a ? arg.a->size : 0);
+                if (arg.a && arg.a->size > 0)
+                    PutBytes(arg.a->data, arg.a->size);
+                break;
+            default: // 'h', file descriptors can't be recorded
+                break;
+            }
+        }
+
+        WriteRecord(LProtocolRecorder::Request, client->id);
+    }
+
+    void CollectInterfaces(const wl_interface *interface, std::unordered_map<std::string, const wl_interface*> &map) noexcept
+    {
+        if (!interface || !map.emplace(interface->name, interface).second)
+            return;
+
+        const auto collect { [&map](const wl_message *messages, int count)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                // types has one entry per argument
+                int argI { 0 };
+
+                for (const char *sig = messages[i].signature; *sig; sig++)
+                {
+                    if (*sig == '?' || (*sig >= '0' && *sig <= '9'))
+                        continue;
+
+                    if (messages[i].types && messages[i].types[argI])
+                        CollectInterfaces(messages[i].types[argI], map);
+
+                    argI++;
+                }
+            }
+        }};
+
+        collect(interface->methods, interface->method_count);
+        collect(interface->events, interface->event_count);
+    }
+}
+
+bool LProtocolRecorder::Active() noexcept
+{
+    return s_file != nullptr;
+}
+
+void LProtocolRecorder::Init() noexcept
+{
+    const char *path { getenv("CZ_LOUVRE_RECORD") };
+
+    if (!path || path[0] == '\0' || s_file)
+        return;
+
+    s_filters.clear();
+
+    if (const char *env = getenv("CZ_LOUVRE_RECORD_CLIENTS"))
+    {
+        std::stringstream ss { env };
+        std::string filter;
+
+        while (std::getline(ss, filter, ','))
+            if (!filter.empty())
+                s_filters.emplace_back(filter);
+    }
+
+    s_file = fopen(path, "wb");
+
+    if (!s_file)
+    {
+        LLog(CZError, CZLN, "Failed to open protocol recording file {}", path);
+        return;
+    }
+
+    fwrite(Magic, sizeof(Magic), 1, s_file);
+    fwrite(&FormatVersion, sizeof(FormatVersion), 1, s_file);
+
+    s_startNs = NowNs();
+    s_nextClientId = 1;
+    s_logger = wl_display_add_protocol_logger(LCompositor::display(), &Logger, nullptr);
+    LLog(CZInfo, CZLN, "Recording Wayland requests to {}", path);
+}
+
+void LProtocolRecorder::Unit() noexcept
+{
+    if (!s_file)
+        return;
+
+    for (auto &client : s_clients)
+        wl_list_remove(&client.second->destroyListener.link);
+
+    s_clients.clear();
+
+    if (s_logger)
+    {
+        wl_protocol_logger_destroy(s_logger);
+        s_logger = nullptr;
+    }
+
+    fclose(s_file);
+    s_file = nullptr;
+    LLog(CZInfo, CZLN, "Protocol recording finished");
+}
+
+std::unordered_map<std::string, const wl_interface*> LProtocolRecorder::Interfaces() noexcept
+{
+    std::unordered_map<std::string, const wl_interface*> map;
+
+    for (LGlobal *global : compositor()->imp()->globals)
+        CollectInterfaces(global->interface(), map);
+
+    return map;
+}
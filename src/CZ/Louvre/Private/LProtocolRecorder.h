@@ -0,0 +1,68 @@
+#ifndef CZ_LPROTOCOLRECORDER_H
+#define CZ_LPROTOCOLRECORDER_H
+
+#include <CZ/Louvre/Louvre.h>
+#include <string>
+#include <unordered_map>
+
+struct wl_interface;
+
+/* Wayland request recorder
+ *
+ * Records the requests of the selected clients together with the contents of their buffers into a
+ * compact binary file, which can be played back with the cz-louvre-replay tool.
+ *
+ * See the CZ_LOUVRE_RECORD* environment variables.
+ *
+ * File layout (native byte order):
+ *
+ * Header:  "LVRREC" magic, UInt16 format version
+ * Record:  UInt8 type, UInt64 ns since the recording started, UInt32 client id, UInt32 payload size, payload
+ *
+ * ClientConnected, ClientDisconnected: empty payload
+ *
+ * Request:     UInt32 object id, UInt16 opcode, str interface, UInt8 argc, followed by each arg
+ *              as a UInt8 signature char and its value:
+ *              i/f: Int32, u/o/n: UInt32 (0 for null objects), s: str, a: UInt32 size + bytes, h: none (not recorded)
+ *
+ * ShmContents: UInt32 buffer id, UInt32 size, bytes (stride * height, starting at the buffer offset within its pool)
+ *              Written before the wl_surface.commit that presents the buffer, only if its contents changed.
+ *
+ * DMAContents: UInt32 buffer id, Int32 width, Int32 height, bytes (ARGB8888, stride = width * 4)
+ *              Read back once, before the first wl_surface.attach of the buffer.
+ *
+ * str: UInt32 length (0xFFFFFFFF if null) + bytes without the null terminator
+ */
+
+namespace CZ
+{
+    class LProtocolRecorder
+    {
+    public:
+        enum RecordType : UInt8
+        {
+            ClientConnected,
+            ClientDisconnected,
+            Request,
+            ShmContents,
+            DMAContents
+        };
+
+        static constexpr char Magic[6] { 'L', 'V', 'R', 'R', 'E', 'C' };
+        static constexpr UInt16 FormatVersion { 1 };
+        static constexpr UInt32 NullString { 0xFFFFFFFF };
+
+        static bool Active() noexcept;
+
+        // Reads the env vars and starts recording if requested, called once the compositor is initialized
+        static void Init() noexcept;
+
+        // Stops recording and closes the file
+        static void Unit() noexcept;
+
+        // Interfaces of all globals and the interfaces they can create, indexed by name
+        static std::unordered_map<std::string, const wl_interface*> Interfaces() noexcept;
+    };
+}
+
+#endif // CZ_LPROTOCOLRECORDER_H
@@ -0,0 +1,138 @@
+#include <CZ/Louvre/Private/LRegionIndex.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace CZ;
+
+void LRegionIndex::build(const SkRegion &region) noexcept
+{
+    clear();
+
+    // SkRegion iterates rects band by band, rects within a band share top and bottom
+    for (SkRegion::Iterator it(region); !it.done(); it.next())
+    {
+        const SkIRect &rect { it.rect() };
+
+        if (m_bands.empty() || m_bands.back().top != rect.top())
+            m_bands.push_back({ rect.top(), rect.bottom(), UInt32(m_spans.size()), UInt32(m_spans.size()) });
+
+        m_spans.push_back({ rect.left(), rect.right() });
+        m_bands.back().end++;
+    }
+}
+
+void LRegionIndex::clear() noexcept
+{
+    m_bands.clear();
+    m_spans.clear();
+}
+
+size_t LRegionIndex::bandAt(Int32 y) const noexcept
+{
+    return std::upper_bound(m_bands.begin(), m_bands.end(), y, [](Int32 y, const Band &band) {
+        return y < band.bottom;
+    }) - m_bands.begin();
+}
+
+bool LRegionIndex::contains(SkPoint point) const noexcept
+{
+    const Int32 x { Int32(std::floor(point.x())) };
+    const Int32 y { Int32(std::floor(point.y())) };
+    const size_t i { bandAt(y) };
+
+    if (i == m_bands.size() || m_bands[i].top > y)
+        return false;
+
+    const auto end { m_spans.begin() + m_bands[i].end };
+    const auto span { std::upper_bound(m_spans.begin() + m_bands[i].begin, end, x, [](Int32 x, const Span &span) {
+        return x < span.right;
+    })};
+
+    return span != end && span->left <= x;
+}
+
+Float32 LRegionIndex::closestX(const Band &band, Float32 x) const noexcept
+{
+    const auto begin { m_spans.begin() + band.begin };
+    const auto end { m_spans.begin() + band.end };
+
+    // First span ending after x
+    const auto span { std::upper_bound(begin, end, x, [](Float32 x, const Span &span) {
+        return x < Float32(span.right);
+    })};
+
+    if (span != end && Float32(span->left) <= x)
+        return x;
+
+    Float32 best { 0.f };
+    Float32 bestDist { INFINITY };
+
+    if (span != end)
+    {
+        best = Float32(span->left);
+        bestDist = best - x;
+    }
+
+    if (span != begin)
+    {
+        const Float32 right { Float32((span - 1)->right - 1) };
+
+        if (x - right < bestDist)
+            best = right;
+    }
+
+    return best;
+}
+
+SkPoint LRegionIndex::closestPoint(SkPoint point) const noexcept
+{
+    if (m_bands.empty())
+        return { 0.f, 0.f };
+
+    SkPoint best { point };
+    Float32 bestDist { INFINITY };
+
+    const auto eval = [&](const Band &band) {
+        SkPoint candidate { closestX(band, point.x()), point.y() };
+
+        if (candidate.y() < Float32(band.top))
+            candidate.fY = Float32(band.top);
+        else if (candidate.y() >= Float32(band.bottom))
+            candidate.fY = Float32(band.bottom - 1);
+
+        const SkPoint d { candidate - point };
+        const Float32 dist { d.x() * d.x() + d.y() * d.y() };
+
+        if (dist < bestDist)
+        {
+            bestDist = dist;
+            best = candidate;
+        }
+    };
+
+    const size_t first { bandAt(Int32(std::floor(point.y()))) };
+
+    // Bands below (including the one containing the point), stop once they can no longer be closer
+    for (size_t i = first; i < m_bands.size() && bestDist > 0.f; i++)
+    {
+        const Float32 dy { std::max(0.f, Float32(m_bands[i].top) - point.y()) };
+
+        if (dy * dy >= bestDist)
+            break;
+
+        eval(m_bands[i]);
+    }
+
+    // Bands above
+    for (size_t i = first; i-- > 0 && bestDist > 0.f;)
+    {
+        const Float32 dy { std::max(0.f, point.y() - Float32(m_bands[i].bottom - 1)) };
+
+        if (dy * dy >= bestDist)
+            break;
+
+        eval(m_bands[i]);
+    }
+
+    return best;
+}
@@ -0,0 +1,54 @@
+#ifndef CZ_LREGIONINDEX_H
+#define CZ_LREGIONINDEX_H
+
+#include <CZ/Louvre/Louvre.h>
+#include <CZ/skia/core/SkRegion.h>
+#include <CZ/skia/core/SkPoint.h>
+#include <vector>
+
+/* Flattened copy of an SkRegion for fast point queries
+ *
+ * The region is stored as sorted horizontal bands, each with its sorted spans, so that
+ * contains() costs two binary searches. closestPoint() starts at the nearest band and only
+ * visits neighbouring bands while they can still be closer than the best candidate.
+ *
+ * Meant to be rebuilt only when the source region changes (e.g. on commit), not per query. */
+
+namespace CZ
+{
+    class LRegionIndex
+    {
+    public:
+        void build(const SkRegion &region) noexcept;
+        void clear() noexcept;
+        bool empty() const noexcept { return m_bands.empty(); }
+
+        // Same as SkRegion::contains() with the point floored
+        bool contains(SkPoint point) const noexcept;
+
+        // Returns the point itself if contained, or the closest point within the region (0,0 if empty)
+        SkPoint closestPoint(SkPoint point) const noexcept;
+    private:
+        struct Band
+        {
+            Int32 top, bottom;
+            UInt32 begin, end; // Range in m_spans
+        };
+
+        struct Span
+        {
+            Int32 left, right;
+        };
+
+        // Index of the band containing y, or of the first band below it (may be m_bands.size())
+        size_t bandAt(Int32 y) const noexcept;
+
+        // Closest x within the band spans
+        Float32 closestX(const Band &band, Float32 x) const noexcept;
+
+        std::vector<Band> m_bands;
+        std::vector<Span> m_spans;
+    };
+}
+
+#endif // CZ_LREGIONINDEX_H
@@ -6,12 +6,14 @@
 #include <CZ/Louvre/Protocols/DRMSyncObj/linux-drm-syncobj-v1.h>
 #include <CZ/Louvre/Protocols/DRMSyncObj/RDRMSyncObjSurface.h>
 #include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
 #include <CZ/Louvre/Protocols/Wayland/RWlSurface.h>
 #include <CZ/Louvre/Protocols/Wayland/GOutput.h>
 #include <CZ/Louvre/Private/LCompositorPrivate.h>
 #include <CZ/Louvre/Private/LSurfacePrivate.h>
 #include <CZ/Louvre/Private/LOutputPrivate.h>
 #include <CZ/Louvre/Private/LKeyboardPrivate.h>
+#include <CZ/Louvre/Private/LTracer.h>
 #include <CZ/Louvre/Roles/LSessionLockRole.h>
 #include <CZ/Louvre/Roles/LSubsurfaceRole.h>
 #include <CZ/Louvre/Roles/LDNDIconRole.h>
@@ -48,6 +50,8 @@ void LSurface::LSurfacePrivate::setMapped(bool state, bool notifyLater) noexcept
     if (stateFlags.has(Mapped) != state)
     {
         stateFlags.setFlag(Mapped, state);
+        notifyOutputsContentChange();
+        compositor()->imp()->toplevelsVisibilityChanged = true;
 
         if (notifyLater)
             current.changesToNotify.add(Changes::MappingChanged);
@@ -75,6 +79,7 @@ void LSurface::LSurfacePrivate::setRole(LBaseSurfaceRole *role, bool notify) noe
 
 bool LSurface::LSurfacePrivate::bufferToImage(Uncommitted &pending) noexcept
 {
+    LTRACE_SCOPE("bufferToImage", surfaceResource->surface(), pending.commitId);
     auto ream { RCore::Get() };
 
     // Size of the current buffer without transform
@@ -100,6 +105,8 @@ bool LSurface::LSurfacePrivate::bufferToImage(Uncommitted &pending) noexcept
         current.changesToNotify.add(Changes::BufferScaleChanged);
     }
 
+    current.solidColor.reset();
+
     if (current.buffer.buffer.res())
     {
         // SHM
@@ -238,13 +245,11 @@ bool LSurface::LSurfacePrivate::bufferToImage(Uncommitted &pending) noexcept
             {
                 wl_shm_buffer_end_access(shm_buffer);
                 current.buffer.release();
-                wl_client_flush(wl_resource_get_client(current.buffer.buffer.res()));
                 return true;
             }
 
             wl_shm_buffer_end_access(shm_buffer);
             current.buffer.release();
-            wl_client_flush(wl_resource_get_client(current.buffer.buffer.res()));
         }
 
         // DMA-Buf
@@ -282,6 +287,7 @@ bool LSurface::LSurfacePrivate::bufferToImage(Uncommitted &pending) noexcept
         {
             LSinglePixelBuffer &singlePixelBuffer { *static_cast<LSinglePixelBuffer*>(wl_resource_get_user_data(current.buffer.buffer.res())) };
             current.buffer.weakImage = current.image = singlePixelBuffer.image;
+            current.solidColor = singlePixelBuffer.color;
             stateFlags.remove(CurrentImageIsSHM);
 
             if (!current.image)
@@ -327,6 +333,12 @@ bool LSurface::LSurfacePrivate::bufferToImage(Uncommitted &pending) noexcept
     return true;
 }
 
+void LSurface::LSurfacePrivate::notifyOutputsContentChange() noexcept
+{
+    for (LOutput *o : outputs)
+        o->imp()->stateFlags.add(LOutput::LOutputPrivate::PendingContentUpdate);
+}
+
 void LSurface::LSurfacePrivate::sendPreferredScale() noexcept
 {
     if (outputs.empty())
@@ -389,6 +401,14 @@ void LSurface::LSurfacePrivate::setKeyboardGrabToParent()
     */
 }
 
+void LSurface::LSurfacePrivate::damageAll() noexcept
+{
+    current.damage.setRect(SkIRect::MakeSize(size));
+    current.bufferDamage.setRect(SkIRect::MakeSize(sizeB));
+    damageId++;
+    stateFlags.add(Damaged);
+}
+
 void LSurface::LSurfacePrivate::updateDamage(Uncommitted &pending) noexcept
 {
     if (!current.image || current.changesToNotify.has(Changes::SizeChanged | Changes::SrcRectChanged | Changes::BufferSizeChanged | Changes::BufferTransformChanged | Changes::BufferScaleChanged))
@@ -714,6 +734,7 @@ void LSurface::LSurfacePrivate::clearUncommitted(Uncommitted &pending) noexcept
 
 void LSurface::LSurfacePrivate::handleCommit() noexcept
 {
+    LTRACE_SCOPE("handleCommit", surfaceResource->surface(), pending.commitId);
     CZWeak<LSurface> ref { surfaceResource->surface() };
     pending.buffer.surface = surfaceResource->surface();
 
@@ -916,6 +937,52 @@ retryAbove:
 
 void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
 {
+    auto &transaction { compositor()->imp()->subsurfaceTransaction };
+
+    // A synced subsurface released by the transaction below
+    if (transaction.active)
+    {
+        transaction.applied++;
+        applyState(pending);
+        return;
+    }
+
+    CZWeak<LSurface> ref { surfaceResource->surface() };
+    transaction.active = true;
+    transaction.applied = 0;
+    applyState(pending);
+
+    /* notifyCommitToSubsurfaces() queues the locks of synced subsurfaces instead of releasing them one by one,
+     * so that the whole subtree is applied here after the parent state, in breadth-first order. Children then
+     * see the final parent mapping and nested subsurfaces are appended to the same queue.
+     * Releasing a lock applies nothing if the state is still locked by someone else, or several cached states. */
+    for (size_t i = 0; i < transaction.locks.size(); i++)
+    {
+        auto lock { std::move(transaction.locks[i]) };
+        lock.reset(); // May queue more locks
+    }
+
+    const UInt32 applied { transaction.applied };
+    auto events { std::move(transaction.events) };
+    transaction.locks.clear();
+    transaction.events.clear();
+    transaction.active = false;
+
+    if (applied > 0)
+        compositor()->imp()->unlockPoll();
+
+    if (ref)
+        syncedSubsurfacesApplied = applied;
+
+    // Like before transactions, subsurfaces are notified before their parents and see the state of the whole tree
+    for (auto it = events.rbegin(); it != events.rend(); it++)
+        if (it->first)
+            CZCore::Get()->sendEvent(LSurfaceCommitEvent(it->second), *it->first.get());
+}
+
+void LSurface::LSurfacePrivate::applyState(Uncommitted &pending) noexcept
+{
+    LTRACE_SCOPE("applyCommit", surfaceResource->surface(), pending.commitId);
     current.commitId = pending.commitId;
     current.changesToNotify = pending.changesToNotify;
     pending.changesToNotify = 0;
@@ -948,11 +1015,24 @@ void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
             // Release DMA buffers only if a second one has been attached
             if (LDMABuffer::isDMABuffer(current.buffer.buffer.res()) && current.buffer.buffer.res() != pending.buffer.buffer.res())
             {
-                current.buffer.release();
-                wl_client_flush(wl_resource_get_client(current.buffer.buffer.res()));
+                auto *dmaBuffer { static_cast<LDMABuffer*>(wl_resource_get_user_data(current.buffer.buffer.res())) };
+
+                // Deferred while still displayed elsewhere (e.g. by the parent compositor of the Wayland backend)
+                if (current.buffer.releaseTimeline || !dmaBuffer->deferRelease())
+                    current.buffer.release();
             }
         }
 
+        // Attached again before the deferred release
+        if (pending.buffer.buffer.res() && LDMABuffer::isDMABuffer(pending.buffer.buffer.res()))
+        {
+            static_cast<LDMABuffer*>(wl_resource_get_user_data(pending.buffer.buffer.res()))->cancelDeferredRelease();
+
+            for (auto &unreleased : compositor()->imp()->unreleasedBuffers)
+                if (unreleased.releaseSource && unreleased.buffer.res() == pending.buffer.buffer.res())
+                    unreleased.released = true;
+        }
+
         current.buffer = pending.buffer;
     }
 
@@ -1007,6 +1087,7 @@ void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
         current.inputRegion.setEmpty();
         pending.pointerConstraintRegion.reset();
         current.pointerConstraintRegion.setEmpty();
+        current.pointerConstraintIndex.clear();
     }
 
     /******************************************
@@ -1051,6 +1132,9 @@ void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
             current.lockedPointerPosHint = pending.lockedPointerPosHint;
     }
 
+    if (changes.has(Changes::PointerConstraintRegionChanged))
+        current.pointerConstraintIndex.build(current.pointerConstraintRegion);
+
     /****************************************
      *********** INVISIBLE REGION ***********
      ****************************************/
@@ -1077,6 +1161,8 @@ void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
             current.opaqueRegion.setRect(surfaceSizeRect);
         else
             current.opaqueRegion.op(pending.opaqueRegion, surfaceSizeRect, SkRegion::Op::kIntersect_Op);
+
+        compositor()->imp()->toplevelsVisibilityChanged = true;
     }
 
     /*******************************************
@@ -1088,6 +1174,7 @@ void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
     {
         changes.add(Changes::VSyncChanged);
         stateFlags.setFlag(VSync, preferVSync);
+        notifyOutputsContentChange();
     }
 
     /**************************************************
@@ -1097,6 +1184,7 @@ void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
     {
         changes.add(Changes::ContentTypeChanged);
         current.contentType = pending.contentType;
+        notifyOutputsContentChange();
     }
 
     CZWeak<LSurface> ref { surface };
@@ -1112,7 +1200,11 @@ void LSurface::LSurfacePrivate::applyCommit(Uncommitted &pending) noexcept
     if (!ref)
         return;
 
-    CZCore::Get()->sendEvent(LSurfaceCommitEvent(changes), *ref.get());
+    if (changes.has(Changes::DamageRegionChanged | Changes::SizeChanged | Changes::MappingChanged))
+        ImageCopyCapture::RImageCopyCaptureSession::HandleSurfaceCommit(surface);
+
+    // Sent once the whole subsurface tree is applied, see applyCommit()
+    compositor()->imp()->subsurfaceTransaction.events.emplace_back(ref, changes);
     changes.set(Changes::NoChanges);
 }
 
@@ -1126,6 +1218,7 @@ void LSurface::LSurfacePrivate::setLayer(LSurfaceLayer newLayer) noexcept
     compositor()->imp()->layers[newLayer].emplace_back(surf);
     layerLink = std::prev(compositor()->imp()->layers[newLayer].end());
     layer = newLayer;
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 
     surf->layerChanged();
 
@@ -6,6 +6,7 @@
 #include <CZ/Louvre/Protocols/Wayland/RWlSurface.h>
 #include <CZ/Louvre/Private/LCompositorPrivate.h>
 #include <CZ/Louvre/Private/LResourceRef.h>
+#include <CZ/Louvre/Private/LRegionIndex.h>
 #include <CZ/Louvre/Events/LSurfaceCommitEvent.h>
 #include <CZ/Louvre/Roles/LSurface.h>
 #include <CZ/Ream/RImage.h>
@@ -87,6 +88,7 @@ LPRIVATE_CLASS(LSurface)
         PointerConstraintMode pointerConstraintMode { PointerConstraintMode::Free };
         SkPoint lockedPointerPosHint        { -1.f, -1.f };
         SkRegion pointerConstraintRegion;
+        LRegionIndex pointerConstraintIndex; // Rebuilt when pointerConstraintRegion changes
         CZWeak<PointerConstraints::RLockedPointer> lockedPointerRes;
         CZWeak<PointerConstraints::RConfinedPointer> confinedPointerRes;
 
@@ -95,6 +97,7 @@ LPRIVATE_CLASS(LSurface)
         CZWeak<DRMSyncObj::RDRMSyncObjSurface> drmSyncObjSurfaceRes;
         LSurfaceBuffer buffer {};
         std::shared_ptr<RImage> image;
+        std::optional<SkColor> solidColor; // Set for single pixel buffers
     };
 
     SkIPoint pos                              { 0, 0 };
@@ -119,6 +122,7 @@ LPRIVATE_CLASS(LSurface)
     std::vector<std::shared_ptr<LSurfaceLock>> acquireTimelineLocks;
 
     UInt32 damageId {};
+    UInt32 syncedSubsurfacesApplied { 0 };
     Int32 lastSentPreferredBufferScale      { -1 };
     CZTransform lastSentPreferredTransform { CZTransform::Normal };
     std::unordered_set<LOutput*> outputs;
@@ -141,6 +145,9 @@ LPRIVATE_CLASS(LSurface)
     void setRole(LBaseSurfaceRole *role, bool notify) noexcept;
     void notifyRoleChange() noexcept;
     void sendPreferredScale() noexcept;
+
+    // Flags the outputs the surface is in with LOutputPrivate::PendingContentUpdate
+    void notifyOutputsContentChange() noexcept;
     bool hasBufferOrPendingBuffer() noexcept;
     void setKeyboardGrabToParent();
     void destroyCursorOrDNDRole();
@@ -148,12 +155,14 @@ LPRIVATE_CLASS(LSurface)
 
     bool bufferToImage(Uncommitted &pending) noexcept;
     void updateDamage(Uncommitted &pending) noexcept;
+    void damageAll() noexcept; // e.g. when the surface stops or starts being presented by the backend
     bool updateDimensions(Int32 widthB, Int32 heightB) noexcept;
 
     void checkTimelines() noexcept;
     void handleCommit() noexcept;
     void unlockCommit(UInt32 commitId) noexcept;
     void applyCommit(Uncommitted &pending) noexcept;
+    void applyState(Uncommitted &pending) noexcept;
     void clearUncommitted(Uncommitted &pending) noexcept;
     void applySubsurfacesOrder(Uncommitted &pending) noexcept;
     bool notifyCommitToSubsurfaces() noexcept;
@@ -0,0 +1,14 @@
+#include <CZ/Louvre/Private/LSurfaceTree.h>
+#include <CZ/Louvre/LCompositor.h>
+
+using namespace CZ;
+
+void LSurfaceTree::Collect(std::vector<LSurface*> &surfaces) noexcept
+{
+    surfaces.reserve(surfaces.size() + compositor()->surfaces().size());
+
+    for (const auto &layer : compositor()->layers())
+        for (LSurface *s : layer)
+            if (!s->parent() && !s->cursorRole())
+                ForEach(s, [&surfaces](LSurface *surface) { surfaces.emplace_back(surface); });
+}
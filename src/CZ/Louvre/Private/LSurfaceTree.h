@@ -0,0 +1,71 @@
+#ifndef CZ_LSURFACETREE_H
+#define CZ_LSURFACETREE_H
+
+#include <CZ/Louvre/Roles/LSurface.h>
+#include <CZ/Louvre/Roles/LSubsurfaceRole.h>
+#include <CZ/Louvre/Roles/LToplevelRole.h>
+#include <CZ/Louvre/Roles/LPopupRole.h>
+#include <CZ/Louvre/Roles/LLayerRole.h>
+#include <vector>
+
+/* Walks surface trees from bottom to top, in the order the default LOutput::paintGL() draws them:
+ * subsurfaces below, the surface, subsurfaces above, child popups and then child toplevels.
+ *
+ * Unmapped surfaces and minimized toplevels are skipped along with their children. */
+
+namespace CZ
+{
+    struct LSurfaceTree
+    {
+        template<class Visitor>
+        static void ForEach(LSurface *s, Visitor &&visit) noexcept
+        {
+            if (!s->mapped() || (s->toplevel() && s->toplevel()->isMinimized())) return;
+
+            ForEachSubsurface(s->subsurfacesBelow(), visit);
+            visit(s);
+            ForEachSubsurface(s->subsurfacesAbove(), visit);
+
+            if (auto *toplevel = s->toplevel())
+            {
+                for (auto *child : toplevel->childPopups())
+                    ForEach(child->surface(), visit);
+
+                for (auto *child : toplevel->childToplevels())
+                    ForEach(child->surface(), visit);
+            }
+            else if (auto *popup = s->popup())
+            {
+                for (auto *child : popup->childPopups())
+                    ForEach(child->surface(), visit);
+            }
+            else if (auto *layerRole = s->layerRole())
+            {
+                for (auto *child : layerRole->childPopups())
+                    ForEach(child->surface(), visit);
+            }
+
+            // Session lock roles only contain subsurfaces
+        }
+
+        // Appends the surfaces of all layers (cursors excluded), from LLayerBackground to LLayerOverlay
+        static void Collect(std::vector<LSurface*> &surfaces) noexcept;
+
+    private:
+        template<class Visitor>
+        static void ForEachSubsurface(const std::vector<LSubsurfaceRole*> &subsurfaces, Visitor &visit) noexcept
+        {
+            for (auto *sub : subsurfaces)
+            {
+                if (!sub->surface()->mapped())
+                    continue;
+
+                ForEachSubsurface(sub->surface()->subsurfacesBelow(), visit);
+                visit(sub->surface());
+                ForEachSubsurface(sub->surface()->subsurfacesAbove(), visit);
+            }
+        }
+    };
+}
+
+#endif // CZ_LSURFACETREE_H
@@ -0,0 +1,292 @@
+#include <CZ/Louvre/Protocols/Wayland/RWlSurface.h>
+#include <CZ/Louvre/Private/LTracer.h>
+#include <CZ/Louvre/Roles/LSurface.h>
+#include <CZ/Louvre/Seat/LOutput.h>
+#include <CZ/Louvre/LCompositor.h>
+#include <CZ/Louvre/LClient.h>
+#include <CZ/Louvre/LLog.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+
+using namespace CZ;
+
+std::atomic<bool> LTracer::s_active { false };
+int LTracer::s_toggleSignal { -1 };
+
+namespace
+{
+    /* Single producer ring, only written by its owner thread.
+     * The events of exited threads are kept until the next dump. */
+    struct Ring
+    {
+        Ring(size_t capacity) noexcept : events(new LTraceEvent[capacity]), capacity(capacity) {}
+        std::unique_ptr<LTraceEvent[]> events;
+        const size_t capacity;
+        std::atomic<UInt64> head { 0 }; // Written by the owner thread
+        UInt64 tail { 0 }; // Events before it were already dumped, only touched by Dump()
+        std::atomic<bool> writing { false }; // See LTracer::Push()
+        std::atomic<bool> exited { false };
+        pid_t tid { gettid() };
+        std::string threadName;
+    };
+
+    std::mutex s_registryMutex;
+    std::vector<std::shared_ptr<Ring>> s_rings;
+    size_t s_ringCapacity { 16384 };
+    UInt32 s_dumpCount { 0 };
+    std::string s_dumpPath;
+
+    // Unregisters the ring when its thread exits
+    struct RingOwner
+    {
+        std::shared_ptr<Ring> ring;
+
+        ~RingOwner() noexcept
+        {
+            if (!ring)
+                return;
+
+            ring->exited = true;
+
+            // Nothing left to dump, otherwise removed by the next Dump()
+            if (!LTracer::Active())
+            {
+                std::lock_guard<std::mutex> lock { s_registryMutex };
+                std::erase(s_rings, ring);
+            }
+        }
+    };
+
+    thread_local RingOwner t_ring;
+
+    Ring &ThreadRing() noexcept
+    {
+        if (!t_ring.ring)
+        {
+            t_ring.ring = std::make_shared<Ring>(s_ringCapacity);
+
+            char name[32] {};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            t_ring.ring->threadName = name;
+
+            std::lock_guard<std::mutex> lock { s_registryMutex };
+            s_rings.emplace_back(t_ring.ring);
+        }
+
+        return *t_ring.ring;
+    }
+
+    void AppendEscaped(std::string &out, const char *str) noexcept
+    {
+        for (; *str; str++)
+        {
+            if (*str == '"' || *str == '\\')
+                out += '\\';
+            else if (static_cast<unsigned char>(*str) < 0x20)
+                continue;
+
+            out += *str;
+        }
+    }
+}
+
+void LTracer::SetActive(bool active) noexcept
+{
+#ifdef CZ_LOUVRE_TRACING
+    if (active == Active())
+        return;
+
+    // Sequentially consistent, pairs with the one in Push()
+    s_active.store(active);
+
+    if (active)
+    {
+        LLog(CZInfo, CZLN, "Frame tracing started");
+        return;
+    }
+
+    std::string path { s_dumpPath };
+
+    if (path.empty())
+        path = std::format("/tmp/louvre-trace-{}-{}.json", getpid(), s_dumpCount++);
+
+    if (Dump(path))
+        LLog(CZInfo, CZLN, "Frame tracing stopped, trace written to {}", path);
+#else
+    if (active)
+        LLog(CZWarning, CZLN, "Frame tracing is not available (built without the tracing option)");
+#endif
+}
+
+void LTracer::Init() noexcept
+{
+    if (const char *env = getenv("CZ_LOUVRE_TRACE_BUFFER"))
+        s_ringCapacity = std::clamp(atoi(env), 1024, 1 << 22);
+
+    if (const char *env = getenv("CZ_LOUVRE_TRACE_FILE"))
+        s_dumpPath = env;
+
+    if (const char *env = getenv("CZ_LOUVRE_TRACE_SIGNAL"))
+    {
+        const int signal { atoi(env) };
+
+#ifdef CZ_LOUVRE_TRACING
+        if (signal > 0 && compositor()->addPosixSignal(signal))
+            s_toggleSignal = signal;
+#else
+        CZ_UNUSED(signal)
+#endif
+    }
+
+    if (const char *env = getenv("CZ_LOUVRE_TRACE"))
+        SetActive(atoi(env) == 1);
+}
+
+void LTracer::Unit() noexcept
+{
+    SetActive(false);
+    s_toggleSignal = -1;
+}
+
+UInt64 LTracer::Now() noexcept
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return UInt64(ts.tv_sec) * 1000000000ULL + UInt64(ts.tv_nsec);
+}
+
+void LTracer::Push(const LTraceEvent &event) noexcept
+{
+    Ring &ring { ThreadRing() };
+
+    /* Scopes started before tracing was disabled end here, either Dump() sees
+     * the ring being written and waits, or this sees tracing disabled */
+    ring.writing.store(true);
+
+    if (!s_active.load())
+    {
+        ring.writing.store(false, std::memory_order_release);
+        return;
+    }
+
+    const UInt64 head { ring.head.load(std::memory_order_relaxed) };
+    ring.events[head % ring.capacity] = event;
+    ring.head.store(head + 1, std::memory_order_release);
+    ring.writing.store(false, std::memory_order_release);
+}
+
+bool LTracer::Dump(const std::string &path) noexcept
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+
+    {
+        std::lock_guard<std::mutex> lock { s_registryMutex };
+        rings = s_rings;
+    }
+
+    FILE *file { fopen(path.c_str(), "w") };
+
+    if (!file)
+    {
+        LLog(CZError, CZLN, "Failed to open trace file {}", path);
+        return false;
+    }
+
+    // Wait for pushes that started before tracing was disabled
+    for (const auto &ring : rings)
+        while (ring->writing.load(std::memory_order_acquire))
+            sched_yield();
+
+    const pid_t pid { getpid() };
+    std::string out { "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" };
+    bool first { true };
+
+    for (const auto &ring : rings)
+    {
+        if (!first) out += ",\n";
+        first = false;
+        out += std::format(R"({{"name":"thread_name","ph":"M","pid":{},"tid":{},"args":{{"name":")", pid, ring->tid);
+        AppendEscaped(out, ring->threadName.c_str());
+        out += "\"}}";
+
+        const UInt64 head { ring->head.load(std::memory_order_acquire) };
+        const UInt64 tail { std::max(ring->tail, head > ring->capacity ? head - ring->capacity : 0) };
+
+        // Don't dump them again the next time
+        ring->tail = head;
+
+        for (UInt64 i = tail; i < head; i++)
+        {
+            const LTraceEvent &e { ring->events[i % ring->capacity] };
+
+            out += std::format(R"(,{}{{"name":"{}","cat":"louvre","ph":"X","pid":{},"tid":{},"ts":{:.3f},"dur":{:.3f},"args":{{)",
+                '\n', e.name, pid, ring->tid, double(e.begin) / 1000.0, double(e.end - e.begin) / 1000.0);
+
+            bool firstArg { true };
+
+            if (e.output[0] != '\0')
+            {
+                out += "\"output\":\"";
+                AppendEscaped(out, e.output);
+                out += '"';
+                firstArg = false;
+            }
+
+            if (e.clientPid >= 0)
+            {
+                out += std::format(R"({}"client_pid":{},"surface":{},"commit":{})", firstArg ? "" : ",", e.clientPid, e.surfaceId, e.commitId);
+                firstArg = false;
+            }
+
+            out += "}}";
+        }
+
+        // Flush per ring to keep the buffer small
+        fwrite(out.data(), 1, out.size(), file);
+        out.clear();
+    }
+
+    out += "\n]}\n";
+    fwrite(out.data(), 1, out.size(), file);
+    fclose(file);
+
+    // Already dumped, nothing else will be pushed
+    {
+        std::lock_guard<std::mutex> lock { s_registryMutex };
+        std::erase_if(s_rings, [](const auto &ring) { return ring->exited.load(); });
+    }
+
+    return true;
+}
+
+void LTraceScope::setOutput(const LOutput *output) noexcept
+{
+    if (!output)
+        return;
+
+    const std::string &name { output->name() };
+    const size_t len { std::min(name.size(), sizeof(m_event.output) - 1) };
+    memcpy(m_event.output, name.data(), len);
+    m_event.output[len] = '\0';
+}
+
+void LTraceScope::setSurface(const LSurface *surface, UInt32 commitId) noexcept
+{
+    if (!surface)
+        return;
+
+    pid_t pid { -1 };
+    surface->client()->credentials(&pid);
+    m_event.clientPid = pid;
+    m_event.surfaceId = surface->surfaceResource()->id();
+    m_event.commitId = commitId;
+}
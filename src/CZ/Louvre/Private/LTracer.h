@@ -0,0 +1,122 @@
+#ifndef CZ_LTRACER_H
+#define CZ_LTRACER_H
+
+#include <CZ/Louvre/Louvre.h>
+#include <atomic>
+#include <string>
+
+/* Frame tracing
+ *
+ * Scoped spans are recorded into per-thread ring buffers and dumped as Chrome trace JSON
+ * (also loadable by Perfetto). Spans are compiled out unless CZ_LOUVRE_TRACING is defined
+ * (see the "tracing" meson option) and cost a single relaxed atomic load while inactive.
+ *
+ * See the CZ_LOUVRE_TRACE* environment variables. */
+
+namespace CZ
+{
+    struct LTraceEvent
+    {
+        const char *name;   // Must be a string literal
+        UInt64 begin;       // Monotonic ns
+        UInt64 end;
+        char output[16];    // Output name, empty if none
+        Int32 clientPid;    // -1 if none
+        UInt32 surfaceId;   // wl_surface id, 0 if none
+        UInt32 commitId;
+    };
+
+    class LTracer
+    {
+    public:
+        static bool Active() noexcept { return s_active.load(std::memory_order_relaxed); }
+
+        // Deactivating dumps the recorded events
+        static void SetActive(bool active) noexcept;
+        static void Toggle() noexcept { SetActive(!Active()); }
+
+        // Reads the env vars and registers the toggle signal, called once the compositor is initialized
+        static void Init() noexcept;
+
+        // Dumps if active
+        static void Unit() noexcept;
+
+        // POSIX signal that toggles tracing, -1 if none
+        static int ToggleSignal() noexcept { return s_toggleSignal; }
+
+        // Writes all ring buffers as Chrome trace JSON
+        static bool Dump(const std::string &path) noexcept;
+
+        static UInt64 Now() noexcept;
+        static void Push(const LTraceEvent &event) noexcept;
+    private:
+        static std::atomic<bool> s_active;
+        static int s_toggleSignal;
+    };
+
+    class LTraceScope
+    {
+    public:
+        LTraceScope(const char *name) noexcept
+        {
+            if (LTracer::Active())
+                begin(name);
+        }
+
+        LTraceScope(const char *name, const LOutput *output) noexcept
+        {
+            if (LTracer::Active())
+            {
+                begin(name);
+                setOutput(output);
+            }
+        }
+
+        LTraceScope(const char *name, const LSurface *surface, UInt32 commitId) noexcept
+        {
+            if (LTracer::Active())
+            {
+                begin(name);
+                setSurface(surface, commitId);
+            }
+        }
+
+        ~LTraceScope() noexcept
+        {
+            if (!m_recording)
+                return;
+
+            m_event.end = LTracer::Now();
+            LTracer::Push(m_event);
+        }
+
+        LTraceScope(const LTraceScope&) = delete;
+        LTraceScope &operator=(const LTraceScope&) = delete;
+    private:
+        void begin(const char *name) noexcept
+        {
+            m_recording = true;
+            m_event.name = name;
+            m_event.output[0] = '\0';
+            m_event.clientPid = -1;
+            m_event.surfaceId = 0;
+            m_event.commitId = 0;
+            m_event.begin = LTracer::Now();
+        }
+
+        void setOutput(const LOutput *output) noexcept;
+        void setSurface(const LSurface *surface, UInt32 commitId) noexcept;
+        LTraceEvent m_event;
+        bool m_recording { false };
+    };
+}
+
+#ifdef CZ_LOUVRE_TRACING
+#define LTRACE_CONCAT_(a, b) a##b
+#define LTRACE_CONCAT(a, b) LTRACE_CONCAT_(a, b)
+#define LTRACE_SCOPE(...) const CZ::LTraceScope LTRACE_CONCAT(lTraceScope, __LINE__) { __VA_ARGS__ }
+#else
+#define LTRACE_SCOPE(...)
+#endif
+
+#endif // CZ_LTRACER_H
@@ -95,10 +95,20 @@ void GDRMSyncObjManager::get_surface(wl_client */*client*/, wl_resource *resourc
 void GDRMSyncObjManager::import_timeline(wl_client */*client*/, wl_resource *resource, UInt32 id, Int32 fd) noexcept
 {
     auto &res { *static_cast<GDRMSyncObjManager*>(wl_resource_get_user_data(resource)) };
+
+    // Released by RDRMSyncObjTimeline
+    if (!res.client()->imp()->acquireFds(1, true))
+    {
+        close(fd);
+        wl_client_post_no_memory(res.client()->client());
+        return;
+    }
+
     auto timeline { RDRMTimeline::Import(fd, CZOwn::Own) };
 
     if (!timeline)
     {
+        res.client()->imp()->releaseFds(1);
         res.postError(WP_LINUX_DRM_SYNCOBJ_MANAGER_V1_ERROR_INVALID_TIMELINE, "Failed to import timeline");
         return;
     }
@@ -2,6 +2,7 @@
 #include <CZ/Louvre/Protocols/DRMSyncObj/linux-drm-syncobj-v1.h>
 #include <CZ/Core/Utils/CZVectorUtils.h>
 #include <CZ/Louvre/Roles/LToplevelRole.h>
+#include <CZ/Louvre/Private/LClientPrivate.h>
 
 using namespace CZ::Protocols::DRMSyncObj;
 
@@ -28,6 +29,12 @@ RDRMSyncObjTimeline::RDRMSyncObjTimeline
     m_timeline(std::move(timeline))
 {}
 
+RDRMSyncObjTimeline::~RDRMSyncObjTimeline() noexcept
+{
+    // Acquired by GDRMSyncObjManager::import_timeline()
+    client()->imp()->releaseFds(1);
+}
+
 /******************** REQUESTS ********************/
 
 void RDRMSyncObjTimeline::destroy(wl_client */*client*/, wl_resource *resource)
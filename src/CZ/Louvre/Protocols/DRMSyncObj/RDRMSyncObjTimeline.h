@@ -17,7 +17,7 @@ public:
 private:
     friend class GDRMSyncObjManager;
     RDRMSyncObjTimeline(std::shared_ptr<RDRMTimeline> &&timeline, LClient *client, Int32 version, UInt32 id);
-    ~RDRMSyncObjTimeline() noexcept = default;
+    ~RDRMSyncObjTimeline() noexcept;
     std::shared_ptr<RDRMTimeline> m_timeline;
 };
 
@@ -0,0 +1,86 @@
+#include <CZ/Louvre/Protocols/ImageCopyCapture/GImageCopyCaptureManager.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureCursorSession.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/ext-image-copy-capture-v1.h>
+#include <CZ/Louvre/Protocols/ImageCaptureSource/RImageCaptureSource.h>
+#include <CZ/Louvre/Private/LClientPrivate.h>
+#include <CZ/Louvre/LCompositor.h>
+#include <CZ/Louvre/LLog.h>
+#include <CZ/Core/Utils/CZVectorUtils.h>
+
+using namespace CZ::Protocols::ImageCopyCapture;
+using namespace CZ;
+
+static const struct ext_image_copy_capture_manager_v1_interface imp
+{
+    .create_session = &GImageCopyCaptureManager::create_session,
+    .create_pointer_cursor_session = &GImageCopyCaptureManager::create_pointer_cursor_session,
+    .destroy = &GImageCopyCaptureManager::destroy
+};
+
+LGLOBAL_INTERFACE_IMP(GImageCopyCaptureManager, LOUVRE_IMAGE_COPY_CAPTURE_MANAGER_VERSION, ext_image_copy_capture_manager_v1_interface)
+
+bool GImageCopyCaptureManager::Probe(CZWeak<LGlobal> **slot) noexcept
+{
+    if (compositor()->wellKnownGlobals.ImageCopyCaptureManager)
+    {
+        LLog(CZError, CZLN, "Failed to create {} global (already created)", Interface()->name);
+        return false;
+    }
+
+    *slot = &compositor()->wellKnownGlobals.ImageCopyCaptureManager;
+    return true;
+}
+
+GImageCopyCaptureManager::GImageCopyCaptureManager(
+    wl_client *client,
+    Int32 version,
+    UInt32 id
+    )
+    :LResource
+    (
+        client,
+        Interface(),
+        version,
+        id,
+        &imp
+    )
+{
+    this->client()->imp()->imageCopyCaptureManagerGlobals.emplace_back(this);
+}
+
+GImageCopyCaptureManager::~GImageCopyCaptureManager() noexcept
+{
+    CZVectorUtils::RemoveOneUnordered(client()->imp()->imageCopyCaptureManagerGlobals, this);
+}
+
+/******************** REQUESTS ********************/
+
+void GImageCopyCaptureManager::destroy(wl_client */*client*/, wl_resource *resource) noexcept
+{
+    wl_resource_destroy(resource);
+}
+
+void GImageCopyCaptureManager::create_session(wl_client */*client*/, wl_resource *resource, UInt32 id, wl_resource *source, UInt32 options) noexcept
+{
+    auto &res { *static_cast<GImageCopyCaptureManager*>(wl_resource_get_user_data(resource)) };
+
+    if (options & ~EXT_IMAGE_COPY_CAPTURE_MANAGER_V1_OPTIONS_PAINT_CURSORS)
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_MANAGER_V1_ERROR_INVALID_OPTION, "Invalid options bitfield {}.", options);
+        return;
+    }
+
+    new RImageCopyCaptureSession(
+        res.client(),
+        res.version(),
+        id,
+        static_cast<ImageCaptureSource::RImageCaptureSource*>(wl_resource_get_user_data(source)),
+        options & EXT_IMAGE_COPY_CAPTURE_MANAGER_V1_OPTIONS_PAINT_CURSORS);
+}
+
+void GImageCopyCaptureManager::create_pointer_cursor_session(wl_client */*client*/, wl_resource *resource, UInt32 id, wl_resource */*source*/, wl_resource */*pointer*/) noexcept
+{
+    auto &res { *static_cast<GImageCopyCaptureManager*>(wl_resource_get_user_data(resource)) };
+    new RImageCopyCaptureCursorSession(res.client(), res.version(), id);
+}
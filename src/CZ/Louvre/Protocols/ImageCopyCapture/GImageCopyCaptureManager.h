@@ -0,0 +1,18 @@
+#ifndef GIMAGECOPYCAPTUREMANAGER_H
+#define GIMAGECOPYCAPTUREMANAGER_H
+
+#include <CZ/Louvre/LResource.h>
+
+class CZ::Protocols::ImageCopyCapture::GImageCopyCaptureManager final : public LResource
+{
+public:
+    static void destroy(wl_client *client, wl_resource *resource) noexcept;
+    static void create_session(wl_client *client, wl_resource *resource, UInt32 id, wl_resource *source, UInt32 options) noexcept;
+    static void create_pointer_cursor_session(wl_client *client, wl_resource *resource, UInt32 id, wl_resource *source, wl_resource *pointer) noexcept;
+private:
+    LGLOBAL_INTERFACE
+    GImageCopyCaptureManager(wl_client *client, Int32 version, UInt32 id);
+    ~GImageCopyCaptureManager() noexcept;
+};
+
+#endif // GIMAGECOPYCAPTUREMANAGER_H
@@ -0,0 +1,47 @@
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureCursorSession.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/ext-image-copy-capture-v1.h>
+
+using namespace CZ::Protocols::ImageCopyCapture;
+
+static const struct ext_image_copy_capture_cursor_session_v1_interface imp
+{
+    .destroy = &RImageCopyCaptureCursorSession::destroy,
+    .get_capture_session = &RImageCopyCaptureCursorSession::get_capture_session
+};
+
+RImageCopyCaptureCursorSession::RImageCopyCaptureCursorSession
+    (LClient *client,
+     Int32 version,
+     UInt32 id
+     ) noexcept
+    :LResource
+    (
+        client,
+        &ext_image_copy_capture_cursor_session_v1_interface,
+        version,
+        id,
+        &imp
+    )
+{}
+
+/******************** REQUESTS ********************/
+
+void RImageCopyCaptureCursorSession::destroy(wl_client */*client*/, wl_resource *resource) noexcept
+{
+    wl_resource_destroy(resource);
+}
+
+void RImageCopyCaptureCursorSession::get_capture_session(wl_client */*client*/, wl_resource *resource, UInt32 id) noexcept
+{
+    auto &res { *static_cast<RImageCopyCaptureCursorSession*>(wl_resource_get_user_data(resource)) };
+
+    if (res.m_sessionCreated)
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_CURSOR_SESSION_V1_ERROR_DUPLICATE_SESSION, "get_capture_session already sent.");
+        return;
+    }
+
+    res.m_sessionCreated = true;
+    new RImageCopyCaptureSession(res.client(), res.version(), id, nullptr, false);
+}
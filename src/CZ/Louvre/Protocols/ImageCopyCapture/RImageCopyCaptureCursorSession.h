@@ -0,0 +1,24 @@
+#ifndef RIMAGECOPYCAPTURECURSORSESSION_H
+#define RIMAGECOPYCAPTURECURSORSESSION_H
+
+#include <CZ/Louvre/LResource.h>
+
+/* Cursor capture is not supported yet, the capture session
+ * returned by get_capture_session is created already stopped */
+class CZ::Protocols::ImageCopyCapture::RImageCopyCaptureCursorSession final : public LResource
+{
+public:
+
+    /******************** REQUESTS ********************/
+
+    static void destroy(wl_client *client, wl_resource *resource) noexcept;
+    static void get_capture_session(wl_client *client, wl_resource *resource, UInt32 id) noexcept;
+
+private:
+    friend class GImageCopyCaptureManager;
+    RImageCopyCaptureCursorSession(LClient *client, Int32 version, UInt32 id) noexcept;
+    ~RImageCopyCaptureCursorSession() = default;
+    bool m_sessionCreated { false };
+};
+
+#endif // RIMAGECOPYCAPTURECURSORSESSION_H
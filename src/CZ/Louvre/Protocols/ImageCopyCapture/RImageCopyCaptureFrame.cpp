@@ -0,0 +1,136 @@
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureFrame.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/ext-image-copy-capture-v1.h>
+
+using namespace CZ::Protocols::ImageCopyCapture;
+
+static const struct ext_image_copy_capture_frame_v1_interface imp
+{
+    .destroy = &RImageCopyCaptureFrame::destroy,
+    .attach_buffer = &RImageCopyCaptureFrame::attach_buffer,
+    .damage_buffer = &RImageCopyCaptureFrame::damage_buffer,
+    .capture = &RImageCopyCaptureFrame::capture
+};
+
+RImageCopyCaptureFrame::RImageCopyCaptureFrame
+    (RImageCopyCaptureSession &session,
+     UInt32 id
+     ) noexcept
+    :LResource
+    (
+        session.client(),
+        &ext_image_copy_capture_frame_v1_interface,
+        session.version(),
+        id,
+        &imp
+    ),
+    m_session(&session)
+{}
+
+/******************** REQUESTS ********************/
+
+void RImageCopyCaptureFrame::destroy(wl_client */*client*/, wl_resource *resource) noexcept
+{
+    wl_resource_destroy(resource);
+}
+
+void RImageCopyCaptureFrame::attach_buffer(wl_client */*client*/, wl_resource *resource, wl_resource *buffer) noexcept
+{
+    auto &res { *static_cast<RImageCopyCaptureFrame*>(wl_resource_get_user_data(resource)) };
+
+    if (res.m_captured)
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_ERROR_ALREADY_CAPTURED, "attach_buffer sent after capture.");
+        return;
+    }
+
+    res.m_buffer.setResource(buffer);
+}
+
+void RImageCopyCaptureFrame::damage_buffer(wl_client */*client*/, wl_resource *resource, Int32 x, Int32 y, Int32 width, Int32 height) noexcept
+{
+    auto &res { *static_cast<RImageCopyCaptureFrame*>(wl_resource_get_user_data(resource)) };
+
+    if (res.m_captured)
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_ERROR_ALREADY_CAPTURED, "damage_buffer sent after capture.");
+        return;
+    }
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0)
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_ERROR_INVALID_BUFFER_DAMAGE, "Invalid buffer damage ({}, {}, {}, {}).", x, y, width, height);
+        return;
+    }
+
+    res.m_bufferDamage.op(SkIRect::MakeXYWH(x, y, width, height), SkRegion::kUnion_Op);
+}
+
+void RImageCopyCaptureFrame::capture(wl_client */*client*/, wl_resource *resource) noexcept
+{
+    auto &res { *static_cast<RImageCopyCaptureFrame*>(wl_resource_get_user_data(resource)) };
+
+    if (res.m_captured)
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_ERROR_ALREADY_CAPTURED, "capture already sent.");
+        return;
+    }
+
+    if (!res.buffer())
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_ERROR_NO_BUFFER, "capture sent without an attached buffer.");
+        return;
+    }
+
+    res.m_captured = true;
+
+    if (res.session())
+        res.session()->handleCaptureRequest();
+    else
+        res.failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_STOPPED);
+}
+
+/******************** EVENTS ********************/
+
+void RImageCopyCaptureFrame::transform(CZTransform transform) noexcept
+{
+    ext_image_copy_capture_frame_v1_send_transform(resource(), static_cast<UInt32>(transform));
+}
+
+void RImageCopyCaptureFrame::damage(const SkRegion &region) noexcept
+{
+    SkRegion::Iterator it { region };
+
+    while (!it.done())
+    {
+        ext_image_copy_capture_frame_v1_send_damage(resource(),
+            it.rect().x(), it.rect().y(), it.rect().width(), it.rect().height());
+        it.next();
+    }
+}
+
+void RImageCopyCaptureFrame::presentationTime(const timespec &time) noexcept
+{
+    ext_image_copy_capture_frame_v1_send_presentation_time(resource(),
+        UInt64(time.tv_sec) >> 32,
+        UInt64(time.tv_sec) & 0xffffffff,
+        time.tv_nsec);
+}
+
+void RImageCopyCaptureFrame::ready() noexcept
+{
+    if (m_finished)
+        return;
+
+    m_finished = true;
+    ext_image_copy_capture_frame_v1_send_ready(resource());
+}
+
+void RImageCopyCaptureFrame::failed(UInt32 reason) noexcept
+{
+    if (m_finished)
+        return;
+
+    m_finished = true;
+    ext_image_copy_capture_frame_v1_send_failed(resource(), reason);
+}
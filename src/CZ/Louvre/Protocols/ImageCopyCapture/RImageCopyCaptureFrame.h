@@ -0,0 +1,49 @@
+#ifndef RIMAGECOPYCAPTUREFRAME_H
+#define RIMAGECOPYCAPTUREFRAME_H
+
+#include <CZ/Louvre/LResource.h>
+#include <CZ/Louvre/Private/LResourceRef.h>
+#include <CZ/Core/CZWeak.h>
+#include <CZ/skia/core/SkRegion.h>
+
+class CZ::Protocols::ImageCopyCapture::RImageCopyCaptureFrame final : public LResource
+{
+public:
+    RImageCopyCaptureSession *session() const noexcept { return m_session; }
+
+    // The attached wl_buffer (nullptr if none or destroyed)
+    wl_resource *buffer() const noexcept { return m_buffer.res(); }
+
+    // Accumulated client damage since the buffer was last captured
+    const SkRegion &bufferDamage() const noexcept { return m_bufferDamage; }
+
+    // True after the capture request and until ready or failed are sent
+    bool isPending() const noexcept { return m_captured && !m_finished; }
+
+    /******************** REQUESTS ********************/
+
+    static void destroy(wl_client *client, wl_resource *resource) noexcept;
+    static void attach_buffer(wl_client *client, wl_resource *resource, wl_resource *buffer) noexcept;
+    static void damage_buffer(wl_client *client, wl_resource *resource, Int32 x, Int32 y, Int32 width, Int32 height) noexcept;
+    static void capture(wl_client *client, wl_resource *resource) noexcept;
+
+    /******************** EVENTS ********************/
+
+    void transform(CZTransform transform) noexcept;
+    void damage(const SkRegion &region) noexcept;
+    void presentationTime(const timespec &time) noexcept;
+    void ready() noexcept;
+    void failed(UInt32 reason) noexcept;
+
+private:
+    friend class RImageCopyCaptureSession;
+    RImageCopyCaptureFrame(RImageCopyCaptureSession &session, UInt32 id) noexcept;
+    ~RImageCopyCaptureFrame() = default;
+    CZWeak<RImageCopyCaptureSession> m_session;
+    LResourceRef m_buffer;
+    SkRegion m_bufferDamage;
+    bool m_captured { false };
+    bool m_finished { false };
+};
+
+#endif // RIMAGECOPYCAPTUREFRAME_H
@@ -0,0 +1,582 @@
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureFrame.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/ext-image-copy-capture-v1.h>
+#include <CZ/Louvre/Protocols/ImageCaptureSource/RImageCaptureSource.h>
+#include <CZ/Louvre/Protocols/ForeignToplevelList/RForeignToplevelHandle.h>
+#include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
+#include <CZ/Louvre/Protocols/Wayland/GOutput.h>
+#include <CZ/Louvre/Private/LOutputPrivate.h>
+#include <CZ/Louvre/Roles/LSubsurfaceRole.h>
+#include <CZ/Louvre/Roles/LToplevelRole.h>
+#include <CZ/Louvre/Roles/LSurface.h>
+#include <CZ/Louvre/Seat/LOutputMode.h>
+#include <CZ/Louvre/LLog.h>
+#include <CZ/Ream/RCore.h>
+#include <CZ/Ream/RDevice.h>
+#include <CZ/Ream/RSurface.h>
+#include <CZ/Ream/RPass.h>
+#include <CZ/Ream/WL/RWLFormat.h>
+#include <CZ/Core/Utils/CZVectorUtils.h>
+#include <algorithm>
+#include <time.h>
+
+using namespace CZ::Protocols::ImageCopyCapture;
+
+static const struct ext_image_copy_capture_session_v1_interface imp
+{
+    .create_frame = &RImageCopyCaptureSession::create_frame,
+    .destroy = &RImageCopyCaptureSession::destroy
+};
+
+// XRGB8888 shares the ARGB8888 memory layout, so both are read back as ARGB8888
+static constexpr RFormat SupportedFormats[] { DRM_FORMAT_ARGB8888, DRM_FORMAT_XRGB8888 };
+
+// Same constraints advertised by sendConstraints()
+static bool IsAdvertisedDMAFormat(RFormat format, RModifier modifier) noexcept
+{
+    auto *dev { RCore::Get()->mainDevice() };
+
+    if (dev->id() == 0 || std::find(std::begin(SupportedFormats), std::end(SupportedFormats), format) == std::end(SupportedFormats))
+        return false;
+
+    const auto fmt { dev->dmaTextureFormats().formats().find(format) };
+    return fmt != dev->dmaTextureFormats().formats().end() && fmt->modifiers().contains(modifier);
+}
+
+RImageCopyCaptureSession::RImageCopyCaptureSession
+    (LClient *client,
+     Int32 version,
+     UInt32 id,
+     ImageCaptureSource::RImageCaptureSource *source,
+     bool paintCursors
+     ) noexcept
+    :LResource
+    (
+        client,
+        &ext_image_copy_capture_session_v1_interface,
+        version,
+        id,
+        &imp
+    ),
+    m_paintCursors(paintCursors)
+{
+    if (source && source->source())
+    {
+        m_sourceType = source->type();
+
+        if (m_sourceType == LImageCaptureSourceType::Output)
+            m_output.reset(static_cast<Wayland::GOutput*>(source->source())->output());
+        else
+            m_toplevelRole.reset(static_cast<ForeignToplevelList::RForeignToplevelHandle*>(source->source())->toplevelRole());
+    }
+
+    if (m_output && m_output->state() == LOutput::Initialized)
+        m_output->imp()->imageCopyCaptureSessions.emplace_back(this);
+    else if (m_toplevelRole && m_toplevelRole->surface()->mapped())
+        m_toplevelRole->m_imageCopyCaptureSessions.emplace_back(this);
+    else
+    {
+        m_output.reset();
+        m_toplevelRole.reset();
+        m_stopped = true;
+        stopped();
+        return;
+    }
+
+    updateConstraints();
+}
+
+RImageCopyCaptureSession::~RImageCopyCaptureSession() noexcept
+{
+    unlink();
+
+    if (m_frame && m_frame->isPending())
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_STOPPED);
+}
+
+void RImageCopyCaptureSession::unlink() noexcept
+{
+    if (m_output)
+        CZVectorUtils::RemoveOneUnordered(m_output->imp()->imageCopyCaptureSessions, this);
+
+    if (m_toplevelRole)
+        CZVectorUtils::RemoveOneUnordered(m_toplevelRole->m_imageCopyCaptureSessions, this);
+
+    m_output.reset();
+    m_toplevelRole.reset();
+}
+
+void RImageCopyCaptureSession::stop() noexcept
+{
+    if (m_stopped)
+        return;
+
+    m_stopped = true;
+    unlink();
+    m_dstImages.clear();
+    m_shmImage.reset();
+
+    if (m_frame && m_frame->isPending())
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_STOPPED);
+
+    stopped();
+}
+
+void RImageCopyCaptureSession::HandleOutputPaint(LOutput *output) noexcept
+{
+    for (auto *session : output->imp()->imageCopyCaptureSessions)
+    {
+        session->updateConstraints();
+
+        // output->damage is already in buffer coords
+        session->m_damage.op(output->damage, SkRegion::kUnion_Op);
+
+        if (session->m_frame && session->m_frame->isPending() && !session->m_damage.isEmpty())
+            session->copyOutput();
+    }
+}
+
+void RImageCopyCaptureSession::HandleSurfaceCommit(LSurface *surface) noexcept
+{
+    LSurface *root { surface };
+    SkIPoint offset { 0, 0 };
+
+    // Subsurfaces are captured along with their toplevel
+    while (root->subsurface() && root->parent())
+    {
+        offset += root->subsurface()->localPos();
+        root = root->parent();
+    }
+
+    LToplevelRole *toplevel { root->toplevel() };
+
+    if (!toplevel || toplevel->m_imageCopyCaptureSessions.empty())
+        return;
+
+    for (auto *session : toplevel->m_imageCopyCaptureSessions)
+    {
+        session->updateConstraints();
+
+        // Surface damage to window geometry local buffer coords
+        const SkIPoint geoPos { toplevel->windowGeometry().topLeft() };
+        const Float32 s { session->m_scale };
+        SkRegion::Iterator it { surface->damage() };
+
+        while (!it.done())
+        {
+            const SkIRect r { it.rect().makeOffset(offset - geoPos) };
+            session->m_damage.op(SkIRect::MakeLTRB(
+                SkScalarFloorToInt(Float32(r.left()) * s) - 1,
+                SkScalarFloorToInt(Float32(r.top()) * s) - 1,
+                SkScalarCeilToInt(Float32(r.right()) * s) + 1,
+                SkScalarCeilToInt(Float32(r.bottom()) * s) + 1),
+                SkRegion::kUnion_Op);
+            it.next();
+        }
+
+        session->m_damage.op(SkIRect::MakeSize(session->m_bufferSize), SkRegion::kIntersect_Op);
+
+        if (session->m_frame && session->m_frame->isPending() && !session->m_damage.isEmpty())
+            session->copyToplevel();
+    }
+}
+
+void RImageCopyCaptureSession::updateConstraints() noexcept
+{
+    SkISize size { 0, 0 };
+
+    if (m_output)
+        size = m_output->currentMode()->size();
+    else if (m_toplevelRole)
+    {
+        // Captured at the highest scale of the outputs the toplevel is on
+        m_scale = 1.f;
+
+        for (LOutput *o : m_toplevelRole->surface()->outputs())
+            m_scale = std::max(m_scale, o->fractionalScale());
+
+        const SkIRect geo { m_toplevelRole->windowGeometry() };
+        size.set(
+            SkScalarRoundToInt(Float32(geo.width()) * m_scale),
+            SkScalarRoundToInt(Float32(geo.height()) * m_scale));
+    }
+
+    if (size.isEmpty() || size == m_bufferSize)
+        return;
+
+    m_bufferSize = size;
+    m_damage.setRect(SkIRect::MakeSize(m_bufferSize));
+    m_shmImage.reset();
+    sendConstraints();
+
+    if (m_frame && m_frame->isPending())
+        validateBuffer();
+}
+
+void RImageCopyCaptureSession::sendConstraints() noexcept
+{
+    bufferSize(m_bufferSize.width(), m_bufferSize.height());
+    shmFormat(WL_SHM_FORMAT_ARGB8888);
+    shmFormat(WL_SHM_FORMAT_XRGB8888);
+
+    auto *dev { RCore::Get()->mainDevice() };
+
+    if (dev->id() != 0)
+    {
+        dev_t devId { dev->id() };
+        wl_array device {
+            .size = sizeof(devId),
+            .alloc = 0,
+            .data = (void *)&devId,
+        };
+
+        dmabufDevice(&device);
+
+        for (const RFormat format : SupportedFormats)
+        {
+            auto fmt { dev->dmaTextureFormats().formats().find(format) };
+
+            if (fmt == dev->dmaTextureFormats().formats().end())
+                continue;
+
+            std::vector<RModifier> mods(fmt->modifiers().begin(), fmt->modifiers().end());
+            wl_array modifiers {
+                .size = mods.size() * sizeof(RModifier),
+                .alloc = 0,
+                .data = (void *)mods.data(),
+            };
+
+            dmabufFormat(format, &modifiers);
+        }
+    }
+
+    done();
+}
+
+bool RImageCopyCaptureSession::validateBuffer() noexcept
+{
+    wl_resource *buffer { m_frame->buffer() };
+    bool valid { false };
+
+    if (!buffer || m_bufferSize.isEmpty())
+        valid = false;
+    else if (auto *shm { wl_shm_buffer_get(buffer) })
+    {
+        const RFormat format { RWLFormat::ToDRM((wl_shm_format)wl_shm_buffer_get_format(shm)) };
+        valid = wl_shm_buffer_get_width(shm) == m_bufferSize.width() &&
+                wl_shm_buffer_get_height(shm) == m_bufferSize.height() &&
+                (format == DRM_FORMAT_ARGB8888 || format == DRM_FORMAT_XRGB8888);
+    }
+    else if (LDMABuffer::isDMABuffer(buffer))
+    {
+        const auto &info { static_cast<LDMABuffer*>(wl_resource_get_user_data(buffer))->dmaInfo() };
+        valid = Int32(info.width) == m_bufferSize.width() &&
+                Int32(info.height) == m_bufferSize.height() &&
+                IsAdvertisedDMAFormat(info.format, info.modifier);
+    }
+
+    if (!valid)
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_BUFFER_CONSTRAINTS);
+
+    return valid;
+}
+
+void RImageCopyCaptureSession::handleCaptureRequest() noexcept
+{
+    if (m_stopped)
+    {
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_STOPPED);
+        return;
+    }
+
+    if (!validateBuffer())
+        return;
+
+    // Nothing changed since the last ready frame, wait for new damage
+    if (m_damage.isEmpty())
+        return;
+
+    // Output images are only complete right after a paintGL()
+    if (m_output)
+        m_output->repaint();
+    else
+        copyToplevel();
+}
+
+std::shared_ptr<RImage> RImageCopyCaptureSession::dstImage(LDMABuffer *buffer) noexcept
+{
+    for (auto it = m_dstImages.begin(); it != m_dstImages.end();)
+    {
+        if (!it->buffer)
+            it = m_dstImages.erase(it);
+        else if (it->buffer.get() == buffer)
+            return it->image;
+        else
+            it++;
+    }
+
+    auto *dev { RCore::Get()->mainDevice() };
+    auto image { buffer->image() };
+
+    // Re-import the buffer if the sampling image can't be rendered into
+    if (!image || image->checkDeviceCaps(RImageCap_Dst, dev).get() != RImageCap_Dst)
+    {
+        RImageConstraints cons {};
+        cons.allocator = dev;
+        cons.caps[dev] = RImageCap_Dst;
+        image = RImage::FromDMA(buffer->dmaInfo(), CZOwn::Borrow, &cons);
+    }
+
+    if (!image)
+    {
+        LLog(CZError, CZLN, "Failed to import DMA buffer as a render destination");
+        return {};
+    }
+
+    m_dstImages.emplace_back(DstImage { .buffer = buffer, .image = image });
+    return image;
+}
+
+bool RImageCopyCaptureSession::copyToBuffer(std::shared_ptr<RImage> src, const SkRegion &region) noexcept
+{
+    wl_resource *buffer { m_frame->buffer() };
+
+    if (auto *shm { wl_shm_buffer_get(buffer) })
+    {
+        RPixelBufferRegion info {};
+        info.region = region;
+        info.stride = wl_shm_buffer_get_stride(shm);
+        info.format = DRM_FORMAT_ARGB8888;
+        wl_shm_buffer_begin_access(shm);
+        info.pixels = static_cast<UInt8*>(wl_shm_buffer_get_data(shm));
+        const bool ret { src->readPixels(info) };
+        wl_shm_buffer_end_access(shm);
+        return ret;
+    }
+
+    // GPU copy, no CPU readback
+    auto dst { dstImage(static_cast<LDMABuffer*>(wl_resource_get_user_data(buffer))) };
+
+    if (!dst)
+        return false;
+
+    auto surface { RSurface::WrapImage(dst) };
+    surface->setGeometry({
+        .viewport = SkRect::Make(m_bufferSize),
+        .dst = SkRect::Make(m_bufferSize),
+        .transform = CZTransform::Normal});
+
+    auto pass { surface->beginPass(RPassCap_Painter) };
+
+    if (!pass)
+        return false;
+
+    auto *p { pass->getPainter() };
+    p->setBlendMode(RBlendMode::Src);
+    RDrawImageInfo info {};
+    info.image = src;
+    info.src = SkRect::Make(src->size());
+    info.dst = SkIRect::MakeSize(m_bufferSize);
+    info.srcScale = 1.f;
+    info.srcTransform = CZTransform::Normal;
+    p->drawImage(info, &region);
+    return true;
+}
+
+void RImageCopyCaptureSession::copyOutput() noexcept
+{
+    // The client buffer also lacks the region it damaged
+    SkRegion region { m_damage };
+    region.op(m_frame->bufferDamage(), SkRegion::kUnion_Op);
+    region.op(SkIRect::MakeSize(m_bufferSize), SkRegion::kIntersect_Op);
+
+    auto src { m_output->backendImage() };
+
+    if (!src || !copyToBuffer(src, region))
+    {
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_UNKNOWN);
+        return;
+    }
+
+    sendReady(m_output->transform());
+}
+
+static void DrawCaptureTree(RPainter *p, LSurface *s, SkIPoint pos, const SkRegion &clip) noexcept
+{
+    if (!s->mapped())
+        return;
+
+    for (auto *sub : s->subsurfacesBelow())
+        DrawCaptureTree(p, sub->surface(), pos + sub->localPos(), clip);
+
+    if (s->image())
+    {
+        RDrawImageInfo info {};
+        info.dst = SkIRect::MakePtSize(pos, s->size());
+        info.src = s->srcRect();
+        info.image = s->image();
+        info.srcScale = s->scale();
+        info.srcTransform = s->bufferTransform();
+        p->drawImage(info, &clip);
+    }
+
+    for (auto *sub : s->subsurfacesAbove())
+        DrawCaptureTree(p, sub->surface(), pos + sub->localPos(), clip);
+}
+
+void RImageCopyCaptureSession::copyToplevel() noexcept
+{
+    LSurface *surface { m_toplevelRole->surface() };
+
+    if (!surface->mapped())
+        return;
+
+    wl_resource *buffer { m_frame->buffer() };
+    auto *shm { wl_shm_buffer_get(buffer) };
+    std::shared_ptr<RImage> target;
+    SkRegion region { m_damage };
+    region.op(m_frame->bufferDamage(), SkRegion::kUnion_Op);
+
+    if (shm)
+    {
+        // SHM buffers are read back from an intermediate image kept in sync with the toplevel
+        if (!m_shmImage)
+        {
+            auto *dev { RCore::Get()->mainDevice() };
+            auto fmt { dev->textureFormats().formats().find(DRM_FORMAT_ARGB8888) };
+
+            if (fmt != dev->textureFormats().formats().end())
+            {
+                RImageConstraints cons {};
+                cons.allocator = dev;
+                cons.caps[dev] = RImageCap_Dst;
+                cons.readFormats = { DRM_FORMAT_ARGB8888 };
+                m_shmImage = RImage::Make(m_bufferSize, *fmt, &cons);
+            }
+
+            region.setRect(SkIRect::MakeSize(m_bufferSize));
+        }
+
+        target = m_shmImage;
+    }
+    else
+        target = dstImage(static_cast<LDMABuffer*>(wl_resource_get_user_data(buffer)));
+
+    if (!target)
+    {
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_UNKNOWN);
+        return;
+    }
+
+    region.op(SkIRect::MakeSize(m_bufferSize), SkRegion::kIntersect_Op);
+
+    // Only the damaged region is redrawn, in window geometry local coords
+    const SkIRect geo { m_toplevelRole->windowGeometry() };
+    SkRegion clip;
+    SkRegion::Iterator it { region };
+
+    while (!it.done())
+    {
+        clip.op(SkIRect::MakeLTRB(
+            SkScalarFloorToInt(Float32(it.rect().left()) / m_scale) + geo.x(),
+            SkScalarFloorToInt(Float32(it.rect().top()) / m_scale) + geo.y(),
+            SkScalarCeilToInt(Float32(it.rect().right()) / m_scale) + geo.x(),
+            SkScalarCeilToInt(Float32(it.rect().bottom()) / m_scale) + geo.y()),
+            SkRegion::kUnion_Op);
+        it.next();
+    }
+
+    auto rSurface { RSurface::WrapImage(target) };
+    rSurface->setGeometry({
+        .viewport = SkRect::Make(geo),
+        .dst = SkRect::Make(m_bufferSize),
+        .transform = CZTransform::Normal});
+
+    auto pass { rSurface->beginPass(RPassCap_Painter) };
+
+    if (!pass)
+    {
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_UNKNOWN);
+        return;
+    }
+
+    auto *p { pass->getPainter() };
+    p->save();
+    p->setBlendMode(RBlendMode::Src);
+    p->setColor(SK_ColorTRANSPARENT);
+    p->drawColor(clip);
+    p->restore();
+    DrawCaptureTree(p, surface, { 0, 0 }, clip);
+    pass.reset();
+
+    if (shm && !copyToBuffer(m_shmImage, region))
+    {
+        m_frame->failed(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_UNKNOWN);
+        return;
+    }
+
+    sendReady(CZTransform::Normal);
+}
+
+void RImageCopyCaptureSession::sendReady(CZTransform transform) noexcept
+{
+    timespec time {};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    m_frame->transform(transform);
+    m_frame->damage(m_damage);
+    m_frame->presentationTime(time);
+    m_frame->ready();
+    m_damage.setEmpty();
+}
+
+/******************** REQUESTS ********************/
+
+void RImageCopyCaptureSession::create_frame(wl_client */*client*/, wl_resource *resource, UInt32 id) noexcept
+{
+    auto &res { *static_cast<RImageCopyCaptureSession*>(wl_resource_get_user_data(resource)) };
+
+    if (res.m_frame)
+    {
+        res.postError(EXT_IMAGE_COPY_CAPTURE_SESSION_V1_ERROR_DUPLICATE_FRAME, "create_frame sent before destroying the previous frame.");
+        return;
+    }
+
+    res.m_frame.reset(new RImageCopyCaptureFrame(res, id));
+}
+
+void RImageCopyCaptureSession::destroy(wl_client */*client*/, wl_resource *resource) noexcept
+{
+    wl_resource_destroy(resource);
+}
+
+/******************** EVENTS ********************/
+
+void RImageCopyCaptureSession::bufferSize(UInt32 width, UInt32 height) noexcept
+{
+    ext_image_copy_capture_session_v1_send_buffer_size(resource(), width, height);
+}
+
+void RImageCopyCaptureSession::shmFormat(UInt32 format) noexcept
+{
+    ext_image_copy_capture_session_v1_send_shm_format(resource(), format);
+}
+
+void RImageCopyCaptureSession::dmabufDevice(wl_array *device) noexcept
+{
+    ext_image_copy_capture_session_v1_send_dmabuf_device(resource(), device);
+}
+
+void RImageCopyCaptureSession::dmabufFormat(UInt32 format, wl_array *modifiers) noexcept
+{
+    ext_image_copy_capture_session_v1_send_dmabuf_format(resource(), format, modifiers);
+}
+
+void RImageCopyCaptureSession::done() noexcept
+{
+    ext_image_copy_capture_session_v1_send_done(resource());
+}
+
+void RImageCopyCaptureSession::stopped() noexcept
+{
+    ext_image_copy_capture_session_v1_send_stopped(resource());
+}
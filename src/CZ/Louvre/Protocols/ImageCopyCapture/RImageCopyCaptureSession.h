@@ -0,0 +1,106 @@
+#ifndef RIMAGECOPYCAPTURESESSION_H
+#define RIMAGECOPYCAPTURESESSION_H
+
+#include <CZ/Louvre/LResource.h>
+#include <CZ/Core/CZWeak.h>
+#include <CZ/skia/core/SkRegion.h>
+#include <memory>
+#include <vector>
+
+class CZ::Protocols::ImageCopyCapture::RImageCopyCaptureSession final : public LResource
+{
+public:
+    LImageCaptureSourceType sourceType() const noexcept { return m_sourceType; }
+
+    // nullptr if not an output session or the output was removed
+    LOutput *output() const noexcept { return m_output; }
+
+    // nullptr if not a toplevel session or the toplevel was destroyed
+    LToplevelRole *toplevelRole() const noexcept { return m_toplevelRole; }
+
+    RImageCopyCaptureFrame *frame() const noexcept { return m_frame; }
+    bool paintCursors() const noexcept { return m_paintCursors; }
+    bool isStopped() const noexcept { return m_stopped; }
+
+    // Constraints sent with bufferSize()
+    SkISize bufferSize() const noexcept { return m_bufferSize; }
+
+    // Accumulated damage since the last ready frame in buffer coords
+    const SkRegion &damage() const noexcept { return m_damage; }
+
+    // Called by LOutputPrivate::blitFramebuffers() once the damage is in buffer coords
+    static void HandleOutputPaint(LOutput *output) noexcept;
+
+    // Called after each surface commit, forwards the damage to the toplevel sessions
+    static void HandleSurfaceCommit(LSurface *surface) noexcept;
+
+    // Fails the pending frame and sends stopped
+    void stop() noexcept;
+
+    /******************** REQUESTS ********************/
+
+    static void create_frame(wl_client *client, wl_resource *resource, UInt32 id) noexcept;
+    static void destroy(wl_client *client, wl_resource *resource) noexcept;
+
+    /******************** EVENTS ********************/
+
+    void bufferSize(UInt32 width, UInt32 height) noexcept;
+    void shmFormat(UInt32 format) noexcept;
+    void dmabufDevice(wl_array *device) noexcept;
+    void dmabufFormat(UInt32 format, wl_array *modifiers) noexcept;
+    void done() noexcept;
+    void stopped() noexcept;
+
+private:
+    friend class GImageCopyCaptureManager;
+    friend class RImageCopyCaptureFrame;
+    friend class RImageCopyCaptureCursorSession;
+    // A nullptr source creates an already stopped session
+    RImageCopyCaptureSession(LClient *client, Int32 version, UInt32 id, ImageCaptureSource::RImageCaptureSource *source, bool paintCursors) noexcept;
+    ~RImageCopyCaptureSession() noexcept;
+
+    // Removes the session from the output or toplevel
+    void unlink() noexcept;
+
+    // Recalculates the buffer size and (re)sends the constraints if changed
+    void updateConstraints() noexcept;
+    void sendConstraints() noexcept;
+
+    // Called by RImageCopyCaptureFrame::capture()
+    void handleCaptureRequest() noexcept;
+
+    // Copies the damaged region into the frame buffer and sends ready
+    void copyOutput() noexcept;
+    void copyToplevel() noexcept;
+    bool copyToBuffer(std::shared_ptr<RImage> src, const SkRegion &region) noexcept;
+    void sendReady(CZTransform transform) noexcept;
+
+    // Returns false (and fails the frame) if the attached buffer doesn't match the constraints
+    bool validateBuffer() noexcept;
+
+    // Client DMA buffers imported as render destinations
+    std::shared_ptr<RImage> dstImage(LDMABuffer *buffer) noexcept;
+
+    struct DstImage
+    {
+        CZWeak<LDMABuffer> buffer;
+        std::shared_ptr<RImage> image;
+    };
+
+    std::vector<DstImage> m_dstImages;
+
+    // Intermediate image for SHM toplevel captures
+    std::shared_ptr<RImage> m_shmImage;
+
+    CZWeak<LOutput> m_output;
+    CZWeak<LToplevelRole> m_toplevelRole;
+    CZWeak<RImageCopyCaptureFrame> m_frame;
+    SkISize m_bufferSize { 0, 0 };
+    Float32 m_scale { 1.f }; // Toplevel only
+    SkRegion m_damage;
+    LImageCaptureSourceType m_sourceType { LImageCaptureSourceType::Output };
+    bool m_paintCursors { false };
+    bool m_stopped { false };
+};
+
+#endif // RIMAGECOPYCAPTURESESSION_H
@@ -1,6 +1,8 @@
 #include <CZ/Louvre/Protocols/LinuxDMABuf/RZwpLinuxBufferParamsV1.h>
 #include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
 #include <CZ/Louvre/LCompositor.h>
+#include <CZ/Louvre/Private/LClientPrivate.h>
+#include <CZ/Louvre/Private/LCompositorPrivate.h>
 #include <CZ/Louvre/Roles/LSurface.h>
 
 using namespace CZ::Protocols::Wayland;
@@ -14,8 +16,10 @@ static const struct wl_buffer_interface imp
 LDMABuffer::LDMABuffer
     (
         std::shared_ptr<RImage> &&image,
+        const RDMABufferInfo &dmaInfo,
         LClient *client,
-        UInt32 id
+        UInt32 id,
+        UInt32 accountedFds
     ) noexcept
     :LResource
     (
@@ -25,20 +29,52 @@ LDMABuffer::LDMABuffer
         id,
         &imp
     ),
-    m_image(std::move(image))
+    m_image(std::move(image)),
+    m_dmaInfo(dmaInfo),
+    m_fdCount(accountedFds)
 {
     // RImage can only be nullptr if 'failed' was sent after 'create_immed'.
     // We expect the client to destroy the buffer and try again.
     // If the client commits the buffer or uses it elsewhere, we kill it.
 }
 
-LDMABuffer::~LDMABuffer() noexcept {}
+LDMABuffer::~LDMABuffer() noexcept
+{
+    client()->imp()->releaseFds(m_fdCount);
+
+    // Reused if the client creates a new buffer from the same DMA-BUF
+    if (m_image && compositor()->imp()->dmaImporter)
+        compositor()->imp()->dmaImporter->recycle(client(), m_dmaInfo, std::move(m_image));
+}
 
 bool LDMABuffer::isDMABuffer(wl_resource *buffer) noexcept
 {
     return wl_resource_instance_of(buffer, &wl_buffer_interface, &imp);
 }
 
+void LDMABuffer::unhold() noexcept
+{
+    if (m_holds == 0)
+        return;
+
+    m_holds--;
+
+    if (m_holds == 0 && m_pendingRelease)
+    {
+        m_pendingRelease = false;
+        wl_buffer_send_release(resource());
+
+        // Backends may unhold after the paintGL() flush, e.g. once an overlay commit is displayed
+        compositor()->imp()->scheduleFlush();
+    }
+}
+
+bool LDMABuffer::deferRelease() noexcept
+{
+    m_pendingRelease = isHeld();
+    return m_pendingRelease;
+}
+
 /******************** REQUESTS ********************/
 
 void LDMABuffer::destroy(wl_client */*client*/, wl_resource *resource) noexcept
@@ -2,6 +2,7 @@
 #define LDMABUFFER_H
 
 #include <CZ/Louvre/LResource.h>
+#include <CZ/Ream/RDMABufferInfo.h>
 #include <CZ/Ream/RImage.h>
 
 using namespace CZ::Protocols::LinuxDMABuf;
@@ -9,12 +10,26 @@ using namespace CZ::Protocols::LinuxDMABuf;
 class CZ::LDMABuffer final : public LResource
 {
 public:
-    LDMABuffer(std::shared_ptr<RImage> &&image, LClient *client, UInt32 id) noexcept;
+    // accountedFds: fds already charged to the client by the caller, released when the buffer is destroyed
+    LDMABuffer(std::shared_ptr<RImage> &&image, const RDMABufferInfo &dmaInfo, LClient *client, UInt32 id, UInt32 accountedFds) noexcept;
 
     static bool isDMABuffer(wl_resource *buffer) noexcept;
 
     std::shared_ptr<RImage> image() const noexcept { return m_image; }
 
+    // The fds are owned by the image
+    const RDMABufferInfo &dmaInfo() const noexcept { return m_dmaInfo; }
+
+    /* While held (e.g. being displayed by a parent compositor), releases
+     * are deferred until the last unhold() call */
+    void hold() noexcept { m_holds++; }
+    void unhold() noexcept;
+    bool isHeld() const noexcept { return m_holds > 0; }
+
+    // Returns false if the buffer is held, in which case the release is sent later by unhold()
+    bool deferRelease() noexcept;
+    void cancelDeferredRelease() noexcept { m_pendingRelease = false; }
+
     /******************** REQUESTS ********************/
 
     static void destroy(wl_client *client, wl_resource *resource) noexcept;
@@ -22,6 +37,10 @@ public:
 private:
     ~LDMABuffer() noexcept;
     std::shared_ptr<RImage> m_image;
+    RDMABufferInfo m_dmaInfo;
+    UInt32 m_holds { 0 };
+    UInt32 m_fdCount { 0 }; // See LClient::fdCount()
+    bool m_pendingRelease { false };
 };
 
 #endif // LDMABUFFER_H
@@ -2,12 +2,22 @@
 #include <CZ/Louvre/Protocols/LinuxDMABuf/RZwpLinuxBufferParamsV1.h>
 #include <CZ/Louvre/Protocols/LinuxDMABuf/GZwpLinuxDmaBufV1.h>
 #include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
-#include <CZ/Louvre/LClient.h>
-#include <CZ/Ream/RCore.h>
+#include <CZ/Louvre/Private/LCompositorPrivate.h>
+#include <CZ/Louvre/Private/LClientPrivate.h>
 #include <CZ/Core/CZBitset.h>
 
 using namespace CZ::Protocols::LinuxDMABuf;
 
+static CZ::LDMAImporter &Importer() noexcept
+{
+    auto &importer { CZ::compositor()->imp()->dmaImporter };
+
+    if (!importer)
+        importer = std::make_unique<CZ::LDMAImporter>();
+
+    return *importer;
+}
+
 static const struct zwp_linux_buffer_params_v1_interface imp
 {
     .destroy = &RZwpLinuxBufferParamsV1::destroy,
@@ -36,6 +46,8 @@ RZwpLinuxBufferParamsV1::RZwpLinuxBufferParamsV1(
 
 RZwpLinuxBufferParamsV1::~RZwpLinuxBufferParamsV1() noexcept
 {
+    client()->imp()->releaseFds(m_accountedFds);
+
     // This means that no RImage took ownership of the fds, so we must closed them here
     if (m_isInvalid)
     {
@@ -91,13 +103,32 @@ int RZwpLinuxBufferParamsV1::createCommon(Int32 width, Int32 height, UInt32 form
     m_dmaInfo.format = format;
     m_dmaInfo.width = width;
     m_dmaInfo.height = height;
+    return 1;
+}
 
-    auto ream { RCore::Get() };
-    RImageConstraints cons {};
-    cons.allocator = ream->mainDevice();
-    cons.caps[ream->mainDevice()] = RImageCap_Src; // At least the main device should be able to sample from it
-    m_image = RImage::FromDMA(m_dmaInfo, CZOwn::Own, &cons);
+bool RZwpLinuxBufferParamsV1::findCached() noexcept
+{
+    m_image = Importer().find(client(), m_dmaInfo);
 
+    if (!m_image)
+        return false;
+
+    // Already imported, m_dmaInfo now holds the fds owned by the cached image
+    while (!m_fds.empty())
+    {
+        close(*m_fds.begin());
+        m_fds.erase(m_fds.begin());
+    }
+
+    // The client no longer holds any fd for this buffer
+    client()->imp()->releaseFds(m_accountedFds);
+    m_accountedFds = 0;
+
+    return true;
+}
+
+int RZwpLinuxBufferParamsV1::handleImport() noexcept
+{
     if (!m_image)
     {
         /* Nvidia drivers keep too many open files, if one of the fds is larger than 1020 the compositor may have reached
@@ -118,6 +149,20 @@ int RZwpLinuxBufferParamsV1::createCommon(Int32 width, Int32 height, UInt32 form
     return 1;
 }
 
+LDMABuffer *RZwpLinuxBufferParamsV1::createBuffer(UInt32 id) noexcept
+{
+    // Without an image the fds are released by the params destructor
+    UInt32 accountedFds { 0 };
+
+    if (m_image)
+    {
+        accountedFds = m_accountedFds;
+        m_accountedFds = 0;
+    }
+
+    return new LDMABuffer(std::move(m_image), m_dmaInfo, client(), id, accountedFds);
+}
+
 /******************** REQUESTS ********************/
 
 void RZwpLinuxBufferParamsV1::destroy(wl_client */*client*/, wl_resource *resource) noexcept
@@ -140,7 +185,18 @@ void RZwpLinuxBufferParamsV1::add(wl_client */*client*/,
         return;
     }
 
-    res->m_fds.emplace(fd);
+    if (!res->m_fds.contains(fd))
+    {
+        if (!res->client()->imp()->acquireFds(1, true))
+        {
+            close(fd);
+            wl_client_post_no_memory(res->client()->client());
+            return;
+        }
+
+        res->m_accountedFds++;
+        res->m_fds.emplace(fd);
+    }
 
     if (res->m_isInvalid)
         return;
@@ -188,8 +244,27 @@ void RZwpLinuxBufferParamsV1::add(wl_client */*client*/,
 void RZwpLinuxBufferParamsV1::create(wl_client */*client*/, wl_resource *resource, Int32 width, Int32 height, UInt32 format, UInt32 flags) noexcept
 {
     auto *res { static_cast<RZwpLinuxBufferParamsV1*>(wl_resource_get_user_data(resource)) };
-    if (res->createCommon(width, height, format, flags) == 1)
-        res->created((new LDMABuffer(std::move(res->m_image), res->client(), 0))->resource());
+
+    if (res->createCommon(width, height, format, flags) != 1)
+        return;
+
+    if (res->findCached())
+    {
+        res->created(res->createBuffer(0)->resource());
+        return;
+    }
+
+    // Imported by a worker thread, created/failed are sent from the main thread once done
+    Importer().importAsync(res->m_dmaInfo, [params = CZWeak<RZwpLinuxBufferParamsV1>(res)](std::shared_ptr<RImage> image) {
+        // The image owns the fds, if the params were destroyed in the meantime it's just dropped
+        if (!params)
+            return;
+
+        params->m_image = std::move(image);
+
+        if (params->handleImport() == 1)
+            params->created(params->createBuffer(0)->resource());
+    });
 
     // Ignore the leak warning, the buffer is destroyed when the client releases it or is disconnected
 }
@@ -199,9 +274,19 @@ void RZwpLinuxBufferParamsV1::create_immed(wl_client */*client*/, wl_resource *r
                                      Int32 width, Int32 height, UInt32 format, UInt32 flags) noexcept
 {
     auto *res { static_cast<RZwpLinuxBufferParamsV1*>(wl_resource_get_user_data(resource)) };
-    if (res->createCommon(width, height, format, flags) == -1)
+
+    int ret { res->createCommon(width, height, format, flags) };
+
+    if (ret == 1 && !res->findCached())
+    {
+        res->m_image = Importer().import(res->m_dmaInfo);
+        ret = res->handleImport();
+    }
+
+    if (ret == -1)
         return;
-    new LDMABuffer(std::move(res->m_image), res->client(), buffer_id);
+
+    res->createBuffer(buffer_id);
 }
 #endif
 
@@ -32,11 +32,21 @@ private:
     RZwpLinuxBufferParamsV1(GZwpLinuxDmaBufV1 *linuxDMABufRes, UInt32 id) noexcept;
     ~RZwpLinuxBufferParamsV1() noexcept;
 
-    // 1: Created, 0: failed sent, -1: error sent
+    // 1: Valid, 0: failed sent, -1: error sent
     int createCommon(Int32 width, Int32 height, UInt32 format, UInt32 flags) noexcept;
+
+    // Sets m_image from the importer cache, returns false on miss
+    bool findCached() noexcept;
+
+    // Called once m_image is set by an import, same return values as createCommon()
+    int handleImport() noexcept;
+
+    // Moves m_image and the accounted fds to a new LDMABuffer
+    LDMABuffer *createBuffer(UInt32 id) noexcept;
     RDMABufferInfo m_dmaInfo {};
     std::shared_ptr<RImage> m_image;
     std::unordered_set<int> m_fds;
+    UInt32 m_accountedFds { 0 }; // See LClient::fdCount()
     bool m_isInvalid { false };
     bool m_used { false };
 };
@@ -110,6 +110,7 @@ void RSessionLock::unlock_and_destroy(wl_client */*client*/, wl_resource *resour
 
         compositor()->sessionLockManager()->m_sessionLockRes.reset();
         compositor()->sessionLockManager()->m_state = LSessionLockManager::Unlocked;
+        compositor()->imp()->toplevelsVisibilityChanged = true;
         compositor()->sessionLockManager()->stateChanged();
     }
 
@@ -137,6 +138,7 @@ bool RSessionLock::makeLockRequest()
     if (sessionLockManager()->lockRequest(client()))
     {
         sessionLockManager()->m_state = LSessionLockManager::Locked;
+        compositor()->imp()->toplevelsVisibilityChanged = true;
         sessionLockManager()->m_sessionLockRes.reset(this);
 
         m_reply = RSessionLock::Locked;
@@ -2,6 +2,7 @@
 #include <CZ/Louvre/Protocols/SinglePixelBuffer/GWpSinglePixelBufferManagerV1.h>
 #include <CZ/Louvre/Protocols/SinglePixelBuffer/LSinglePixelBuffer.h>
 #include <CZ/Louvre/Private/LClientPrivate.h>
+#include <CZ/Louvre/Private/LCompositorPrivate.h>
 #include <CZ/Louvre/LCompositor.h>
 #include <CZ/Louvre/LLog.h>
 #include <CZ/Core/Utils/CZVectorUtils.h>
@@ -9,6 +10,7 @@
 #include <CZ/Ream/RImage.h>
 #include <CZ/Ream/RCore.h>
 #include <CZ/Ream/RDevice.h>
+#include <algorithm>
 
 using namespace CZ::Protocols::SinglePixelBuffer;
 using namespace CZ;
@@ -75,17 +77,27 @@ static constexpr UInt32 PackARGB8888(UInt32 r, UInt32 g, UInt32 b, UInt32 a)
            (NormU32ToU8(b) << 0);
 }
 
-static constexpr UInt32 PackABGR8888(UInt32 r, UInt32 g, UInt32 b, UInt32 a)
+// Swaps the R and B channels
+static constexpr UInt32 ARGBToABGR(UInt32 argb)
 {
-    return (NormU32ToU8(a) << 24) |
-           (NormU32ToU8(b) << 16) |
-           (NormU32ToU8(g) << 8)  |
-           (NormU32ToU8(r) << 0);
+    return (argb & 0xFF00FF00) | ((argb >> 16) & 0xFF) | ((argb & 0xFF) << 16);
 }
 
-void GWpSinglePixelBufferManagerV1::create_u32_rgba_buffer(wl_client */*client*/, wl_resource *resource, UInt32 id, UInt32 r, UInt32 g, UInt32 b, UInt32 a) noexcept
+// The protocol values are premultiplied, SkColor is not
+static constexpr SkColor UnpremultiplyARGB8888(UInt32 argb)
+{
+    const UInt32 a { argb >> 24 };
+
+    if (a == 0)
+        return SK_ColorTRANSPARENT;
+
+    const auto channel { [a](UInt32 c) { return std::min<UInt32>(255, (c * 255 + a / 2) / a); } };
+    return SkColorSetARGB(a, channel((argb >> 16) & 0xFF), channel((argb >> 8) & 0xFF), channel(argb & 0xFF));
+}
+
+// Premultiplied ARGB8888 pixel
+static std::shared_ptr<RImage> MakeImage(UInt32 argb) noexcept
 {
-    auto &res { *static_cast<GWpSinglePixelBufferManagerV1*>(wl_resource_get_user_data(resource)) };
     auto ream { RCore::Get() };
     std::shared_ptr<RImage> image;
 
@@ -100,13 +112,13 @@ void GWpSinglePixelBufferManagerV1::create_u32_rgba_buffer(wl_client */*client*/
     info.stride = 4;
 
     // If opaque
-    if (a == std::numeric_limits<UInt32>::max())
+    if ((argb >> 24) == 0xFF)
     {
         info.format = DRM_FORMAT_XRGB8888;
         auto fmt { ream->mainDevice()->textureFormats().formats().find(info.format) };
         if (fmt != ream->mainDevice()->textureFormats().formats().end())
         {
-            pixel = PackARGB8888(r, g, b, a);
+            pixel = argb;
             image = RImage::MakeFromPixels(info, *fmt, &cons);
         }
 
@@ -116,7 +128,7 @@ void GWpSinglePixelBufferManagerV1::create_u32_rgba_buffer(wl_client */*client*/
             auto fmt { ream->mainDevice()->textureFormats().formats().find(info.format) };
             if (fmt != ream->mainDevice()->textureFormats().formats().end())
             {
-                pixel = PackABGR8888(r, g, b, a);
+                pixel = ARGBToABGR(argb);
                 image = RImage::MakeFromPixels(info, *fmt, &cons);
             }
         }
@@ -128,7 +140,7 @@ void GWpSinglePixelBufferManagerV1::create_u32_rgba_buffer(wl_client */*client*/
         auto fmt { ream->mainDevice()->textureFormats().formats().find(info.format) };
         if (fmt != ream->mainDevice()->textureFormats().formats().end())
         {
-            pixel = PackARGB8888(r, g, b, a);
+            pixel = argb;
             image = RImage::MakeFromPixels(info, *fmt, &cons);
         }
     }
@@ -139,18 +151,49 @@ void GWpSinglePixelBufferManagerV1::create_u32_rgba_buffer(wl_client */*client*/
         auto fmt { ream->mainDevice()->textureFormats().formats().find(info.format) };
         if (fmt != ream->mainDevice()->textureFormats().formats().end())
         {
-            pixel = PackABGR8888(r, g, b, a);
+            pixel = ARGBToABGR(argb);
             image = RImage::MakeFromPixels(info, *fmt, &cons);
         }
     }
 
+    return image;
+}
+
+void GWpSinglePixelBufferManagerV1::create_u32_rgba_buffer(wl_client */*client*/, wl_resource *resource, UInt32 id, UInt32 r, UInt32 g, UInt32 b, UInt32 a) noexcept
+{
+    auto &res { *static_cast<GWpSinglePixelBufferManagerV1*>(wl_resource_get_user_data(resource)) };
+
+    /* Interned by their 8-bit premultiplied value, toolkits create lots of them for backgrounds and borders.
+     * The image is built from the same quantized value, so all buffers sharing it look the same */
+    const UInt32 pixel { PackARGB8888(r, g, b, a) };
+    auto &cache { compositor()->imp()->singlePixelImages };
+    auto it { cache.find(pixel) };
+    std::shared_ptr<RImage> image;
+
+    if (it != cache.end())
+        image = it->second.lock();
+
     if (!image)
     {
-        res.postError(0, "Failed to create image from single pixel buffer (Louvre's fault)");
-        return;
+        image = MakeImage(pixel);
+
+        if (!image)
+        {
+            res.postError(0, "Failed to create image from single pixel buffer (Louvre's fault)");
+            return;
+        }
+
+        cache[pixel] = image;
+        auto &pruneSize { compositor()->imp()->singlePixelImagesPruneSize };
+
+        if (cache.size() > pruneSize)
+        {
+            std::erase_if(cache, [](const auto &entry) { return entry.second.expired(); });
+            pruneSize = std::max<size_t>(64, cache.size() * 2);
+        }
     }
 
-    new LSinglePixelBuffer(res.client(), res.version(), id, image);
+    new LSinglePixelBuffer(res.client(), res.version(), id, image, UnpremultiplyARGB8888(pixel));
 }
 
 
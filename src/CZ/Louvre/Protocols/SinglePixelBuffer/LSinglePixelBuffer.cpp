@@ -10,7 +10,8 @@ static const struct wl_buffer_interface imp
 LSinglePixelBuffer::LSinglePixelBuffer(LClient *client,
                                        Int32 version,
                                        UInt32 id,
-                                       std::shared_ptr<RImage> image)
+                                       std::shared_ptr<RImage> image,
+                                       SkColor color)
     noexcept : LResource
     (
         client,
@@ -19,7 +20,8 @@ LSinglePixelBuffer::LSinglePixelBuffer(LClient *client,
         id,
         &imp
     ),
-    image(image)
+    image(image),
+    color(color)
 {
     assert(image);
 }
@@ -3,12 +3,17 @@
 
 #include <CZ/Louvre/LResource.h>
 #include <CZ/Ream/RImage.h>
+#include <CZ/skia/core/SkColor.h>
 
 class CZ::LSinglePixelBuffer final : public LResource
 {
 public:
+    // Shared by all buffers with the same color, see GWpSinglePixelBufferManagerV1
     std::shared_ptr<RImage> image;
 
+    // Unpremultiplied from the premultiplied protocol values, the image keeps them premultiplied, see LSurface::solidColor()
+    SkColor color;
+
     static bool isSinglePixelBuffer(wl_resource *buffer) noexcept;
 
     /******************** REQUESTS ********************/
@@ -17,7 +22,7 @@ public:
 
 private:
     friend class Protocols::SinglePixelBuffer::GWpSinglePixelBufferManagerV1;
-    LSinglePixelBuffer(LClient *client, Int32 version, UInt32 id, std::shared_ptr<RImage> image) noexcept;
+    LSinglePixelBuffer(LClient *client, Int32 version, UInt32 id, std::shared_ptr<RImage> image, SkColor color) noexcept;
     ~LSinglePixelBuffer() noexcept = default;
 };
 
@@ -46,13 +46,27 @@ GOutput::GOutput(LOutput *output, wl_client *client, Int32 version, UInt32 id )
     m_output(output)
 {
     this->client()->imp()->outputGlobals.emplace_back(this);
+    output->imp()->clientGlobals[this->client()].emplace_back(this);
     sendConfiguration();
 }
 
 GOutput::~GOutput() noexcept
 {
     if (output())
+    {
         CZVectorUtils::RemoveOneUnordered(client()->imp()->outputGlobals, this);
+
+        auto &clientGlobals { output()->imp()->clientGlobals };
+        auto it { clientGlobals.find(client()) };
+
+        if (it != clientGlobals.end())
+        {
+            CZVectorUtils::RemoveOneUnordered(it->second, this);
+
+            if (it->second.empty())
+                clientGlobals.erase(it);
+        }
+    }
 }
 
 /******************** REQUESTS ********************/
@@ -108,20 +122,15 @@ void GOutput::sendConfiguration() noexcept
         for (auto *xdgOutput : xdgOutputRes())
             xdgOutput->done();
 
-    for (LSurface *surface : compositor()->surfaces())
+    const auto surfaces { output()->imp()->clientSurfaces.find(client()) };
+
+    if (surfaces == output()->imp()->clientSurfaces.end())
+        return;
+
+    for (LSurface *surface : surfaces->second)
     {
-        if (surface->client() == this->client())
-        {
-            for (LOutput *o : surface->outputs())
-            {
-                if (output() == o)
-                {
-                    surface->surfaceResource()->enter(this);
-                    surface->imp()->sendPreferredScale();
-                    break;
-                }
-            }
-        }
+        surface->surfaceResource()->enter(this);
+        surface->imp()->sendPreferredScale();
     }
 }
 
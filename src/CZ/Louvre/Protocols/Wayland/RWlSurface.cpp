@@ -79,6 +79,10 @@ RWlSurface::~RWlSurface()
 
     lSurface->imp()->setMapped(false);
     lSurface->imp()->stateFlags.add(LSurface::LSurfacePrivate::Destroyed);
+
+    // No more enter/leave events, just drop it from the output indexes
+    for (LOutput *output : lSurface->imp()->outputs)
+        output->imp()->removeSurface(lSurface);
 }
 
 /******************** REQUESTS ********************/
@@ -130,6 +130,16 @@ void GWlDRM::create_planar_buffer(wl_client */*client*/, wl_resource *resource,
 void GWlDRM::create_prime_buffer(wl_client */*client*/, wl_resource *resource, UInt32 id, int fd, Int32 width, Int32 height, UInt32 format, Int32 offset0, Int32 stride0, Int32 /*offset1*/, Int32 /*stride1*/, Int32 /*offset2*/, Int32 /*stride2*/)
 {
     auto &res { *static_cast<GWlDRM*>(wl_resource_get_user_data(resource)) };
+
+    // Accounted once the buffer is created
+    if (res.client()->imp()->exceedsFdLimit(1))
+    {
+        close(fd);
+        res.client()->fdLimitExceeded(true);
+        wl_client_post_no_memory(res.client()->client());
+        return;
+    }
+
     RDMABufferInfo info {};
     info.fd[0] = fd;
     info.width = width;
@@ -153,7 +163,8 @@ void GWlDRM::create_prime_buffer(wl_client */*client*/, wl_resource *resource, U
         return;
     }
 
-    new LDMABuffer(std::move(image), res.client(), id);
+    res.client()->imp()->acquireFds(1, false);
+    new LDMABuffer(std::move(image), info, res.client(), id, 1);
 }
 
 /******************** EVENTS ********************/
@@ -90,6 +90,24 @@ RWlrOutputConfiguration::Reply RWlrOutputConfiguration::validate() noexcept
     return Succeeded;
 }
 
+RWlrOutputConfiguration::Reply RWlrOutputConfiguration::dryRun() noexcept
+{
+    const Reply reply { validate() };
+
+    if (reply != Succeeded)
+        return reply;
+
+    // Same as apply, the configuration would be reverted
+    if (m_enabled.empty())
+        return Failed;
+
+    for (auto *eh : m_enabled)
+        if (eh->m_mode && !eh->output()->backend()->testMode(eh->m_mode))
+            return Failed;
+
+    return Succeeded;
+}
+
 /******************** REQUESTS ********************/
 
 void RWlrOutputConfiguration::enable_head(wl_client */*client*/, wl_resource *resource, UInt32 id, wl_resource *head)
@@ -180,20 +198,7 @@ void RWlrOutputConfiguration::apply(wl_client */*client*/, wl_resource *resource
 
         // Revert changes
         if (reply == Failed)
-        {
-            for (const auto &conf : fallback)
-            {
-                conf.output.setPos(conf.pos);
-                conf.output.setTransform(conf.transform);
-                conf.output.setScale(conf.scale);
-                conf.output.setMode(conf.mode);
-
-                if (conf.initialized)
-                    compositor()->addOutput(&conf.output);
-                else
-                    compositor()->removeOutput(&conf.output);
-            }
-        }
+            seat()->applyOutputConfiguration(fallback);
     }
 
     res.reply(reply);
@@ -209,7 +214,7 @@ void RWlrOutputConfiguration::test(wl_client */*client*/, wl_resource *resource)
         return;
     }
 
-    res.reply(res.validate());
+    res.reply(res.dryRun());
 }
 
 void RWlrOutputConfiguration::destroy(wl_client */*client*/, wl_resource *resource)
@@ -18,6 +18,9 @@ public:
     bool checkAlreadyConfigured(LOutput *output) noexcept;
     Reply validate() noexcept;
 
+    // validate() + asks the backends whether the modes can be set
+    Reply dryRun() noexcept;
+
     /******************** REQUESTS ********************/
 
     static void enable_head(wl_client *client, wl_resource *resource, UInt32 id, wl_resource *head);
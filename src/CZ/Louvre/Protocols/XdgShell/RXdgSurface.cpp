@@ -187,6 +187,7 @@ void RXdgSurface::ack_configure(wl_client */*client*/, wl_resource *resource, UI
 
                 toplevel.m_lastACKConfiguration = toplevel.m_sentConfigurations.front();
                 toplevel.m_sentConfigurations.pop_front();
+                toplevel.m_resizeSession.handleAck(serial);
                 toplevel.m_pending.serial = toplevel.m_lastACKConfiguration.serial;
                 toplevel.m_pending.bounds = toplevel.m_lastACKConfiguration.bounds;
                 toplevel.m_pending.capabilities = toplevel.m_lastACKConfiguration.capabilities;
@@ -1,4 +1,5 @@
 #include <CZ/Louvre/Protocols/ForeignToplevelList/RForeignToplevelHandle.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
 #include <CZ/Louvre/Protocols/XdgShell/xdg-shell.h>
 #include <CZ/Louvre/Protocols/XdgShell/RXdgToplevel.h>
 #include <CZ/Louvre/Protocols/XdgShell/RXdgSurface.h>
@@ -64,6 +65,9 @@ RXdgToplevel::~RXdgToplevel()
     while (!toplevelRole()->m_foreignToplevelHandles.empty())
         toplevelRole()->m_foreignToplevelHandles.back()->closed();
 
+    while (!toplevelRole()->m_imageCopyCaptureSessions.empty())
+        toplevelRole()->m_imageCopyCaptureSessions.back()->stop();
+
     toplevelRole()->surface()->imp()->setMapped(false);
     toplevelRole()->setParent(nullptr);
     toplevelRole()->surface()->imp()->setRole(nullptr, true);
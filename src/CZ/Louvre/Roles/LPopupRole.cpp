@@ -549,6 +549,10 @@ void LPopupRole::applyState(State *pending) noexcept
 
     const auto prev { m_current };
     m_current = *pending;
+
+    if (changesToNotify.has(WindowGeometryChanged | LocalPosChanged))
+        compositor()->imp()->toplevelsVisibilityChanged = true;
+
     stateChanged(0, prev);
 }
 
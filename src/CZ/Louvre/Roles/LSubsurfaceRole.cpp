@@ -26,11 +26,13 @@ void LSubsurfaceRole::handleParentCommit() noexcept
     if (m_pendingLocalPos != m_currentLocalPos)
     {
         m_currentLocalPos = m_pendingLocalPos;
+        compositor()->imp()->toplevelsVisibilityChanged = true;
         localPosChanged();
     }
 
-    if (m_isSynced)
-        m_lock.reset(); // This will commit the cached state
+    // The cached state is applied by the transaction once the parent state is, see LSurfacePrivate::applyCommit()
+    if (m_isSynced && m_lock)
+        compositor()->imp()->subsurfaceTransaction.locks.emplace_back(std::move(m_lock));
 }
 
 void LSubsurfaceRole::updateMapping() noexcept
@@ -15,7 +15,9 @@
 #include <CZ/Louvre/Seat/LKeyboard.h>
 #include <CZ/Louvre/Roles/LSurfaceLock.h>
 #include <CZ/Core/CZTime.h>
+#include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
 #include <CZ/Ream/DRM/RDRMTimeline.h>
+#include <poll.h>
 
 using namespace CZ::Protocols::Wayland;
 
@@ -46,6 +48,7 @@ LSurface::~LSurface() noexcept
 
     compositor()->imp()->surfaces.erase(imp()->compositorLink);
     compositor()->imp()->layers[layer()].erase(imp()->layerLink);
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 }
 
 std::shared_ptr<LSurfaceLock> LSurface::lock() noexcept
@@ -68,6 +71,11 @@ const std::vector<LSubsurfaceRole *> &LSurface::subsurfacesAbove() const noexcep
     return imp()->current.subsurfacesAbove;
 }
 
+UInt32 LSurface::syncedSubsurfacesApplied() const noexcept
+{
+    return imp()->syncedSubsurfacesApplied;
+}
+
 LSurfaceLayer LSurface::layer() const noexcept
 {
     return imp()->layer;
@@ -88,6 +96,7 @@ void LSurface::raise() noexcept
     layerList.erase(surf->imp()->layerLink);
     layerList.emplace_back(surf);
     surf->imp()->layerLink = std::prev(layerList.end());
+    compositor()->imp()->toplevelsVisibilityChanged = true;
     surf->raised();
 }
 
@@ -195,22 +204,26 @@ LBaseSurfaceRole *LSurface::role() const noexcept
 void LSurface::setPos(SkIPoint newPos) noexcept
 {
     imp()->pos = newPos;
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 }
 
 void LSurface::setPos(Int32 x, Int32 y) noexcept
 {
     imp()->pos.fX = x;
     imp()->pos.fY = y;
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 }
 
 void LSurface::setX(Int32 x) noexcept
 {
     imp()->pos.fX = x;
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 }
 
 void LSurface::setY(Int32 y) noexcept
 {
     imp()->pos.fY = y;
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 }
 
 SkISize LSurface::sizeB() const noexcept
@@ -289,6 +302,11 @@ std::shared_ptr<RImage> LSurface::image() const noexcept
     return imp()->current.image;
 }
 
+std::optional<SkColor> LSurface::solidColor() const noexcept
+{
+    return imp()->current.solidColor;
+}
+
 bool LSurface::hasDamage() const noexcept
 {
     return imp()->stateFlags.has(LSurfacePrivate::Damaged);
@@ -319,6 +337,16 @@ const SkRegion &LSurface::pointerConstraintRegion() const noexcept
     return imp()->current.pointerConstraintRegion;
 }
 
+bool LSurface::pointerConstraintRegionContains(SkPoint localPos) const noexcept
+{
+    return imp()->current.pointerConstraintIndex.contains(localPos);
+}
+
+SkPoint LSurface::closestPointerConstraintPoint(SkPoint localPos) const noexcept
+{
+    return imp()->current.pointerConstraintIndex.closestPoint(localPos);
+}
+
 void LSurface::enablePointerConstraint(bool enabled)
 {
     if (enabled && !hasPointerFocus())
@@ -410,6 +438,8 @@ void LSurface::sendOutputEnterEvent(LOutput *output) noexcept
         return;
 
     imp()->outputs.emplace(output);
+    output->imp()->addSurface(this);
+    output->imp()->stateFlags.add(LOutput::LOutputPrivate::PendingContentUpdate);
 
     for (GOutput *global : client()->outputGlobals())
         if (global->output() == output)
@@ -436,6 +466,8 @@ void LSurface::sendOutputLeaveEvent(LOutput *output) noexcept
         return;
 
     imp()->outputs.erase(output);
+    output->imp()->removeSurface(this);
+    output->imp()->stateFlags.add(LOutput::LOutputPrivate::PendingContentUpdate);
 
     for (GOutput *global : client()->outputGlobals())
         if (global->output() == output)
@@ -473,21 +505,22 @@ void LSurface::requestNextFrame(bool clearDamage) noexcept
         {
             auto &feedbackList { imp()->current.presentationFeedbackRes };
 
-            while (!feedbackList.empty())
+            if (!feedbackList.empty())
             {
-                if (!feedbackList.front())
+                const UInt64 paintEventId { output->backend()->paintEventId() };
+                auto &bucket { output->imp()->presentationBucket(paintEventId) };
+
+                for (auto &feedback : feedbackList)
                 {
-                    feedbackList.pop_front();
-                    continue;
+                    if (!feedback)
+                        continue;
+
+                    feedback->output.reset(output);
+                    feedback->paintEventId = paintEventId;
+                    bucket.emplace_back(feedback);
                 }
 
-                feedbackList.front()->output.reset(output);
-                feedbackList.front()->paintEventId = output->backend()->paintEventId();
-                // Move res to the end of waitingPresentationFeedback
-                output->imp()->waitingPresentationFeedback.splice(
-                    output->imp()->waitingPresentationFeedback.end(),
-                    feedbackList,
-                    feedbackList.begin());
+                feedbackList.clear();
             }
         }
 
@@ -529,12 +562,52 @@ LClient *LSurface::client() const noexcept
     return surfaceResource()->client();
 }
 
+static bool FenceSignaled(int fd) noexcept
+{
+    pollfd pfd { .fd = fd, .events = POLLIN, .revents = 0 };
+    return poll(&pfd, 1, 0) == 1;
+}
+
 bool LSurfaceBuffer::release() noexcept
 {
     if (buffer.res())
     {
         if (!released)
         {
+            /* Without a release timeline, DMA buffers are released once the last frame that sampled
+             * them finishes reading (the image read fence signals) rather than right away */
+            if (!releaseTimeline && !queued && LDMABuffer::isDMABuffer(buffer.res()))
+            {
+                auto image { weakImage.lock() };
+
+                if (image && image->readSync())
+                {
+                    auto fd { image->readSync()->fd() };
+
+                    if (fd.get() >= 0 && !FenceSignaled(fd.get()))
+                    {
+                        auto &unreleased { compositor()->imp()->unreleasedBuffers };
+                        queued = signaled = true;
+                        unreleased.emplace_back(*this);
+                        auto it { std::prev(unreleased.end()) };
+                        it->releaseSource = CZEventSource::Make(fd.release(), EPOLLIN, CZOwn::Own, [it](int, UInt32, CZEventSource*) {
+                            if (it->released)
+                                return;
+
+                            it->released = true;
+
+                            // Flushed by LCompositor::dispatch()
+                            if (it->buffer.res())
+                                wl_buffer_send_release(it->buffer.res());
+
+                            // The source is destroyed by handleUnreleasedBuffers()
+                            compositor()->imp()->unlockPoll();
+                        });
+                        return false;
+                    }
+                }
+            }
+
             released = true;
             wl_buffer_send_release(buffer.res());
         }
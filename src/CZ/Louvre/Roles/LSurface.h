@@ -9,6 +9,8 @@
 #include <CZ/Ream/RContentType.h>
 #include <CZ/skia/core/SkRegion.h>
 #include <CZ/skia/core/SkRect.h>
+#include <CZ/skia/core/SkColor.h>
+#include <optional>
 #include <list>
 
 namespace CZ
@@ -23,6 +25,7 @@ namespace CZ
         std::shared_ptr<RDRMTimeline> acquireTimeline, releaseTimeline;
         UInt64 acquirePoint, releasePoint;
         std::shared_ptr<CZEventSource> acquireTimelineSource;
+        std::shared_ptr<CZEventSource> releaseSource; // Waits for the read fence of DMA buffers without a release timeline
         bool attached;
         bool released;
         bool signaled;
@@ -221,6 +224,15 @@ public:
      */
     const std::vector<LSubsurfaceRole*>& subsurfacesAbove() const noexcept;
 
+    /**
+     * @brief Number of synchronized subsurface states applied along with the last commit.
+     *
+     * When a surface commit is applied, the cached states of its synchronized subsurfaces (including nested ones)
+     * are applied in a single pass right after it, and the commit events of the whole tree are sent afterwards.
+     * This returns how many states were applied by the last one, which can be useful for profiling deep subsurface trees.
+     */
+    UInt32 syncedSubsurfacesApplied() const noexcept;
+
     /**
      * @brief Returns the surface's current layer.
      *
@@ -497,6 +509,18 @@ public:
      */
     std::shared_ptr<RImage> image() const noexcept;
 
+    /**
+     * @brief Color of single pixel buffers
+     *
+     * Toolkits commonly use single pixel buffers along with a viewport for backgrounds and borders.
+     * Such surfaces can be drawn with a plain color fill instead of sampling image().
+     *
+     * Clients send premultiplied values, they are converted so that the color can be passed directly to RPainter::setColor().
+     *
+     * @return The unpremultiplied color, or `std::nullopt` if the current buffer is not a single pixel buffer.
+     */
+    std::optional<SkColor> solidColor() const noexcept;
+
     /**
      * @brief Native [wl_buffer](https://wayland.app/protocols/wayland#wl_buffer) handle
      *
@@ -683,6 +707,27 @@ public:
      */
     const SkRegion &pointerConstraintRegion() const noexcept;
 
+    /**
+     * @brief Checks if a point is within pointerConstraintRegion().
+     *
+     * Equivalent to `pointerConstraintRegion().contains()` but served from an index rebuilt
+     * only when the region changes, making it cheap enough to call on every pointer motion event.
+     *
+     * @param localPos The point in surface-local coordinates.
+     */
+    bool pointerConstraintRegionContains(SkPoint localPos) const noexcept;
+
+    /**
+     * @brief Closest point within pointerConstraintRegion().
+     *
+     * Faster equivalent of `CZRegionUtils::ClosestPointFrom(pointerConstraintRegion(), localPos)`,
+     * see pointerConstraintRegionContains().
+     *
+     * @param localPos The point in surface-local coordinates.
+     * @return The point itself if contained, or the closest point within the region (0,0 if empty).
+     */
+    SkPoint closestPointerConstraintPoint(SkPoint localPos) const noexcept;
+
     /**
      * @brief Notifies a change in pointerConstraintRegion().
      *
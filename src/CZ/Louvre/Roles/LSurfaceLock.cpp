@@ -16,7 +16,10 @@ LSurfaceLock::~LSurfaceLock() noexcept
     if (!m_userCreated)
     {
         m_surface->imp()->unlockCommit(m_commitId);
-        compositor()->imp()->unlockPoll();
+
+        // Woken up once by the transaction instead
+        if (!compositor()->imp()->subsurfaceTransaction.active)
+            compositor()->imp()->unlockPoll();
     }
     else
         CZCore::Get()->postEvent(
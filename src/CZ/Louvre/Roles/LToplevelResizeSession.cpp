@@ -4,8 +4,11 @@
 #include <CZ/Core/Events/CZPointerEnterEvent.h>
 #include <CZ/Louvre/Roles/LSurface.h>
 #include <CZ/Louvre/Cursor/LCursor.h>
+#include <CZ/Louvre/Seat/LOutput.h>
+#include <CZ/Louvre/Backends/LBackendOutput.h>
 #include <CZ/Louvre/LLog.h>
 #include <CZ/Core/Utils/CZVectorUtils.h>
+#include <CZ/Core/CZTime.h>
 
 using namespace CZ;
 
@@ -51,6 +54,66 @@ void LToplevelResizeSession::handleGeometryChange()
     }
 }
 
+bool LToplevelResizeSession::canSendSize() noexcept
+{
+    /* Wait until the previous size is acked and committed, the toplevel retries on each
+     * sendPendingConfigurations() call, i.e. right after the client's commit is processed */
+    if (!m_toplevel->m_sentConfigurations.empty() || m_toplevel->m_current.serial != m_toplevel->m_lastACKConfiguration.serial)
+        return false;
+
+    if (m_vblankAligned)
+    {
+        if (auto *output = vblankOutput(); output && output->backend()->paintEventId() == m_sentPaintEventId)
+        {
+            /* Sent from the flushClients() call at the end of the next paintGL(), usually triggered by the
+             * client's commit. A single repaint is requested per frame in case nothing else damages the output */
+            if (m_repaintPaintEventId != m_sentPaintEventId)
+            {
+                m_repaintPaintEventId = m_sentPaintEventId;
+                output->repaint();
+            }
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void LToplevelResizeSession::handleConfigurationSent(UInt32 serial) noexcept
+{
+    m_stats.sent++;
+    m_sentSerial = serial;
+    m_sentMs = CZTime::Ms();
+
+    if (auto *output = vblankOutput())
+        m_sentPaintEventId = output->backend()->paintEventId();
+}
+
+void LToplevelResizeSession::handleAck(UInt32 serial) noexcept
+{
+    if (m_sentMs == 0 || serial != m_sentSerial)
+        return;
+
+    m_stats.lastAckLatency = CZTime::Ms() - m_sentMs;
+    m_stats.maxAckLatency = std::max(m_stats.maxAckLatency, m_stats.lastAckLatency);
+    m_sentMs = 0;
+}
+
+LOutput *LToplevelResizeSession::vblankOutput() const noexcept
+{
+    const auto &outputs { m_toplevel->surface()->outputs() };
+
+    if (outputs.empty())
+        return nullptr;
+
+    for (auto *output : outputs)
+        if (output->rect().contains(m_currentDragPoint.x(), m_currentDragPoint.y()))
+            return output;
+
+    return *outputs.begin();
+}
+
 void LToplevelResizeSession::updateDragPoint(SkIPoint point)
 {
     if (!m_isActive)
@@ -100,6 +163,10 @@ void LToplevelResizeSession::updateDragPoint(SkIPoint point)
     if (newSize.height() < m_minSize.height())
         newSize.fHeight = m_minSize.height();
 
+    // The previous size was never sent, see canSendSize()
+    if (m_toplevel->m_flags.has(LToplevelRole::HasSizeOrStateToSend) && m_toplevel->pendingConfiguration().size != newSize)
+        m_stats.coalesced++;
+
     toplevel()->configureSize(newSize);
     toplevel()->configureState(CZWinActivated | CZWinResizing);
     m_lastSerial = m_toplevel->pendingConfiguration().serial;
@@ -120,6 +187,8 @@ bool LToplevelResizeSession::start(const CZEvent &triggeringEvent, CZBitset<CZEd
 
     m_ackTimer.stop(false);
     m_lastSerialHandled = false;
+    m_stats = {};
+    m_sentMs = 0;
     m_triggeringEvent = triggeringEvent.copy();
     m_edge = edge;
     m_initSize = m_toplevel->windowGeometry().size();
@@ -31,6 +31,14 @@
  * Finally, when the pointer button or touch point is released, the stop() method should be invoked to end the session
  * and remove it from the LSeat::toplevelResizeSessions() vector. The stop() method also returns an iterator pointing to the
  * next session in the vector which can be used in cases where the session is stopped while iterating through the vector.
+ *
+ * @section Throttling
+ *
+ * To avoid flooding slow clients, while the session is active at most one new size is left unacknowledged
+ * or acknowledged but not yet committed. Drag points received meanwhile are coalesced into the latest size,
+ * which is sent once the client catches up. Other changes (e.g. state, bounds or decoration mode) are not held back,
+ * they are sent right away along with the last sent size. Sizes can additionally be limited to one per output frame
+ * with setVBlankAligned(), see also stats().
  */
 class CZ::LToplevelResizeSession
 {
@@ -41,6 +49,24 @@ public:
      */
     using OnBeforeUpdateCallback = std::function<void(LToplevelResizeSession*)>;
 
+    /**
+     * @brief Configure throttling statistics, see stats().
+     */
+    struct Stats
+    {
+        /// Sizes sent since the session started
+        UInt32 sent { 0 };
+
+        /// Sizes replaced by a newer one before being sent
+        UInt32 coalesced { 0 };
+
+        /// Milliseconds between the last configure and its ack
+        UInt32 lastAckLatency { 0 };
+
+        /// Highest ack latency in milliseconds
+        UInt32 maxAckLatency { 0 };
+    };
+
     /**
      * @brief Start the resizing session.
      *
@@ -137,6 +163,32 @@ public:
         return *m_triggeringEvent.get();
     }
 
+    /**
+     * @brief Limits new sizes to one per frame of the output the toplevel is being resized on.
+     *
+     * Disabled by default, in which case sizes are sent as soon as the client commits the previous one.
+     */
+    void setVBlankAligned(bool enabled) noexcept
+    {
+        m_vblankAligned = enabled;
+    }
+
+    /**
+     * @brief Checks if configures are aligned to output frames, see setVBlankAligned().
+     */
+    bool vblankAligned() const noexcept
+    {
+        return m_vblankAligned;
+    }
+
+    /**
+     * @brief Configure throttling statistics, reset each time the session starts.
+     */
+    const Stats &stats() const noexcept
+    {
+        return m_stats;
+    }
+
     /**
      * @brief Checks if the session is currently active.
      *
@@ -149,9 +201,14 @@ public:
 
 private:
     friend class LToplevelRole;
+    friend class Protocols::XdgShell::RXdgSurface;
     LToplevelResizeSession(LToplevelRole *toplevel) noexcept;
     ~LToplevelResizeSession() noexcept;
     void handleGeometryChange();
+    bool canSendSize() noexcept;
+    void handleConfigurationSent(UInt32 serial) noexcept;
+    void handleAck(UInt32 serial) noexcept;
+    LOutput *vblankOutput() const noexcept;
     static constexpr SkISize calculateResizeSize(SkIPoint cursorPosDelta, const SkISize &initialSize, CZBitset<CZEdge> edge) noexcept
     {
         SkISize newSize { initialSize };
@@ -180,6 +237,12 @@ private:
     UInt32 m_lastSerial { 0 };
     bool m_isActive { false };
     bool m_lastSerialHandled { true };
+    bool m_vblankAligned { false };
+    UInt32 m_sentSerial { 0 };
+    UInt64 m_sentMs { 0 };
+    UInt64 m_sentPaintEventId { 0 };
+    UInt64 m_repaintPaintEventId { 0 };
+    Stats m_stats;
     CZTimer m_ackTimer;
     OnBeforeUpdateCallback m_beforeUpdateCallback { nullptr };
 };
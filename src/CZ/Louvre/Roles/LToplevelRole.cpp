@@ -3,6 +3,7 @@
 #include <CZ/Louvre/Protocols/ForeignToplevelManagement/RForeignToplevelHandle.h>
 #include <CZ/Louvre/Protocols/ForeignToplevelList/RForeignToplevelHandle.h>
 #include <CZ/Louvre/Protocols/ForeignToplevelList/GForeignToplevelList.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/RImageCopyCaptureSession.h>
 #include <CZ/Louvre/Protocols/XdgDecoration/RXdgToplevelDecoration.h>
 #include <CZ/Louvre/Protocols/XdgShell/RXdgSurface.h>
 #include <CZ/Louvre/Protocols/XdgShell/RXdgToplevel.h>
@@ -56,6 +57,7 @@ void LToplevelRole::setMinimized(bool minimized) noexcept
         return;
 
     m_flags.setFlag(IsMinimized, minimized);
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 
     for (auto *controller : m_foreignControllers)
     {
@@ -66,6 +68,53 @@ void LToplevelRole::setMinimized(bool minimized) noexcept
     minimizedChanged();
 }
 
+void LToplevelRole::setHidden(bool hidden, UInt64 now, UInt64 *nextCheckMs) noexcept
+{
+    if (!hidden)
+    {
+        m_flags.remove(IsHidden);
+        setAutoSuspended(false);
+        return;
+    }
+
+    if (!m_flags.has(IsHidden))
+    {
+        m_flags.add(IsHidden);
+        m_hiddenSinceMs = now;
+    }
+
+    if (isAutoSuspended())
+        return;
+
+    const UInt64 delay { compositor()->toplevelAutoSuspendDelay() };
+    const UInt64 elapsed { now - m_hiddenSinceMs };
+
+    // Hysteresis, prevents suspending toplevels that are only briefly covered (e.g. while dragging another window)
+    if (elapsed >= delay)
+        setAutoSuspended(true);
+    else
+        *nextCheckMs = std::min(*nextCheckMs, delay - elapsed);
+}
+
+void LToplevelRole::setAutoSuspended(bool suspended) noexcept
+{
+    if (suspended == isAutoSuspended())
+        return;
+
+    m_flags.setFlag(IsAutoSuspended, suspended);
+
+    // Merged into the sent state, nothing changes for the client if the compositor already suspended it
+    if (supportedWindowStates().has(CZWinSuspended) && !pendingConfiguration().windowState.has(CZWinSuspended))
+    {
+        updateSerial();
+        m_flags.add(HasSizeOrStateToSend);
+    }
+
+    // Resume frame callbacks immediately
+    if (!suspended)
+        surface()->repaintOutputs();
+}
+
 RXdgToplevel *LToplevelRole::xdgToplevelResource() const
 {
     return static_cast<RXdgToplevel*>(resource());
@@ -89,16 +138,35 @@ void LToplevelRole::sendPendingConfiguration() noexcept
     if (!m_flags.has(HasSizeOrStateToSend | HasDecorationModeToSend | HasBoundsToSend | HasCapabilitiesToSend))
         return;
 
-    surface()->requestNextFrame(false);
-
-    auto &res { *static_cast<XdgShell::RXdgToplevel*>(resource()) };
-
     if (m_flags.has(ForceRemoveActivatedFlag))
     {
         m_pendingConfiguration.windowState.remove(CZWinActivated);
         m_flags.remove(ForceRemoveActivatedFlag);
     }
 
+    // While resizing, only the size waits for the client to catch up, it is coalesced into the next configure
+    SkISize size { m_pendingConfiguration.size };
+    bool sizeHeld { false };
+
+    if (m_resizeSession.isActive() && !m_resizeSession.canSendSize())
+    {
+        const auto &last { m_sentConfigurations.empty() ? m_lastACKConfiguration : m_sentConfigurations.back() };
+
+        if (size != last.size)
+        {
+            if (!m_flags.has(HasDecorationModeToSend | HasBoundsToSend | HasCapabilitiesToSend) &&
+                m_pendingConfiguration.windowState == last.windowState)
+                return;
+
+            size = last.size;
+            sizeHeld = true;
+        }
+    }
+
+    surface()->requestNextFrame(false);
+
+    auto &res { *static_cast<XdgShell::RXdgToplevel*>(resource()) };
+
     if (m_flags.has(HasDecorationModeToSend))
     {
         if (m_xdgDecorationRes)
@@ -139,6 +207,9 @@ void LToplevelRole::sendPendingConfiguration() noexcept
     dummy.alloc = 0;
     dummy.data = stateArr;
 
+    // Only sent, see isAutoSuspended()
+    const bool suspended { m_pendingConfiguration.windowState.has(CZWinSuspended) || isAutoSuspended() };
+
     if (m_pendingConfiguration.windowState.has(CZWinActivated))
         stateArr[dummy.alloc++] = XDG_TOPLEVEL_STATE_ACTIVATED;
 
@@ -167,7 +238,7 @@ void LToplevelRole::sendPendingConfiguration() noexcept
 
         if (res.version() >= 6)
         {
-            if (m_pendingConfiguration.windowState.has(CZWinSuspended))
+            if (suspended)
                 stateArr[dummy.alloc++] = XDG_TOPLEVEL_STATE_SUSPENDED;
         }
     }
@@ -175,14 +246,25 @@ void LToplevelRole::sendPendingConfiguration() noexcept
     dummy.size = dummy.alloc * sizeof(UInt32);
     dummy.alloc = dummy.size;
 
-    res.configure(m_pendingConfiguration.size, &dummy);
+    res.configure(size, &dummy);
 
     if (res.xdgSurfaceRes())
         res.xdgSurfaceRes()->configure(m_pendingConfiguration.serial);
 
     m_sentConfigurations.push_back(m_pendingConfiguration);
+    m_sentConfigurations.back().size = size;
+
+    if (m_resizeSession.isActive() && !sizeHeld)
+        m_resizeSession.handleConfigurationSent(m_pendingConfiguration.serial);
 
     m_flags.remove(HasSizeOrStateToSend | HasDecorationModeToSend | HasBoundsToSend | HasCapabilitiesToSend);
+
+    // The held size goes out with a new serial once the client catches up
+    if (sizeHeld)
+    {
+        updateSerial();
+        m_flags.add(HasSizeOrStateToSend);
+    }
 }
 
 void LToplevelRole::updateSerial() noexcept
@@ -197,6 +279,7 @@ void LToplevelRole::updateSerial() noexcept
 void LToplevelRole::reset(CZ::LToplevelRole::State *pending) noexcept
 {
     surface()->imp()->setMapped(false);
+    m_flags.remove(IsHidden | IsAutoSuspended);
 
     auto *parent { surface()->parent() ? surface()->parent()->toplevel() : nullptr };
 
@@ -246,6 +329,9 @@ void LToplevelRole::reset(CZ::LToplevelRole::State *pending) noexcept
 
     while (!m_foreignToplevelHandles.empty())
         m_foreignToplevelHandles.back()->closed();
+
+    while (!m_imageCopyCaptureSessions.empty())
+        m_imageCopyCaptureSessions.back()->stop();
 }
 
 void LToplevelRole::setTitle(const char *title) noexcept
@@ -521,6 +607,9 @@ void LToplevelRole::applyState(State *pending) noexcept
 
     const CZBitset<CZWindowState> stateChanges { prev.windowState ^ m_current.windowState };
 
+    if (stateChanges.has(CZWinFullscreen))
+        surface()->imp()->notifyOutputsContentChange();
+
     if (stateChanges.has(CZWinActivated | CZWinMaximized | CZWinFullscreen))
     {
         for (auto *controller : foreignControllers())
@@ -531,5 +620,8 @@ void LToplevelRole::applyState(State *pending) noexcept
     }
 
     if (changesToNotify.has(WindowGeometryChanged))
+    {
+        compositor()->imp()->toplevelsVisibilityChanged = true;
         m_resizeSession.handleGeometryChange();
+    }
 }
@@ -445,6 +445,21 @@ public:
      */
     bool isSuspended() const noexcept { return windowState().has(CZWinSuspended); }
 
+    /**
+     * @brief Checks if the toplevel was suspended by the compositor because it is not visible.
+     *
+     * Toplevels that remain minimized, fully occluded by opaque regions of surfaces above them or outside all outputs
+     * for longer than LCompositor::toplevelAutoSuspendDelay() are configured with the @ref Suspended state
+     * (if supported) and stop receiving frame callbacks from the default LOutput::paintGL() implementation.
+     * The state is removed as soon as any part of the toplevel or its popups becomes visible again.
+     *
+     * The state is only added to the configurations sent to the client, it is not part of pendingConfiguration()
+     * and doesn't affect a @ref Suspended state set with configureState().
+     *
+     * @see LCompositor::setToplevelAutoSuspend()
+     */
+    bool isAutoSuspended() const noexcept { return m_flags.has(IsAutoSuspended); }
+
     bool isMinimized() const noexcept { return m_flags.has(IsMinimized); }
 
     void setMinimized(bool minimized) noexcept;
@@ -959,6 +974,7 @@ private:
     friend class Protocols::ForeignToplevelManagement::RForeignToplevelHandle;
     friend class Protocols::ForeignToplevelManagement::GForeignToplevelManager;
     friend class Protocols::ForeignToplevelList::RForeignToplevelHandle;
+    friend class Protocols::ImageCopyCapture::RImageCopyCaptureSession;
 
     enum Flags : UInt32
     {
@@ -969,7 +985,9 @@ private:
         HasDecorationModeToSend     = 1U << 4,
         HasBoundsToSend             = 1U << 5,
         HasCapabilitiesToSend       = 1U << 6,
-        HasPendingFirstMap          = 1U << 7
+        HasPendingFirstMap          = 1U << 7,
+        IsHidden                    = 1U << 8,
+        IsAutoSuspended             = 1U << 9
     };
 
     void cacheCommit() noexcept override;
@@ -984,6 +1002,8 @@ private:
     void setTitle(const char *title) noexcept;
     void setAppId(const char *appId) noexcept;
     void setParent(LToplevelRole *parent) noexcept;
+    void setHidden(bool hidden, UInt64 now, UInt64 *nextCheckMs) noexcept;
+    void setAutoSuspended(bool suspended) noexcept;
 
     State m_current {};
     State m_pending {};
@@ -1008,6 +1028,7 @@ private:
     mutable LToplevelMoveSession m_moveSession { this };
 
     CZWeak<LOutput> m_exclusiveOutput;
+    UInt64 m_hiddenSinceMs { 0 };
 
     Configuration m_pendingConfiguration, m_lastACKConfiguration;
     std::list<Configuration> m_sentConfigurations;
@@ -1023,6 +1044,7 @@ private:
     /* Foreign toplevel list */
     std::string m_identifier;
     std::vector<Protocols::ForeignToplevelList::RForeignToplevelHandle*> m_foreignToplevelHandles;
+    std::vector<Protocols::ImageCopyCapture::RImageCopyCaptureSession*> m_imageCopyCaptureSessions;
 };
 
 #endif // LTOPLEVELROLE_H
@@ -40,6 +40,15 @@ LOutput::LOutput(const void *params) noexcept : LFactoryObject(FactoryObjectType
 LOutput::~LOutput() noexcept
 {
     notifyDestruction();
+
+    if (imp()->modesetThread.joinable())
+    {
+        const auto unlocked { LLockGuard::Unlock() };
+        imp()->modesetThread.join();
+
+        if (unlocked)
+            LLockGuard::Lock();
+    }
 }
 
 LSessionLockRole *LOutput::sessionLockRole() const noexcept
@@ -47,6 +56,31 @@ LSessionLockRole *LOutput::sessionLockRole() const noexcept
     return imp()->sessionLockRole;
 }
 
+LSurface *LOutput::passthroughSurface() const noexcept
+{
+    return imp()->passthroughSurface;
+}
+
+void LOutput::paintCursor() noexcept
+{
+    if (imp()->stateFlags.has(LOutputPrivate::IsInPaintGL))
+        imp()->paintCursor();
+}
+
+const std::vector<LPlaneAssignment> &LOutput::planeAssignments() const noexcept
+{
+    return imp()->planeAssignments;
+}
+
+const LPlaneAssignment *LOutput::planeAssignment(const LSurface *surface) const noexcept
+{
+    for (const auto &assignment : imp()->planeAssignments)
+        if (assignment.surface.get() == surface)
+            return &assignment;
+
+    return nullptr;
+}
+
 bool LOutput::needsFullRepaint() const noexcept
 {
     return imp()->stateFlags.has(LOutput::LOutputPrivate::NeedsFullRepaint);
@@ -149,6 +183,10 @@ UInt32 LOutput::imageAge() const noexcept
     if (needsFullRepaint())
         return 0;
 
+    // The oversampled image is never swapped, only resized
+    if (oversamplingEnabled() && usingFractionalScale())
+        return imp()->stateFlags.has(LOutputPrivate::OSSurfaceReset) ? 0 : 1;
+
     return m_backend->imageAge();
 }
 
@@ -168,17 +206,19 @@ int LOutput::setMode(std::shared_ptr<LOutputMode> mode) noexcept
     if (mode->output() != this)
         return 0;
 
+    // Setting output mode from a rendering thread is not allowed
+    for (LOutput *o : compositor()->outputs())
+        if (o->threadId() == std::this_thread::get_id())
+            return 0;
+
+    imp()->finishModeset();
+
     if (mode == currentMode())
         return 1;
 
     if (imp()->state == Uninitialized)
         return m_backend->setMode(mode);
 
-    // Setting output mode from a rendering thread is not allowed
-    for (LOutput *o : compositor()->outputs())
-        if (o->threadId() == std::this_thread::get_id())
-            return 0;
-
     imp()->state = ChangingMode;
     const auto unlocked { LLockGuard::Unlock() };
     const auto ret { m_backend->setMode(mode) };
@@ -190,21 +230,19 @@ int LOutput::setMode(std::shared_ptr<LOutputMode> mode) noexcept
     if (ret != 1)
         return ret;
 
-    for (auto *head : imp()->wlrOutputHeads)
-    {
-        for (auto *mode : head->modes())
-        {
-            if (mode->mode() == currentMode())
-            {
-                head->currentMode(mode);
-                break;
-            }
-        }
-    }
-
+    imp()->updateWlrHeadsMode();
     return ret;
 }
 
+void LOutput::setModeAsync(std::shared_ptr<LOutputMode> mode, const std::function<void(LOutput*, int)> &callback) noexcept
+{
+    CZWeak<LOutput> output { this };
+    LOutputPrivate::SetModesAsync({{ this, mode }}, [output, callback](const std::vector<int> &results) {
+        if (output && callback)
+            callback(output.get(), results[0]);
+    });
+}
+
 void LOutput::setScale(Float32 scale) noexcept
 {
     if (scale < 0.25f)
@@ -228,8 +266,7 @@ void LOutput::setScale(Float32 scale) noexcept
         imp()->updateGlobals();
         cursor()->m_imageChanged = true;
         repaint();
-        for (LSurface *s : compositor()->surfaces())
-            s->imp()->sendPreferredScale();
+        imp()->sendPreferredScale();
     }
 
     for (auto *head : imp()->wlrOutputHeads)
@@ -241,8 +278,58 @@ Float32 LOutput::scale() const noexcept
     return imp()->scale;
 }
 
+const LOutput::ContentPolicy &LOutput::contentPolicy() const noexcept
+{
+    return imp()->contentPolicy;
+}
+
+void LOutput::setContentPolicy(const ContentPolicy &policy) noexcept
+{
+    imp()->contentPolicy = policy;
+
+    auto &user { imp()->userContentState };
+    const bool wasApplied { imp()->stateFlags.has(LOutputPrivate::ContentPolicyApplied) };
+
+    if (!policy.surface)
+    {
+        if (!wasApplied)
+            return;
+
+        // The surface is gone, restore what the compositor had set
+        imp()->stateFlags.remove(LOutputPrivate::ContentPolicyApplied);
+
+        if (contentType() != user.contentType)
+            setContentType(user.contentType);
+
+        if (canDisableVSync() && isVSyncEnabled() != user.vsync)
+            enableVSync(user.vsync);
+
+        if (hasVRR() && isVRREnabled() != user.vrr)
+            setVRREnabled(user.vrr);
+
+        return;
+    }
+
+    if (!wasApplied)
+    {
+        imp()->stateFlags.add(LOutputPrivate::ContentPolicyApplied);
+        user.contentType = contentType();
+        user.vsync = isVSyncEnabled();
+        user.vrr = isVRREnabled();
+    }
+
+    if (contentType() != policy.contentType)
+        setContentType(policy.contentType);
+
+    if (canDisableVSync() && isVSyncEnabled() != policy.vsync)
+        enableVSync(policy.vsync);
+}
+
 void LOutput::repaint() noexcept
 {
+    // Any repaint requires a paintGL(), see LOutputPrivate::repaintCursor()
+    imp()->stateFlags.remove(LOutputPrivate::CursorOnlyRepaint);
+
     if (m_backend->repaint())
         imp()->stateFlags.add(LOutputPrivate::PendingRepaint);
 }
@@ -341,6 +428,7 @@ LOutput::State LOutput::state() const noexcept
 void LOutput::setPos(SkIPoint pos) noexcept
 {
     imp()->rect.offsetTo(pos.x(), pos.y());
+    compositor()->imp()->toplevelsVisibilityChanged = true;
 
     for (auto *head : imp()->wlrOutputHeads)
         head->position(pos);
@@ -3,6 +3,7 @@
 
 #include <CZ/Louvre/LFactoryObject.h>
 #include <CZ/Louvre/Backends/LBackendOutput.h>
+#include <CZ/Louvre/Seat/LPlaneAssignment.h>
 #include <CZ/skia/core/SkSize.h>
 #include <CZ/skia/core/SkRect.h>
 #include <CZ/skia/core/SkRegion.h>
@@ -10,6 +11,7 @@
 #include <CZ/Ream/RImage.h>
 #include <CZ/Core/CZTransform.h>
 
+#include <functional>
 #include <thread>
 #include <list>
 #include <GLES2/gl2.h>
@@ -195,6 +197,39 @@
  * Clients using the Tearing Protocol can indicate their preference for each individual surface.\n
  * See LSurface::preferVSync() and LSurface::preferVSyncChanged() for more details.
  *
+ * @section VRR
+ *
+ * Outputs supporting variable refresh rate (adaptive sync, see hasVRR()) can present frames as soon as they are ready
+ * within vrrRange(), instead of waiting for the next fixed refresh cycle. VRR is disabled by default and toggled with setVRREnabled().\n
+ * updateVRRPolicy() is invoked whenever the surfaces within the output may require a different setting, by default VRR follows
+ * the contentPolicy().
+ *
+ * @section Content Policy
+ *
+ * The content type hints of the surfaces within the output (see LSurface::contentType()) are used to tune how the output is driven.
+ * Whenever they may have changed, updateContentPolicy() is invoked, which by default picks the content type of the topmost fullscreen
+ * toplevel and applies a ContentPolicy with setContentPolicy():
+ *
+ * - @ref RContentType::Video: VRR so that the refresh rate matches the video frame rate.
+ * - @ref RContentType::Game: VRR for the lowest latency, VSync follows the client's preference (see LSurface::prefersVSync()).
+ * - @ref RContentType::Photo: Color accurate path, the content is always composited.
+ *
+ * While no surface drives the policy, the content type, VSync and VRR set by the compositor are left untouched,
+ * and are restored once the surface goes away. The effective policy can be inspected with contentPolicy().
+ *
+ * @section Overlay Planes
+ *
+ * Some outputs have hardware overlay planes (see planes()) capable of scanning out client DMA buffers directly, saving the GPU
+ * from compositing them. Right before each paintGL() event, assignPlanes() is invoked to pick which surfaces are offloaded. The
+ * assignments are validated by the backend, dropping the last ones until accepted, and the resulting list is available through
+ * planeAssignments() during paintGL(). Surfaces assigned to a plane must not be drawn (the default paintGL() skips them).
+ *
+ * @section Software Cursor
+ *
+ * When the output has no cursor plane or it is disabled (see LCursor::enablePlane()), the cursor can be painted by calling
+ * paintCursor() at the end of paintGL(). Louvre then saves the pixels below it, and subsequent frames where only the cursor
+ * moved or changed its image restore the previous rect and paint the new one without invoking paintGL().
+ *
  * @section drm_leasing DRM Leasing
  *
  * [DRM leasing](https://wayland.app/protocols/drm-lease-v1) is a Wayland protocol and backend feature that allows clients to take control of a specific set of displays.\n
@@ -265,6 +300,10 @@ public:
      * This method returns the age of the buffer as specified in the
      * [EGL_EXT_buffer_age](https://registry.khronos.org/EGL/extensions/EXT/EGL_EXT_buffer_age.txt)
      * extension specification.
+     *
+     * When oversampling is in use, it refers to the osImage(), which persists between frames, so
+     * only the current damage needs to be repainted. It is later downsampled into the backendImage()
+     * taking its own age into account.
      */
     UInt32 imageAge() const noexcept;
 
@@ -322,6 +361,32 @@ public:
      */
     bool enableVSync(bool enabled) noexcept { return backend()->enableVSync(enabled); }
 
+    /**
+     * @brief Checks if the output supports variable refresh rate (adaptive sync).
+     */
+    bool hasVRR() const noexcept { return backend()->hasVRR(); }
+
+    /**
+     * @brief Checks if VRR is enabled (disabled by default).
+     */
+    bool isVRREnabled() const noexcept { return backend()->isVRREnabled(); }
+
+    /**
+     * @brief Toggles VRR.
+     *
+     * The change may only take effect with the next frame.
+     *
+     * @return `true` on success, `false` if unsupported or the backend failed to apply it.
+     */
+    bool setVRREnabled(bool enabled) noexcept { return backend()->setVRREnabled(enabled); }
+
+    /**
+     * @brief Refresh rate range supported while VRR is enabled in mHz.
+     *
+     * The minimum is 0 if unknown.
+     */
+    LBackendOutput::VRRRange vrrRange() const noexcept { return backend()->vrrRange(); }
+
     /**
      * @brief Gets the size of the gamma table.
      *
@@ -371,6 +436,18 @@ public:
      */
     int setMode(std::shared_ptr<LOutputMode> mode) noexcept;
 
+    /**
+     * @brief Sets the output mode without blocking.
+     *
+     * Same as setMode(), but the modeset runs on a worker thread, letting the main loop
+     * keep dispatching client requests meanwhile. The state() is @ref ChangingMode until it finishes.
+     *
+     * @param callback Invoked from the main thread with the setMode() result once done, unless the output is destroyed before.
+     *
+     * @see LSeat::applyOutputConfigurationAsync() to change the mode of multiple outputs at once.
+     */
+    void setModeAsync(std::shared_ptr<LOutputMode> mode, const std::function<void(LOutput *output, int result)> &callback = nullptr) noexcept;
+
     /**
      * @brief Gets the current state of the LOutput.
      */
@@ -393,6 +470,48 @@ public:
      */
     LSessionLockRole *sessionLockRole() const noexcept;
 
+    /**
+     * @brief Surface presented directly by the backend.
+     *
+     * Some backends can present a client buffer without compositing it, for example, the Wayland backend
+     * forwards it to the parent compositor as a subsurface when `CZ_LOUVRE_WAYLAND_PASSTHROUGH=1` is set.\n
+     * The backend picks it right before paintGL() and it is always the topmost surface intersecting the output,
+     * so paintGL() should skip drawing it (the default implementation does) while still requesting its next frame.
+     *
+     * @return The surface, or `nullptr` if all surfaces must be composited.
+     */
+    LSurface *passthroughSurface() const noexcept;
+
+    /**
+     * @brief Paints the software cursor.
+     *
+     * Must be called at the end of paintGL(), once no pass on image() is active. Does nothing if the cursor is hidden,
+     * doesn't intersect the output or is displayed by the cursor plane. The previous and current cursor rects are added to damage.
+     *
+     * Until something else calls repaint(), frames where only the cursor changed skip paintGL(), see @ref Software Cursor.
+     * Compositors painting their own cursor shouldn't call it.
+     */
+    void paintCursor() noexcept;
+
+    /**
+     * @brief Hardware overlay planes available to this output.
+     *
+     * Empty if the backend doesn't support them. Only valid while the output is initialized.
+     */
+    const std::vector<LPlane> &planes() const noexcept { return m_backend->planes(); }
+
+    /**
+     * @brief Plane assignments of the current frame.
+     *
+     * Updated right before paintGL() with the assignments from assignPlanes() accepted by the backend.
+     */
+    const std::vector<LPlaneAssignment> &planeAssignments() const noexcept;
+
+    /**
+     * @brief Returns the plane assignment of a surface in the current frame, or `nullptr` if it must be composited.
+     */
+    const LPlaneAssignment *planeAssignment(const LSurface *surface) const noexcept;
+
     /**
      * @brief Retrieves all exclusive zones assigned to this output.
      *
@@ -604,6 +723,46 @@ public:
      */
     void setContentType(RContentType type) noexcept { m_backend->setContentType(type); }
 
+    /**
+     * @brief How the output is driven according to the content being displayed.
+     *
+     * @see updateContentPolicy()
+     */
+    struct ContentPolicy
+    {
+        /// Content type hint forwarded to the display, see setContentType()
+        RContentType contentType { RContentType::Graphics };
+
+        /// The surface the policy was taken from, or `nullptr` if none
+        CZWeak<LSurface> surface;
+
+        /// Whether VSync should be enabled, see enableVSync()
+        bool vsync { true };
+
+        /// Whether VRR should be enabled, see setVRREnabled()
+        bool vrr { false };
+
+        /// Whether color accuracy is preferred over performance (e.g. the content should not be scanned out directly)
+        bool colorAccurate { false };
+    };
+
+    /**
+     * @brief The current content policy.
+     *
+     * @see setContentPolicy()
+     */
+    const ContentPolicy &contentPolicy() const noexcept;
+
+    /**
+     * @brief Sets the content policy.
+     *
+     * If the policy has a surface, forwards the content type hint with setContentType() and toggles VSync if canDisableVSync()
+     * is `true`, VRR is applied afterwards from updateVRRPolicy().\n
+     * The content type, VSync and VRR state found when the first policy with a surface is set are saved, and restored
+     * once a policy without a surface is set. A policy without a surface changes nothing otherwise.
+     */
+    void setContentPolicy(const ContentPolicy &policy) noexcept;
+
     /***************************** DRM LEASING *****************************/
 
     /**
@@ -826,6 +985,53 @@ public:
      */
     virtual void availableGeometryChanged();
 
+    /**
+     * @brief Assigns surfaces to the overlay planes for the next frame.
+     *
+     * Invoked right before paintGL() if planes() is not empty, with an empty list to fill.\n
+     * Assignments should be sorted by priority, if the backend rejects the list, the last ones are dropped
+     * (and their surfaces composited) until it is accepted.
+     *
+     * Planes are stacked above the composited image, so only surfaces not occluded by other content should be
+     * assigned. No assignments are made while the output is being captured.
+     *
+     * #### Default Implementation
+     *
+     * The default implementation offloads the topmost fully opaque, unoccluded and untransformed DMA buffer surfaces,
+     * as long as the contentPolicy() doesn't prefer color accuracy.
+     *
+     * @snippet LOutputDefault.cpp assignPlanes
+     */
+    virtual void assignPlanes(std::vector<LPlaneAssignment> &assignments);
+
+    /**
+     * @brief Gives the chance to update the content policy.
+     *
+     * Invoked from the main loop after a surface within the output changes its content type, VSync preference,
+     * fullscreen or mapping state, or after a surface enters or leaves the output.
+     *
+     * #### Default Implementation
+     *
+     * The default implementation derives the policy from the content type of the topmost mapped fullscreen toplevel
+     * within the output, see @ref Content Policy.
+     *
+     * @snippet LOutputDefault.cpp updateContentPolicy
+     */
+    virtual void updateContentPolicy();
+
+    /**
+     * @brief Gives the chance to enable or disable VRR.
+     *
+     * Invoked right after updateContentPolicy(), only if hasVRR() is `true`.
+     *
+     * #### Default Implementation
+     *
+     * The default implementation toggles VRR according to the contentPolicy(), if it has a surface.
+     *
+     * @snippet LOutputDefault.cpp updateVRRPolicy
+     */
+    virtual void updateVRRPolicy();
+
     /**
      * @brief Temporarily disables repaint calls for this output.
      *
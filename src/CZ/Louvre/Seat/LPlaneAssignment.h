@@ -0,0 +1,48 @@
+#ifndef LPLANEASSIGNMENT_H
+#define LPLANEASSIGNMENT_H
+
+#include <CZ/Louvre/Louvre.h>
+#include <CZ/Ream/RDevice.h>
+#include <CZ/Core/CZWeak.h>
+#include <CZ/skia/core/SkRect.h>
+
+namespace CZ
+{
+    /**
+     * @brief Hardware overlay plane of an output.
+     *
+     * @see LOutput::planes()
+     */
+    struct LPlane
+    {
+        /// Backend specific identifier (e.g. the DRM plane id)
+        UInt32 id { 0 };
+
+        /// DMA formats and modifiers the plane can scan out
+        RDRMFormatSet formats;
+    };
+
+    /**
+     * @brief Surface buffer scanned out by an overlay plane for a single frame.
+     *
+     * The buffer is always displayed with its full size, without scaling or transforms.
+     *
+     * @see LOutput::assignPlanes()
+     */
+    struct LPlaneAssignment
+    {
+        /// One of LOutput::planes()
+        const LPlane *plane { nullptr };
+
+        /// The surface displayed by the plane
+        CZWeak<LSurface> surface;
+
+        /// The current DMA buffer of the surface
+        CZWeak<LDMABuffer> buffer;
+
+        /// Destination rect relative to the output in buffer coordinates, with the size of the buffer
+        SkIRect dst { 0, 0, 0, 0 };
+    };
+};
+
+#endif // LPLANEASSIGNMENT_H
@@ -273,6 +273,71 @@ LPopupRole *LSeat::topmostPopup() const noexcept
     return nullptr;
 }
 
+// Applies everything but the mode and initialization state
+static std::vector<LOutput::LOutputPrivate::ModeRequest> ApplyOutputProps(const std::vector<LSeat::OutputConfiguration> &configurations) noexcept
+{
+    std::vector<LOutput::LOutputPrivate::ModeRequest> modes;
+    modes.reserve(configurations.size());
+
+    for (const auto &conf : configurations)
+    {
+        conf.output.setPos(conf.pos);
+        conf.output.setTransform(conf.transform);
+        conf.output.setScale(conf.scale);
+        modes.emplace_back(&conf.output, conf.mode);
+    }
+
+    return modes;
+}
+
+bool LSeat::applyOutputConfiguration(const std::vector<OutputConfiguration> &configurations) noexcept
+{
+    LOutput::LOutputPrivate::SetModesAsync(ApplyOutputProps(configurations), nullptr);
+    std::vector<LOutput*> added;
+
+    for (const auto &conf : configurations)
+    {
+        conf.output.imp()->finishModeset();
+
+        if (conf.initialized)
+            added.emplace_back(&conf.output);
+        else
+            compositor()->removeOutput(&conf.output);
+    }
+
+    compositor()->addOutputs(added);
+    return !compositor()->outputs().empty();
+}
+
+void LSeat::applyOutputConfigurationAsync(const std::vector<OutputConfiguration> &configurations, const std::function<void(bool)> &callback) noexcept
+{
+    std::vector<std::pair<CZWeak<LOutput>, bool>> initialized;
+    initialized.reserve(configurations.size());
+
+    for (const auto &conf : configurations)
+        initialized.emplace_back(&conf.output, conf.initialized);
+
+    LOutput::LOutputPrivate::SetModesAsync(ApplyOutputProps(configurations), [initialized, callback](const std::vector<int> &) {
+        std::vector<LOutput*> added;
+
+        for (const auto &[output, init] : initialized)
+        {
+            if (!output)
+                continue;
+
+            if (init)
+                added.emplace_back(output.get());
+            else
+                compositor()->removeOutput(output.get());
+        }
+
+        compositor()->addOutputs(added);
+
+        if (callback)
+            callback(!compositor()->outputs().empty());
+    });
+}
+
 void LSeat::setTTY(UInt32 tty) noexcept
 {
     if (imp()->libseatHandle)
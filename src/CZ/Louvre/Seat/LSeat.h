@@ -4,6 +4,7 @@
 #include <CZ/Louvre/LFactoryObject.h>
 #include <CZ/Louvre/Roles/LToplevelRole.h>
 #include <CZ/Louvre/Roles/LSurface.h>
+#include <functional>
 #include <set>
 
 struct libseat;
@@ -425,6 +426,28 @@ public:
      */
     virtual bool configureOutputsRequest(LClient* client, const std::vector<OutputConfiguration>& configurations);
 
+    /**
+     * @brief Applies multiple output configurations at once.
+     *
+     * Sets the position, transform and scale of each output, performs all mode changes concurrently
+     * and then initializes or uninitializes each output, see LCompositor::addOutput() and LCompositor::removeOutput().
+     *
+     * Blocks until done, see applyOutputConfigurationAsync() for a non-blocking alternative.
+     *
+     * @return `true` if at least one output remains initialized, `false` otherwise.
+     */
+    bool applyOutputConfiguration(const std::vector<OutputConfiguration> &configurations) noexcept;
+
+    /**
+     * @brief Non-blocking version of applyOutputConfiguration().
+     *
+     * Mode changes run on worker threads (see LOutput::setModeAsync()), the outputs are initialized or uninitialized
+     * once all finish.
+     *
+     * @param callback Invoked from the main thread once done, with the same value applyOutputConfiguration() would return.
+     */
+    void applyOutputConfigurationAsync(const std::vector<OutputConfiguration> &configurations, const std::function<void(bool)> &callback = nullptr) noexcept;
+
     /**
      * @brief Notifies of any input event.
      *
@@ -1,4 +1,5 @@
 #include <CZ/Louvre/LClient.h>
+#include <CZ/Louvre/LLog.h>
 
 using namespace CZ;
 
@@ -10,3 +11,16 @@ void LClient::pong(UInt32 serial)
     /* No default implementation */
 }
 //! [pong]
+
+//! [fdLimitExceeded]
+void LClient::fdLimitExceeded(bool hard)
+{
+    pid_t pid { -1 };
+    credentials(&pid);
+
+    if (hard)
+        LLog(CZError, CZLN, "Client (pid {}) exceeded its hard fd limit ({}), disconnecting it", pid, fdLimits().hard);
+    else
+        LLog(CZWarning, CZLN, "Client (pid {}) holds {} fds, above its soft limit ({})", pid, fdCount(), fdLimits().soft);
+}
+//! [fdLimitExceeded]
@@ -1,5 +1,6 @@
 #include <CZ/Louvre/Protocols/ImageCaptureSource/GForeignToplevelImageCaptureSourceManager.h>
 #include <CZ/Louvre/Protocols/ImageCaptureSource/GOutputImageCaptureSourceManager.h>
+#include <CZ/Louvre/Protocols/ImageCopyCapture/GImageCopyCaptureManager.h>
 #include <CZ/Louvre/Protocols/ForeignToplevelManagement/GForeignToplevelManager.h>
 #include <CZ/Louvre/Protocols/SinglePixelBuffer/GWpSinglePixelBufferManagerV1.h>
 #include <CZ/Louvre/Protocols/ForeignToplevelList/GForeignToplevelList.h>
@@ -39,6 +40,7 @@
 #include <CZ/Louvre/Roles/LToplevelRole.h>
 #include <CZ/Louvre/Cursor/LCursor.h>
 #include <CZ/Louvre/Cursor/LCursorSource.h>
+#include <CZ/Louvre/Cursor/LXCursorTheme.h>
 #include <CZ/Louvre/Roles/LSubsurfaceRole.h>
 #include <CZ/Louvre/Seat/LPointer.h>
 #include <CZ/Louvre/Seat/LKeyboard.h>
@@ -124,12 +126,18 @@ bool LCompositor::createGlobalsRequest()
     // Allows clients to clip and scale buffers
     createGlobal<Viewporter::GViewporter>();
 
+    /* Screen capture globals, disabled by default since any client could read the screen contents.
+     * Enable them and restrict access to trusted clients with globalsFilter() */
+
     // Allows toplevels to be used as image capture sources
     //createGlobal<ImageCaptureSource::GForeignToplevelImageCaptureSourceManager>();
 
     // Allows outputs to be used as image capture sources
     //createGlobal<ImageCaptureSource::GOutputImageCaptureSourceManager>();
 
+    // Allows clients to capture outputs and toplevels (requires the image capture source globals)
+    //createGlobal<ImageCopyCapture::GImageCopyCaptureManager>();
+
     // Allows clients to create wlr_layer_shell surfaces
     createGlobal<LayerShell::GLayerShell>();
 
@@ -192,8 +200,9 @@ void LCompositor::initialized() noexcept
     loadCursorShapes();
 
     SkIPoint outputPos {0, 0};
+    std::vector<LOutput*> desktopOutputs;
 
-    // Initializes and arranges outputs from left to right
+    // Arranges outputs from left to right
     for (LOutput *output : seat()->outputs())
     {
         // Probably a VR headset, meant to be leased by clients
@@ -215,10 +224,14 @@ void LCompositor::initialized() noexcept
         // Next output x coord
         outputPos.fX = outputPos.x() + output->size().width();
 
-        // Initialize
-        addOutput(output);
-        output->repaint();
+        desktopOutputs.emplace_back(output);
     }
+
+    // Initializes them in parallel
+    addOutputs(desktopOutputs);
+
+    for (LOutput *output : outputs())
+        output->repaint();
 }
 //! [initialized]
 
@@ -227,65 +240,24 @@ void LCompositor::loadCursorShapes() noexcept
     if (!wellKnownGlobals.CursorShapeManager)
         return;
 
-    const std::vector<std::vector<const char*>> names
-    {
-     /* Default */        { "left_ptr", "arrow" },
-     /* ContextMenu */    { "context-menu", "arrow" },
-     /* Help */           { "question_arrow", "help" },
-     /* Pointer */        { "hand2", "pointer" },
-     /* Progress */       { "watch", "left_ptr_watch" },
-     /* Wait */           { "watch", "left_ptr_watch" },
-     /* Cell */           { "xterm", "crosshair" },
-     /* Crosshair */      { "crosshair", "tcross" },
-     /* Text */           { "xterm", "ibeam" },
-     /* VerticalText */   { "xterm", "ibeam" },
-     /* Alias */          { "alias", "draped_box" },
-     /* Copy */           { "copy", "draped_box" },
-     /* Move */           { "move", "fleur" },
-     /* NoDrop */         { "no-drop", "circle" },
-     /* NotAllowed */     { "not-allowed", "circle" },
-     /* Grab */           { "grab", "fleur" },
-     /* Grabbing */       { "grabbing", "fleur" },
-     /* ResizeR */        { "right_side", "e-resize" },
-     /* ResizeT */        { "top_side", "n-resize" },
-     /* ResizeTR */       { "top_right_corner", "ne-resize" },
-     /* ResizeTL */       { "top_left_corner", "nw-resize" },
-     /* ResizeB */        { "bottom_side", "s-resize" },
-     /* ResizeBR */       { "bottom_right_corner", "se-resize" },
-     /* ResizeBL */       { "bottom_left_corner", "sw-resize" },
-     /* ResizeL */        { "left_side", "w-resize" },
-     /* ResizeLR */       { "sb_h_double_arrow", "h_double_arrow" },
-     /* ResizeTB */       { "sb_v_double_arrow", "v_double_arrow" },
-     /* ResizeTRBL */     { "top_right_corner", "bottom_left_corner" },
-     /* ResizeTLBR */     { "top_left_corner", "bottom_right_corner" },
-     /* ResizeColumn */   { "sb_h_double_arrow", "h_double_arrow" },
-     /* ResizeRow */      { "sb_v_double_arrow", "v_double_arrow" },
-     /* AllScroll */      { "fleur", "cross" },
-     /* ZoomIn */         { "zoom-in", "plus" },
-     /* ZoomOut */        { "zoom-out", "minus" },
-     /* DragAndDropAsk */ { "question_arrow", "hand2" },
-     /* MoveOrResize */   { "fleur", "hand2" },
-     };
-
-    const char *theme {};
-    const Int32 size { 64 };
-
-    for (size_t i = 0; i < names.size(); i++)
-    {
-        const auto shape { CZCursorShape(i+1) };
-        const auto &set { names[i] };
+    // Parsed on a worker thread, avoids delaying the first frame
+    auto theme { LXCursorTheme::Get() };
+
+    if (!theme)
+        return;
 
-        for (const char *name : set)
+    theme->onReady([theme]{
+        const Int32 size { 64 };
+
+        for (size_t i = 0; i < size_t(CZCursorShape::MoveOrResize); i++)
         {
-            cursor()->setShapeAsset(shape, LCursorSource::MakeFromTheme(name, theme, size));
+            const auto shape { CZCursorShape(i+1) };
+            cursor()->setShapeAsset(shape, theme->shape(shape, size));
 
-            if (cursor()->getShapeAsset(shape))
-                break;
+            if (!cursor()->getShapeAsset(shape))
+                LLog(CZWarning, CZLN, "Could not find a cursor for shape {}", i+1);
         }
-
-        if (!cursor()->getShapeAsset(shape))
-            log(CZWarning, CZLN, "Could not find a cursor for shape {}", i+1);
-    }
+    });
 }
 
 //! [uninitialized]
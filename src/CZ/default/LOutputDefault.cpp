@@ -16,9 +16,12 @@
 #include <CZ/Louvre/Roles/LLayerRole.h>
 #include <CZ/Louvre/Roles/LSubsurfaceRole.h>
 #include <CZ/Louvre/Roles/LPopupRole.h>
+#include <CZ/Louvre/Roles/LToplevelRole.h>
 
 #include <CZ/Louvre/Protocols/PresentationTime/RPresentationFeedback.h>
+#include <CZ/Louvre/Protocols/LinuxDMABuf/LDMABuffer.h>
 #include <CZ/Louvre/Private/LOutputPrivate.h>
+#include <CZ/Louvre/Private/LSurfaceTree.h>
 
 #include <CZ/Ream/RSurface.h>
 #include <CZ/Ream/RPass.h>
@@ -35,7 +38,17 @@ void LOutput::initializeGL()
 //! [initializeGL]
 
 //! [paintGL]
-static void DrawSurface(RPainter *p, LSurface *s) noexcept
+// Toplevels hidden for a while stop receiving frame callbacks, see LToplevelRole::isAutoSuspended()
+static bool IsAutoSuspended(LSurface *s) noexcept
+{
+    for (; s; s = s->parent())
+        if (s->toplevel())
+            return s->toplevel()->isAutoSuspended();
+
+    return false;
+}
+
+static void DrawSurface(LOutput *output, RPainter *p, LSurface *s) noexcept
 {
     RDrawImageInfo info {};
     info.dst = SkIRect::MakePtSize(s->rolePos(), s->size());
@@ -53,59 +66,47 @@ static void DrawSurface(RPainter *p, LSurface *s) noexcept
             s->sendOutputLeaveEvent(o);
     }
 
-    // If the surface has an exclusive output, prevent leaks it into this one
-    if (s->role() && s->role()->exclusiveOutput())
+    // Already presented by the backend, see LOutput::passthroughSurface() and LOutput::assignPlanes()
+    if (s == output->passthroughSurface() || output->planeAssignment(s))
     {
-        const SkRegion clip { s->role()->exclusiveOutput()->rect() };
-        p->drawImage(info, &clip);
+        s->requestNextFrame();
+        return;
     }
-    else
-        p->drawImage(info);
 
-    s->requestNextFrame();
-}
-
-static void DrawSubsurfaces(RPainter *p, const std::vector<LSubsurfaceRole*> &subsurfaces) noexcept
-{
-    for (auto *sub : subsurfaces)
+    // Single pixel buffers are filled instead of sampled
+    if (const auto color { s->solidColor() })
     {
-        if (!sub->surface()->mapped())
-            continue;
+        SkRegion region { info.dst };
 
-        DrawSubsurfaces(p, sub->surface()->subsurfacesBelow());
-        DrawSurface(p, sub->surface());
-        DrawSubsurfaces(p, sub->surface()->subsurfacesAbove());
-    }
-}
+        if (s->role() && s->role()->exclusiveOutput())
+            region.op(s->role()->exclusiveOutput()->rect(), SkRegion::kIntersect_Op);
 
-static void DrawTree(RPainter *p, LSurface *s) noexcept
-{
-    if (!s->mapped() || (s->toplevel() && s->toplevel()->isMinimized())) return;
+        p->save();
+        p->setColor(*color);
 
-    DrawSubsurfaces(p, s->subsurfacesBelow());
-    DrawSurface(p, s);
-    DrawSubsurfaces(p, s->subsurfacesAbove());
+        // Nothing to blend
+        if (SkColorGetA(*color) == 0xFF)
+            p->setBlendMode(RBlendMode::Src);
 
-    if (auto *toplevel = s->toplevel())
-    {
-        for (auto *child : toplevel->childPopups())
-            DrawTree(p, child->surface());
-
-        for (auto *child :toplevel->childToplevels())
-            DrawTree(p, child->surface());
-    }
-    else if (auto *popup = s->popup())
-    {
-        for (auto *child : popup->childPopups())
-            DrawTree(p, child->surface());
+        p->drawColor(region);
+        p->restore();
     }
-    else if (auto *layerRole = s->layerRole())
+    // If the surface has an exclusive output, prevent leaks it into this one
+    else if (s->role() && s->role()->exclusiveOutput())
     {
-        for (auto *child : layerRole->childPopups())
-            DrawTree(p, child->surface());
+        const SkRegion clip { s->role()->exclusiveOutput()->rect() };
+        p->drawImage(info, &clip);
     }
+    else
+        p->drawImage(info);
 
-    // Session lock roles only contain subsurfaces
+    if (!IsAutoSuspended(s))
+        s->requestNextFrame();
+}
+
+static void DrawTree(LOutput *output, RPainter *p, LSurface *s) noexcept
+{
+    LSurfaceTree::ForEach(s, [output, p](LSurface *surface) { DrawSurface(output, p, surface); });
 }
 
 void LOutput::paintGL()
@@ -132,33 +133,37 @@ void LOutput::paintGL()
     {
         // Session lock surface assigned to this output
         if (sessionLockRole())
-            DrawTree(p, sessionLockRole()->surface());
-
-        return;
+            DrawTree(this, p, sessionLockRole()->surface());
     }
-
-    if (seat()->dnd()->icon())
-        seat()->dnd()->icon()->surface()->raise();
-
-    // From LLayerBackground to LLayerOverlay layers
-    for (const auto &layer : compositor()->layers())
+    else
     {
-        for (LSurface *s : layer)
-        {
-            // Child surfaces are rendered by DrawTree
-            if (s->parent())
-                continue;
+        if (seat()->dnd()->icon())
+            seat()->dnd()->icon()->surface()->raise();
 
-            // Cursor surfaces are rendered by LCursor
-            if (s->cursorRole())
+        // From LLayerBackground to LLayerOverlay layers
+        for (const auto &layer : compositor()->layers())
+        {
+            for (LSurface *s : layer)
             {
-                s->requestNextFrame();
-                continue;
-            }
+                // Child surfaces are rendered by DrawTree
+                if (s->parent())
+                    continue;
+
+                // Cursor surfaces are rendered by LCursor
+                if (s->cursorRole())
+                {
+                    s->requestNextFrame();
+                    continue;
+                }
 
-            DrawTree(p, s);
+                DrawTree(this, p, s);
+            }
         }
     }
+
+    // Finish the pass before painting the cursor if there is no plane for it
+    pass.reset();
+    paintCursor();
 }
 //! [paintGL]
 
@@ -275,6 +280,149 @@ void LOutput::availableGeometryChanged()
 }
 //! [availableGeometryChanged]
 
+//! [assignPlanes]
+// Opaque DMA buffers displayed 1:1, without transforms, scaling or cropping
+static LDMABuffer *PlaneCandidateBuffer(LOutput *output, LSurface *s, const SkIRect &rect) noexcept
+{
+    if (!output->rect().contains(rect) || s->bufferTransform() != CZTransform::Normal)
+        return nullptr;
+
+    if (!s->bufferResource() || !LDMABuffer::isDMABuffer((wl_resource*)s->bufferResource()))
+        return nullptr;
+
+    if (s->role() && s->role()->exclusiveOutput() && s->role()->exclusiveOutput() != output)
+        return nullptr;
+
+    if (!s->opaqueRegion().contains(SkIRect::MakeSize(s->size())))
+        return nullptr;
+
+    const auto image { s->image() };
+    const SkISize size { SkISize::Make(s->size().width() * output->scale(), s->size().height() * output->scale()) };
+
+    if (!image || image->size() != size || s->srcRect() != SkRect::Make(s->size()))
+        return nullptr;
+
+    return static_cast<LDMABuffer*>(wl_resource_get_user_data((wl_resource*)s->bufferResource()));
+}
+
+void LOutput::assignPlanes(std::vector<LPlaneAssignment> &assignments)
+{
+    if (contentPolicy().colorAccurate ||
+        usingFractionalScale() ||
+        transform() != CZTransform::Normal ||
+        sessionLockManager()->state() != LSessionLockManager::Unlocked)
+        return;
+
+    // Same order used by the default LOutput::paintGL()
+    std::vector<LSurface*> surfaces;
+    LSurfaceTree::Collect(surfaces);
+
+    // Content above the current surface, planes are stacked above the composited image
+    SkRegion occluders;
+
+    // Drawn into the composited image
+    if (cursor()->isVisible() && !cursor()->isPlaneEnabled(this))
+        occluders.setRect(cursor()->rect());
+
+    std::vector<bool> used(planes().size(), false);
+
+    for (auto it = surfaces.rbegin(); it != surfaces.rend() && assignments.size() < planes().size(); it++)
+    {
+        LSurface *s { *it };
+        const SkIRect rect { SkIRect::MakePtSize(s->rolePos(), s->size()) };
+
+        if (!SkIRect::Intersects(rect, this->rect()))
+            continue;
+
+        LDMABuffer *buffer { occluders.intersects(rect) ? nullptr : PlaneCandidateBuffer(this, s, rect) };
+
+        for (size_t i = 0; buffer && i < planes().size(); i++)
+        {
+            if (used[i])
+                continue;
+
+            const auto fmt { planes()[i].formats.formats().find(buffer->dmaInfo().format) };
+
+            if (fmt == planes()[i].formats.formats().end() || !fmt->modifiers().contains(buffer->dmaInfo().modifier))
+                continue;
+
+            auto &assignment { assignments.emplace_back() };
+            assignment.plane = &planes()[i];
+            assignment.surface.reset(s);
+            assignment.buffer.reset(buffer);
+            // Same destination the composited path would use
+            assignment.dst = SkIRect::MakeXYWH(
+                (rect.x() - pos().x()) * scale(),
+                (rect.y() - pos().y()) * scale(),
+                rect.width() * scale(),
+                rect.height() * scale());
+            used[i] = true;
+            break;
+        }
+
+        occluders.op(rect, SkRegion::kUnion_Op);
+    }
+}
+//! [assignPlanes]
+
+//! [updateContentPolicy]
+void LOutput::updateContentPolicy()
+{
+    ContentPolicy policy {};
+
+    // Topmost fullscreen toplevel
+    for (auto layer = compositor()->layers().rbegin(); layer != compositor()->layers().rend() && !policy.surface; layer++)
+    {
+        for (auto it = layer->rbegin(); it != layer->rend(); it++)
+        {
+            LSurface *surface { *it };
+
+            if (surface->mapped() &&
+                surface->toplevel() &&
+                surface->toplevel()->isFullscreen() &&
+                surface->outputs().contains(this))
+            {
+                policy.surface.reset(surface);
+                policy.contentType = surface->contentType();
+                policy.vsync = surface->prefersVSync();
+                break;
+            }
+        }
+    }
+
+    switch (policy.contentType)
+    {
+    case RContentType::Video:
+        // Refresh at the video frame rate
+        policy.vrr = true;
+        break;
+    case RContentType::Game:
+        // Present as soon as possible, tearing only if the client allows it
+        policy.vrr = true;
+        break;
+    case RContentType::Photo:
+        policy.colorAccurate = true;
+        break;
+    default:
+        break;
+    }
+
+    setContentPolicy(policy);
+}
+//! [updateContentPolicy]
+
+//! [updateVRRPolicy]
+void LOutput::updateVRRPolicy()
+{
+    // Without a surface the compositor's own setting was restored by setContentPolicy()
+    if (!contentPolicy().surface)
+        return;
+
+    if (isVRREnabled() != contentPolicy().vrr)
+        setVRREnabled(contentPolicy().vrr);
+}
+//! [updateVRRPolicy]
+
 //! [repaintFilter]
 bool LOutput::repaintFilter()
 {
@@ -284,40 +432,38 @@ bool LOutput::repaintFilter()
 
 void LOutput::presentationEvent(const CZPresentationEvent &e) noexcept
 {
-    for (auto it = imp()->waitingPresentationFeedback.begin(); it != imp()->waitingPresentationFeedback.end();)
+    auto &bucket { imp()->presentationBuckets[e.info.paintEventId % imp()->presentationBuckets.size()] };
+
+    if (bucket.paintEventId != e.info.paintEventId)
+        return;
+
+    const auto feedbackList { std::move(bucket.feedback) };
+    bucket.feedback.clear();
+
+    for (const auto &feedback : feedbackList)
     {
-        if (!(*it))
-        {
-            it = imp()->waitingPresentationFeedback.erase(it);
+        if (!feedback)
             continue;
-        }
 
-        if ((*it)->paintEventId != e.info.paintEventId)
+        if (e.discarded)
         {
-            it++;
+            feedback->discarded();
             continue;
         }
 
-        if (e.discarded)
-        {
-            (*it)->discarded();
-        }
-        else
-        {
-            for (auto *outputGlobal : (*it)->client()->outputGlobals())
-                if (outputGlobal->output() == this)
-                    (*it)->syncOutput(outputGlobal);
-
-            (*it)->presented(e.info.time.tv_sec >> 32,
-                             e.info.time.tv_sec & 0xffffffff,
-                             e.info.time.tv_nsec,
-                             e.info.period,
-                             e.info.seq >> 32,
-                             e.info.seq & 0xffffffff,
-                             e.info.flags);
-        }
+        auto globals { imp()->clientGlobals.find(feedback->client()) };
+
+        if (globals != imp()->clientGlobals.end())
+            for (auto *outputGlobal : globals->second)
+                feedback->syncOutput(outputGlobal);
 
-        it = imp()->waitingPresentationFeedback.erase(it);
+        feedback->presented(e.info.time.tv_sec >> 32,
+                            e.info.time.tv_sec & 0xffffffff,
+                            e.info.time.tv_nsec,
+                            e.info.period,
+                            e.info.seq >> 32,
+                            e.info.seq & 0xffffffff,
+                            e.info.flags);
     }
 }
 
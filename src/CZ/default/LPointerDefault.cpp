@@ -1,4 +1,3 @@
-#include <CZ/Core/Utils/CZRegionUtils.h>
 #include <CZ/Louvre/LLog.h>
 #include <CZ/Louvre/Seat/LPointer.h>
 #include <CZ/Louvre/Seat/LSeat.h>
@@ -37,7 +36,7 @@ void LPointer::pointerMoveEvent(const CZPointerMoveEvent &event)
         // Attempt to enable the pointer constraint mode if the cursor is within the constrained region.
         if (focus()->pointerConstraintMode() != LSurface::PointerConstraintMode::Free)
         {
-            if (focus()->pointerConstraintRegion().contains(cursor()->pos().x() - fpos.x(), cursor()->pos().y() - fpos.y()))
+            if (focus()->pointerConstraintRegionContains(cursor()->pos() - fpos))
                 focus()->enablePointerConstraint(true);
         }
 
@@ -52,7 +51,7 @@ void LPointer::pointerMoveEvent(const CZPointerMoveEvent &event)
                     cursor()->move(-event.delta.x(), -event.delta.y());
 
                     const SkPoint closestPoint {
-                        CZRegionUtils::ClosestPointFrom(focus()->pointerConstraintRegion(), cursor()->pos() - fpos)
+                        focus()->closestPointerConstraintPoint(cursor()->pos() - fpos)
                     };
 
                     cursor()->setPos(fpos + closestPoint);
@@ -61,7 +60,7 @@ void LPointer::pointerMoveEvent(const CZPointerMoveEvent &event)
             else /* Confined */
             {
                 const SkPoint closestPoint {
-                    CZRegionUtils::ClosestPointFrom(focus()->pointerConstraintRegion(), cursor()->pos() - fpos)
+                    focus()->closestPointerConstraintPoint(cursor()->pos() - fpos)
                 };
 
                 cursor()->setPos(fpos + closestPoint);
@@ -17,21 +17,8 @@ bool LSeat::configureOutputsRequest(LClient *client, const std::vector<OutputCon
     // All requests accepted by default (unsafe) see LCompositor::globalsFilter().
     CZ_UNUSED(client)
 
-    for (const auto &conf : configurations)
-    {
-        conf.output.setPos(conf.pos);
-        conf.output.setTransform(conf.transform);
-        conf.output.setScale(conf.scale);
-        conf.output.setMode(conf.mode);
-
-        if (conf.initialized)
-            compositor()->addOutput(&conf.output);
-        else
-            compositor()->removeOutput(&conf.output);
-    }
-
     // Revert changes if the configuration results in zero initialized outputs
-    return !compositor()->outputs().empty();
+    return applyOutputConfiguration(configurations);
 }
 //! [configureOutputsRequest]
 
@@ -0,0 +1,942 @@
+#include <CZ/Louvre/Backends/Offscreen/LOffscreenBackend.h>
+#include <CZ/Louvre/Private/LProtocolRecorder.h>
+#include <CZ/Louvre/Events/LSurfaceCommitEvent.h>
+#include <CZ/Louvre/Roles/LSurface.h>
+#include <CZ/Louvre/Seat/LOutput.h>
+#include <CZ/Louvre/LCompositor.h>
+#include <CZ/Louvre/LLog.h>
+#include <CZ/Core/Events/CZPresentationEvent.h>
+#include <wayland-client-core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <time.h>
+
+/* Plays back a recording made with CZ_LOUVRE_RECORD against a compositor running on the
+ * offscreen backend and reports commit-to-present latency, main loop CPU time and allocations.
+ *
+ * Usage: cz-louvre-replay [--fast] <recording>
+ *
+ * By default requests are replayed with their original timing, --fast replays them as fast
+ * as the compositor can process them (a roundtrip is performed after each commit).
+ *
+ * Limitations: file descriptors can't be recorded, so requests carrying them are skipped
+ * except wl_shm.create_pool. DMA buffers are replaced by SHM buffers with their read back contents,
+ * and objects created by the compositor (e.g. wl_data_offer) are not tracked. */
+
+using namespace CZ;
+
+extern "C" const wl_interface wl_display_interface;
+
+/******************** ALLOCATIONS ********************/
+
+static thread_local bool t_countAllocs { false };
+static UInt64 s_allocCount { 0 };
+static UInt64 s_allocBytes { 0 };
+
+static void *CountedAlloc(size_t size)
+{
+    if (t_countAllocs)
+    {
+        s_allocCount++;
+        s_allocBytes += size;
+    }
+
+    if (void *ptr = malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size) { return CountedAlloc(size); }
+void *operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+static UInt64 NowNs() noexcept
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return UInt64(ts.tv_sec) * 1000000000ULL + UInt64(ts.tv_nsec);
+}
+
+/******************** COMPOSITOR ********************/
+
+static std::vector<UInt64> s_latencies;
+
+class ReplaySurface final : public LSurface
+{
+public:
+    using LSurface::LSurface;
+
+    void commitEvent(const LSurfaceCommitEvent &e) noexcept override
+    {
+        LSurface::commitEvent(e);
+
+        // Only the first unpresented commit counts
+        if (e.changes.has(LSurfaceCommitEvent::DamageRegionChanged) && commitNs == 0)
+            commitNs = NowNs();
+    }
+
+    UInt64 commitNs { 0 };
+};
+
+class ReplayOutput final : public LOutput
+{
+public:
+    using LOutput::LOutput;
+
+    void paintGL() override
+    {
+        LOutput::paintGL();
+
+        for (LSurface *s : compositor()->surfaces())
+        {
+            auto *surface { static_cast<ReplaySurface*>(s) };
+
+            if (surface->commitNs != 0 && surface->mapped() && SkIRect::Intersects(rect(), SkIRect::MakePtSize(s->rolePos(), s->size())))
+            {
+                m_painted.emplace_back(surface->commitNs);
+                surface->commitNs = 0;
+            }
+        }
+    }
+
+    void presentationEvent(const CZPresentationEvent &e) noexcept override
+    {
+        LOutput::presentationEvent(e);
+        const UInt64 now { NowNs() };
+
+        for (UInt64 commitNs : m_painted)
+            s_latencies.emplace_back(now - commitNs);
+
+        m_painted.clear();
+    }
+
+private:
+    std::vector<UInt64> m_painted;
+};
+
+class ReplayCompositor final : public LCompositor
+{
+public:
+    LFactoryObject *createObjectRequest(LFactoryObject::Type objectType, const void *params) override
+    {
+        if (objectType == LFactoryObject::Type::LSurface)
+            return new ReplaySurface(params);
+
+        if (objectType == LFactoryObject::Type::LOutput)
+            return new ReplayOutput(params);
+
+        return nullptr;
+    }
+};
+
+/******************** RECORDING ********************/
+
+struct Record
+{
+    LProtocolRecorder::RecordType type;
+    UInt64 timeNs;
+    UInt32 clientId;
+    const UInt8 *data;
+    UInt32 size;
+};
+
+class Reader
+{
+public:
+    Reader(const UInt8 *data, size_t size) noexcept : m_data(data), m_end(data + size) {}
+
+    template<class T>
+    bool get(T *value) noexcept
+    {
+        if (size_t(m_end - m_data) < sizeof(T))
+            return false;
+
+        memcpy(value, m_data, sizeof(T));
+        m_data += sizeof(T);
+        return true;
+    }
+
+    const UInt8 *bytes(size_t size) noexcept
+    {
+        if (size_t(m_end - m_data) < size)
+            return nullptr;
+
+        const UInt8 *ret { m_data };
+        m_data += size;
+        return ret;
+    }
+
+    // Returns false on error, *str is nullptr for null strings
+    bool string(std::string *storage, const char **str) noexcept
+    {
+        UInt32 len;
+
+        if (!get(&len))
+            return false;
+
+        if (len == LProtocolRecorder::NullString)
+        {
+            *str = nullptr;
+            return true;
+        }
+
+        const UInt8 *data { bytes(len) };
+
+        if (!data)
+            return false;
+
+        storage->assign(reinterpret_cast<const char*>(data), len);
+        *str = storage->c_str();
+        return true;
+    }
+
+    bool done() const noexcept { return m_data >= m_end; }
+
+private:
+    const UInt8 *m_data;
+    const UInt8 *m_end;
+};
+
+static bool LoadRecords(const char *path, std::vector<UInt8> &file, std::vector<Record> &records) noexcept
+{
+    FILE *f { fopen(path, "rb") };
+
+    if (!f)
+    {
+        LLog(CZFatal, CZLN, "Failed to open recording {}", path);
+        return false;
+    }
+
+    fseek(f, 0, SEEK_END);
+    file.resize(ftell(f));
+    fseek(f, 0, SEEK_SET);
+    const bool ok { fread(file.data(), 1, file.size(), f) == file.size() };
+    fclose(f);
+
+    Reader reader { file.data(), file.size() };
+    const UInt8 *magic { reader.bytes(sizeof(LProtocolRecorder::Magic)) };
+    UInt16 version;
+
+    if (!ok || !magic || memcmp(magic, LProtocolRecorder::Magic, sizeof(LProtocolRecorder::Magic)) != 0 ||
+        !reader.get(&version) || version != LProtocolRecorder::FormatVersion)
+    {
+        LLog(CZFatal, CZLN, "Invalid or unsupported recording {}", path);
+        return false;
+    }
+
+    while (!reader.done())
+    {
+        Record record;
+        UInt8 type;
+
+        if (!reader.get(&type) || !reader.get(&record.timeNs) || !reader.get(&record.clientId) || !reader.get(&record.size) ||
+            !(record.data = reader.bytes(record.size)))
+        {
+            LLog(CZWarning, CZLN, "Truncated recording, replaying {} records", records.size());
+            break;
+        }
+
+        record.type = static_cast<LProtocolRecorder::RecordType>(type);
+        records.emplace_back(record);
+    }
+
+    return true;
+}
+
+/******************** CLIENT ********************/
+
+struct Pool
+{
+    ~Pool() noexcept
+    {
+        if (map) munmap(map, size);
+        if (fd >= 0) close(fd);
+    }
+
+    bool resize(size_t newSize) noexcept
+    {
+        if (newSize <= size)
+            return true;
+
+        if (ftruncate(fd, newSize) != 0)
+            return false;
+
+        if (map)
+            munmap(map, size);
+
+        map = static_cast<UInt8*>(mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+
+        if (map == MAP_FAILED)
+        {
+            map = nullptr;
+            size = 0;
+            return false;
+        }
+
+        size = newSize;
+        return true;
+    }
+
+    int fd { memfd_create("cz-louvre-replay", MFD_CLOEXEC) };
+    UInt8 *map { nullptr };
+    size_t size { 0 };
+};
+
+struct Connection
+{
+    struct Object
+    {
+        wl_proxy *proxy;
+        const wl_interface *interface;
+    };
+
+    struct Global
+    {
+        UInt32 name;
+        std::string interface;
+        UInt32 version;
+        bool used;
+    };
+
+    struct Buffer
+    {
+        std::shared_ptr<Pool> pool;
+        Int32 offset;
+    };
+
+    ~Connection() noexcept
+    {
+        // Proxies are released by libwayland
+        if (display)
+            wl_display_disconnect(display);
+    }
+
+    wl_display *display { nullptr };
+    wl_proxy *registry { nullptr }; // Own registry, used to remap global names
+    wl_proxy *shm { nullptr };      // Used for DMA buffer replacements
+    std::unordered_map<UInt32, Object> objects;
+    std::unordered_map<UInt32, std::shared_ptr<Pool>> pools;
+    std::unordered_map<UInt32, Buffer> buffers;
+    std::vector<Global> globals;
+    std::unordered_map<UInt32, UInt32> globalNames; // Recorded name > own name
+};
+
+struct Stats
+{
+    UInt64 replayed { 0 };
+    UInt64 skipped { 0 };
+    UInt64 commits { 0 };
+};
+
+static void HandleGlobal(void *data, wl_proxy */*registry*/, UInt32 name, const char *interface, UInt32 version)
+{
+    static_cast<Connection*>(data)->globals.emplace_back(Connection::Global { name, interface, version, false });
+}
+
+static void HandleGlobalRemove(void *data, wl_proxy */*registry*/, UInt32 name)
+{
+    auto &globals { static_cast<Connection*>(data)->globals };
+    globals.erase(std::remove_if(globals.begin(), globals.end(), [name](const auto &g) { return g.name == name; }), globals.end());
+}
+
+// Same layout as wl_registry_listener
+static const struct
+{
+    void (*global)(void *, wl_proxy *, UInt32, const char *, UInt32);
+    void (*globalRemove)(void *, wl_proxy *, UInt32);
+} s_registryListener { &HandleGlobal, &HandleGlobalRemove };
+
+class Replayer
+{
+public:
+    Replayer(const std::vector<Record> &records, const std::string &socket, bool fast, std::unordered_map<std::string, const wl_interface*> &&interfaces) noexcept :
+        m_records(records), m_socket(socket), m_fast(fast), m_interfaces(std::move(interfaces)) {}
+
+    void run() noexcept
+    {
+        const UInt64 start { NowNs() };
+
+        for (const Record &record : m_records)
+        {
+            if (!m_fast)
+            {
+                while (NowNs() - start < record.timeNs)
+                    pump(std::max<Int64>(1, (record.timeNs - (NowNs() - start)) / 1000000));
+            }
+
+            handleRecord(record);
+            pump(0);
+        }
+
+        for (auto &conn : m_connections)
+            if (conn.second->display)
+                wl_display_roundtrip(conn.second->display);
+
+        m_connections.clear();
+    }
+
+    const Stats &stats() const noexcept { return m_stats; }
+
+private:
+    void pump(int timeoutMs) noexcept
+    {
+        std::vector<pollfd> fds;
+
+        for (auto &conn : m_connections)
+        {
+            wl_display_dispatch_pending(conn.second->display);
+            wl_display_flush(conn.second->display);
+            fds.emplace_back(pollfd { wl_display_get_fd(conn.second->display), POLLIN, 0 });
+        }
+
+        if (fds.empty())
+        {
+            if (timeoutMs > 0)
+                usleep(timeoutMs * 1000);
+            return;
+        }
+
+        if (poll(fds.data(), fds.size(), timeoutMs) <= 0)
+            return;
+
+        size_t i { 0 };
+
+        for (auto &conn : m_connections)
+        {
+            if (fds[i++].revents & POLLIN)
+                wl_display_dispatch(conn.second->display);
+        }
+    }
+
+    void handleRecord(const Record &record) noexcept
+    {
+        switch (record.type)
+        {
+        case LProtocolRecorder::ClientConnected:
+        {
+            auto conn { std::make_unique<Connection>() };
+            conn->display = wl_display_connect(m_socket.c_str());
+
+            if (!conn->display)
+            {
+                LLog(CZError, CZLN, "Failed to connect replay client {}", record.clientId);
+                return;
+            }
+
+            conn->objects[1] = { reinterpret_cast<wl_proxy*>(conn->display), &wl_display_interface };
+            m_connections[record.clientId] = std::move(conn);
+            break;
+        }
+        case LProtocolRecorder::ClientDisconnected:
+        {
+            auto it { m_connections.find(record.clientId) };
+
+            if (it != m_connections.end())
+            {
+                wl_display_roundtrip(it->second->display);
+                m_connections.erase(it);
+            }
+            break;
+        }
+        case LProtocolRecorder::Request:
+            if (auto *conn = connection(record.clientId))
+                handleRequest(*conn, record);
+            break;
+        case LProtocolRecorder::ShmContents:
+            if (auto *conn = connection(record.clientId))
+                handleShmContents(*conn, record);
+            break;
+        case LProtocolRecorder::DMAContents:
+            if (auto *conn = connection(record.clientId))
+                handleDMAContents(*conn, record);
+            break;
+        }
+    }
+
+    Connection *connection(UInt32 clientId) noexcept
+    {
+        auto it { m_connections.find(clientId) };
+        return it == m_connections.end() ? nullptr : it->second.get();
+    }
+
+    const wl_interface *findInterface(const char *name) const noexcept
+    {
+        auto it { m_interfaces.find(name) };
+        return it == m_interfaces.end() ? nullptr : it->second;
+    }
+
+    // Maps a recorded global name to one of ours with the same interface
+    const Connection::Global *findGlobal(Connection &conn, UInt32 recordedName, const char *interface) noexcept
+    {
+        if (!conn.registry)
+        {
+            const wl_message &getRegistry { wl_display_interface.methods[1] };
+            conn.registry = wl_proxy_marshal_flags(reinterpret_cast<wl_proxy*>(conn.display), 1, getRegistry.types[0], 1, 0, nullptr);
+            wl_proxy_add_listener(conn.registry, (void(**)(void))&s_registryListener, &conn);
+            wl_display_roundtrip(conn.display);
+        }
+
+        auto mapped { conn.globalNames.find(recordedName) };
+
+        for (auto &global : conn.globals)
+        {
+            if (mapped != conn.globalNames.end())
+            {
+                if (global.name == mapped->second)
+                    return &global;
+            }
+            else if (!global.used && global.interface == interface)
+            {
+                global.used = true;
+                conn.globalNames[recordedName] = global.name;
+                return &global;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static bool IsDestructor(const wl_message &message) noexcept
+    {
+        return strcmp(message.name, "destroy") == 0 || strcmp(message.name, "release") == 0;
+    }
+
+    // Requests that can't work without the file descriptors or DMA buffers they depend on
+    static bool MustSkip(const char *interface, const wl_message &message) noexcept
+    {
+        return (strcmp(interface, "zwp_linux_dmabuf_v1") == 0 && strcmp(message.name, "create_params") == 0) ||
+               (strcmp(interface, "wp_linux_drm_syncobj_manager_v1") == 0 && strcmp(message.name, "get_surface") == 0);
+    }
+
+    void handleRequest(Connection &conn, const Record &record) noexcept
+    {
+        Reader reader { record.data, record.size };
+        UInt32 objectId;
+        UInt16 opcode;
+        UInt8 argc;
+        std::string interfaceStorage;
+        const char *interface;
+
+        if (!reader.get(&objectId) || !reader.get(&opcode) || !reader.string(&interfaceStorage, &interface) || !interface || !reader.get(&argc))
+        {
+            m_stats.skipped++;
+            return;
+        }
+
+        auto objectIt { conn.objects.find(objectId) };
+
+        if (objectIt == conn.objects.end() || opcode >= objectIt->second.interface->method_count)
+        {
+            m_stats.skipped++;
+            return;
+        }
+
+        const Connection::Object object { objectIt->second };
+        const wl_message &message { object.interface->methods[opcode] };
+
+        if (MustSkip(interface, message))
+        {
+            m_stats.skipped++;
+            return;
+        }
+
+        std::vector<wl_argument> args;
+        std::deque<std::string> strings;
+        std::deque<wl_array> arrays;
+        std::vector<int> fds;
+        const wl_interface *newInterface { nullptr };
+        UInt32 newId { 0 };
+        UInt32 version { wl_proxy_get_version(object.proxy) };
+        bool nullable { false };
+        Int32 typeI { 0 };
+        bool skip { false };
+        const char *sig { message.signature };
+
+        const auto fail { [&]()
+        {
+            for (int fd : fds)
+                close(fd);
+
+            m_pendingPool.reset();
+            m_stats.skipped++;
+        }};
+
+        for (UInt8 i = 0; i < argc; i++)
+        {
+            char type;
+
+            if (!reader.get(&type))
+                return fail();
+
+            // Keep the message signature in sync to know the types and nullability
+            while (*sig && (*sig == '?' || (*sig >= '0' && *sig <= '9')))
+                nullable = (*sig++ == '?') || nullable;
+
+            wl_argument arg {};
+
+            switch (type)
+            {
+            case 'i':
+                reader.get(&arg.i);
+                break;
+            case 'f':
+                reader.get(&arg.f);
+                break;
+            case 'u':
+                reader.get(&arg.u);
+                break;
+            case 'o':
+            {
+                UInt32 id;
+                reader.get(&id);
+                auto it { conn.objects.find(id) };
+
+                if (it != conn.objects.end())
+                    arg.o = reinterpret_cast<wl_object*>(it->second.proxy);
+                else if (id != 0 || !nullable)
+                    skip = true;
+                break;
+            }
+            case 'n':
+            {
+                reader.get(&newId);
+                newInterface = message.types ? message.types[typeI] : nullptr;
+                break;
+            }
+            case 's':
+            {
+                std::string storage;
+                const char *str;
+
+                if (!reader.string(&storage, &str))
+                    return fail();
+
+                if (str)
+                    arg.s = strings.emplace_back(std::move(storage)).c_str();
+                break;
+            }
+            case 'a':
+            {
+                UInt32 size;
+                reader.get(&size);
+                auto &array { arrays.emplace_back() };
+                array.size = array.alloc = size;
+                array.data = const_cast<UInt8*>(reader.bytes(size));
+                arg.a = &array;
+                break;
+            }
+            case 'h':
+            {
+                // Only SHM pools can be recreated
+                if (strcmp(interface, "wl_shm") != 0 || opcode != 0)
+                {
+                    skip = true;
+                    break;
+                }
+
+                auto pool { std::make_shared<Pool>() };
+                fds.emplace_back(dup(pool->fd));
+                arg.h = fds.back();
+                m_pendingPool = pool;
+                break;
+            }
+            default:
+                return fail();
+            }
+
+            args.emplace_back(arg);
+            nullable = false;
+            typeI++;
+
+            if (*sig)
+                sig++;
+        }
+
+        if (skip)
+            return fail();
+
+        // wl_registry.bind(name, interface, version, id), remap the global name
+        if (strcmp(interface, "wl_registry") == 0 && opcode == 0 && args.size() == 4 && args[1].s)
+        {
+            newInterface = findInterface(args[1].s);
+            const auto *global { findGlobal(conn, args[0].u, args[1].s) };
+
+            if (!newInterface || !global)
+            {
+                LLog(CZWarning, CZLN, "Global {} not available, skipping bind", args[1].s);
+                return fail();
+            }
+
+            args[0].u = global->name;
+            args[2].u = std::min(args[2].u, global->version);
+            version = args[2].u;
+        }
+
+        // Pools must be large enough before the compositor maps them
+        if (m_pendingPool)
+            m_pendingPool->resize(args[2].i);
+        else if (strcmp(interface, "wl_shm_pool") == 0 && strcmp(message.name, "resize") == 0)
+        {
+            auto pool { conn.pools.find(objectId) };
+
+            if (pool != conn.pools.end())
+                pool->second->resize(args[0].i);
+        }
+
+        const bool destructor { IsDestructor(message) };
+        wl_proxy *proxy { wl_proxy_marshal_array_flags(object.proxy, opcode, newInterface, version,
+            destructor ? WL_MARSHAL_FLAG_DESTROY : 0, args.data()) };
+
+        for (int fd : fds)
+            close(fd);
+
+        m_stats.replayed++;
+
+        if (destructor)
+        {
+            conn.objects.erase(objectId);
+            conn.pools.erase(objectId);
+            conn.buffers.erase(objectId);
+        }
+
+        if (proxy && newId != 0)
+        {
+            conn.objects[newId] = { proxy, newInterface };
+
+            if (strcmp(newInterface->name, "wl_shm_pool") == 0 && m_pendingPool)
+                conn.pools[newId] = std::move(m_pendingPool);
+            else if (strcmp(newInterface->name, "wl_buffer") == 0 && strcmp(interface, "wl_shm_pool") == 0)
+            {
+                auto pool { conn.pools.find(objectId) };
+
+                if (pool != conn.pools.end())
+                    conn.buffers[newId] = { pool->second, args[1].i };
+            }
+            else if (strcmp(newInterface->name, "wl_shm") == 0)
+                conn.shm = proxy;
+        }
+        else if (strcmp(interface, "wl_surface") == 0 && strcmp(message.name, "commit") == 0)
+        {
+            m_stats.commits++;
+
+            if (m_fast)
+                wl_display_roundtrip(conn.display);
+        }
+
+        m_pendingPool.reset();
+    }
+
+    void handleShmContents(Connection &conn, const Record &record) noexcept
+    {
+        Reader reader { record.data, record.size };
+        UInt32 bufferId, size;
+
+        if (!reader.get(&bufferId) || !reader.get(&size))
+            return;
+
+        const UInt8 *data { reader.bytes(size) };
+        auto it { conn.buffers.find(bufferId) };
+
+        if (!data || it == conn.buffers.end() || !it->second.pool->map)
+            return;
+
+        const size_t offset ( it->second.offset );
+
+        if (offset < it->second.pool->size)
+            memcpy(it->second.pool->map + offset, data, std::min<size_t>(size, it->second.pool->size - offset));
+    }
+
+    // DMA buffers are replaced by SHM buffers with the same contents
+    void handleDMAContents(Connection &conn, const Record &record) noexcept
+    {
+        Reader reader { record.data, record.size };
+        UInt32 bufferId;
+        Int32 width, height;
+
+        if (!reader.get(&bufferId) || !reader.get(&width) || !reader.get(&height) || width <= 0 || height <= 0)
+            return;
+
+        const size_t size { size_t(width) * size_t(height) * 4 };
+        const UInt8 *data { reader.bytes(size) };
+
+        if (!data)
+            return;
+
+        if (!conn.shm)
+        {
+            // Make sure the own registry exists without reserving the global for later binds
+            findGlobal(conn, 0, "");
+
+            auto global { std::find_if(conn.globals.begin(), conn.globals.end(), [](const auto &g) { return g.interface == "wl_shm"; }) };
+
+            if (global == conn.globals.end())
+                return;
+
+            conn.shm = wl_proxy_marshal_flags(conn.registry, 0, findInterface("wl_shm"), 1, 0,
+                global->name, "wl_shm", 1, nullptr);
+        }
+
+        auto pool { std::make_shared<Pool>() };
+
+        if (!pool->resize(size))
+            return;
+
+        memcpy(pool->map, data, size);
+
+        const auto *shmInterface { findInterface("wl_shm") };
+        const auto *poolInterface { shmInterface->methods[0].types[0] };
+        const auto *bufferInterface { poolInterface->methods[0].types[0] };
+
+        wl_proxy *shmPool { wl_proxy_marshal_flags(conn.shm, 0, poolInterface, 1, 0, nullptr, pool->fd, Int32(size)) };
+        wl_proxy *buffer { wl_proxy_marshal_flags(shmPool, 0, bufferInterface, 1, 0, nullptr, 0, width, height, width * 4, 0 /* ARGB8888 */) };
+        wl_proxy_marshal_flags(shmPool, 1, nullptr, 1, WL_MARSHAL_FLAG_DESTROY);
+
+        conn.objects[bufferId] = { buffer, bufferInterface };
+        conn.buffers[bufferId] = { pool, 0 };
+    }
+
+    const std::vector<Record> &m_records;
+    std::string m_socket;
+    bool m_fast;
+    std::unordered_map<std::string, const wl_interface*> m_interfaces;
+    std::unordered_map<UInt32, std::unique_ptr<Connection>> m_connections;
+    std::shared_ptr<Pool> m_pendingPool;
+    Stats m_stats;
+};
+
+/******************** MAIN ********************/
+
+static void PrintReport(const Stats &stats, UInt64 wallNs, UInt64 cpuNs) noexcept
+{
+    printf("Requests replayed:       %lu\n", stats.replayed);
+    printf("Requests skipped:        %lu\n", stats.skipped);
+    printf("Commits:                 %lu\n", stats.commits);
+    printf("Wall time:               %.3f ms\n", wallNs / 1000000.0);
+    printf("Main loop CPU time:      %.3f ms\n", cpuNs / 1000000.0);
+    printf("Main loop allocations:   %lu (%lu bytes)\n", s_allocCount, s_allocBytes);
+
+    if (s_latencies.empty())
+    {
+        printf("Commit to present:       no presented commits\n");
+        return;
+    }
+
+    std::sort(s_latencies.begin(), s_latencies.end());
+    UInt64 sum { 0 };
+
+    for (UInt64 latency : s_latencies)
+        sum += latency;
+
+    const auto percentile { [](double p) { return s_latencies[std::min(s_latencies.size() - 1, size_t(p * s_latencies.size()))] / 1000000.0; } };
+
+    printf("Commit to present (ms):  min %.3f  avg %.3f  p50 %.3f  p99 %.3f  max %.3f  (%lu samples)\n",
+        s_latencies.front() / 1000000.0,
+        (sum / s_latencies.size()) / 1000000.0,
+        percentile(0.5),
+        percentile(0.99),
+        s_latencies.back() / 1000000.0,
+        s_latencies.size());
+}
+
+static UInt64 ThreadCpuNs() noexcept
+{
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return (UInt64(usage.ru_utime.tv_sec) + UInt64(usage.ru_stime.tv_sec)) * 1000000000ULL +
+           (UInt64(usage.ru_utime.tv_usec) + UInt64(usage.ru_stime.tv_usec)) * 1000ULL;
+}
+
+int main(int argc, char *argv[])
+{
+    bool fast { false };
+    const char *path { nullptr };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--fast") == 0)
+            fast = true;
+        else
+            path = argv[i];
+    }
+
+    if (!path)
+    {
+        fprintf(stderr, "Usage: %s [--fast] <recording>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<UInt8> file;
+    std::vector<Record> records;
+
+    if (!LoadRecords(path, file, records))
+        return 1;
+
+    // Never record the replay and use a private socket
+    unsetenv("CZ_LOUVRE_RECORD");
+    const std::string socket { "cz-louvre-replay-" + std::to_string(getpid()) };
+    setenv("CZ_LOUVRE_WAYLAND_DISPLAY", socket.c_str(), 1);
+
+    ReplayCompositor compositor;
+    compositor.setBackend(std::make_shared<LOffscreenBackend>());
+
+    if (!compositor.start())
+    {
+        LLog(CZFatal, CZLN, "Failed to start compositor");
+        return 1;
+    }
+
+    std::atomic<bool> finished { false };
+    Stats stats;
+    Replayer replayer { records, socket, fast, LProtocolRecorder::Interfaces() };
+
+    const UInt64 start { NowNs() };
+    UInt64 cpuNs { 0 };
+
+    std::thread thread { [&]
+    {
+        replayer.run();
+        stats = replayer.stats();
+        finished = true;
+    }};
+
+    // Let pending frames be presented after the last request
+    UInt64 finishedNs { 0 };
+
+    while (compositor.state() != LCompositor::Uninitialized)
+    {
+        const UInt64 cpuStart { ThreadCpuNs() };
+        t_countAllocs = true;
+        compositor.dispatch(16);
+        t_countAllocs = false;
+        cpuNs += ThreadCpuNs() - cpuStart;
+
+        if (finished && compositor.state() == LCompositor::Initialized)
+        {
+            if (finishedNs == 0)
+                finishedNs = NowNs();
+            else if (NowNs() - finishedNs > 200000000)
+                compositor.finish();
+        }
+    }
+
+    thread.join();
+    PrintReport(stats, (finishedNs ? finishedNs : NowNs()) - start, cpuNs);
+    return 0;
+}